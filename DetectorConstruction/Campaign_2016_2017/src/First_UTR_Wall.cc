@@ -36,8 +36,10 @@ First_UTR_Wall::First_UTR_Wall(G4LogicalVolume *World_Log) : World_Logical(World
 
 void First_UTR_Wall::Construct(G4ThreeVector global_coordinates) {
 
-  NormBrick *nb = new NormBrick(World_Logical);
-  NormBrickWithHole *nbh = new NormBrickWithHole(World_Logical);
+  BrickWall wall(World_Logical, "First_UTR_Wall");
+
+  NormBrick *nb = new NormBrick(World_Logical, &wall);
+  NormBrickWithHole *nbh = new NormBrickWithHole(World_Logical, &wall);
 
   for (int ny = -2; ny <= 2; ny++) {
     for (int nx = -1; nx <= 1; nx++) {
@@ -57,4 +59,6 @@ void First_UTR_Wall::Construct(G4ThreeVector global_coordinates) {
       }
     }
   }
+
+  wall.Construct();
 }
@@ -42,11 +42,13 @@ void G3_Wall::Construct(G4ThreeVector global_coordinates) {
 
   G4double BeamTube_Outer_Radius = 1. * inch;
 
-  NormBrick *nb = new NormBrick(World_Logical);
-  FlatFlatThinNormBrick *fftb = new FlatFlatThinNormBrick(World_Logical);
-  ConcreteBrick *cb = new ConcreteBrick(World_Logical);
-  FlatConcreteBrick *fcb = new FlatConcreteBrick(World_Logical);
-  HalfShortBrickWithHole *hsbh = new HalfShortBrickWithHole(World_Logical);
+  BrickWall wall(World_Logical, "G3_Wall");
+
+  NormBrick *nb = new NormBrick(World_Logical, &wall);
+  FlatFlatThinNormBrick *fftb = new FlatFlatThinNormBrick(World_Logical, &wall);
+  ConcreteBrick *cb = new ConcreteBrick(World_Logical, &wall);
+  FlatConcreteBrick *fcb = new FlatConcreteBrick(World_Logical, &wall);
+  HalfShortBrickWithHole *hsbh = new HalfShortBrickWithHole(World_Logical, &wall);
 
   for (int i = 0; i < 3; i++) {
     nb->Put(global_coordinates.x() - nb->L / 2., global_coordinates.y() - BeamTube_Outer_Radius + nb->S * 3.5,
@@ -134,6 +136,8 @@ void G3_Wall::Construct(G4ThreeVector global_coordinates) {
   cb->Put(global_coordinates.x() + fcb->S * 0.5 + cb->M * 0.5, global_coordinates.y() - BeamTube_Outer_Radius - nb->S * 3. - cb->M - AlPlate_Y - cb->M * 0.5,
           global_coordinates.z() - nb->M * 3. + cb->L * 0.5);
 
+  wall.Construct();
+
   // Lead wraps around the beam pipe
 
   G4double lead_wrap_thickness = 1.8 * mm; // Measured
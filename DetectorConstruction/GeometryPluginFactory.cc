@@ -0,0 +1,49 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Factory functions of a DetectorConstruction, which are compiled together with every setup.
+// They are accessed by the GeometryPlugin class, either directly if the setup is compiled into utr,
+// or via dlsym() if the setup is compiled into a geometry plugin (GEOMETRY_PLUGINS build option).
+
+#include "DetectorConstruction.hh"
+#include "utrConfig.h"
+
+extern "C" {
+
+G4VUserDetectorConstruction *utr_create_detector_construction() {
+  return new DetectorConstruction();
+}
+
+// UTR_GEOMETRY_NAME is defined by CMake as "<CAMPAIGN>/<DETECTOR_CONSTRUCTION>"
+const char *utr_geometry_name() {
+  return UTR_GEOMETRY_NAME;
+}
+
+// UTR_GEOMETRY_BUILD_OPTIONS is defined by CMake as the build options which change the geometry, including those of the setup
+const char *utr_geometry_build_options() {
+  return UTR_GEOMETRY_BUILD_OPTIONS;
+}
+
+#if defined EVENT_EVENTWISE || defined RESPONSE_MATRIX
+unsigned int utr_max_sensitive_detector_id(const G4VUserDetectorConstruction *detector_construction) {
+  return ((const DetectorConstruction *)detector_construction)->Max_Sensitive_Detector_ID;
+}
+#endif
+}
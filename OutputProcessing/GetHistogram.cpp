@@ -61,6 +61,7 @@ static struct argp_option options[] = {
     {"maxid", 'n', "MAXID", 0, "Highest detection volume ID (default: 12). 'getHistogram' only processes energy depositions in detectors with integer volume ID numbers from 0 to MAXID (MAXID is included)."},
     {"multiplicity", 'm', "MULTIPLICITY", 0, "Particle multiplicity, sum energy depositions for each detector among MULTIPLICITY events (default: 1)"},
     {"addback", 'a', 0, 0, "Add back energy depositions that occurred in a single event to the detector first listed in the event (usually this is the first one hit) (default: Off)"},
+    {"unweighted", 'u', 0, 0, "Ignore the 'weight' branch of biased simulations, i.e. fill each entry with a weight of 1 (default: Off, entries are weighted if the tree contains a 'weight' branch)"},
     {"silent", 's', 0, 0, "Silent mode (does not silence -B option) (default: Off"},
     {0, 0, 0, 0, 0}};
 
@@ -81,6 +82,7 @@ struct arguments {
   unsigned int nhistograms = 12 + 1; // Default value for MAXID of 12 and +1 (histograms 0 to 12)
   unsigned int multiplicity = 1;
   bool addback = false;
+  bool unweighted = false;
   bool verbose = true;
 };
 
@@ -129,6 +131,9 @@ static error_t parse_opt(int key, char *arg, struct argp_state *state) {
     case 'a':
       arguments->addback = true;
       break;
+    case 'u':
+      arguments->unweighted = true;
+      break;
     case 's':
       arguments->verbose = false;
       break;
@@ -189,6 +194,12 @@ int main(int argc, char *argv[]) {
     } else {
       cout << "FALSE" << endl;
     }
+    cout << "> UNWEIGHTED   : ";
+    if (arguments.unweighted) {
+      cout << "TRUE" << endl;
+    } else {
+      cout << "FALSE" << endl;
+    }
     cout << "#############################################" << endl;
   }
 
@@ -254,18 +265,40 @@ int main(int argc, char *argv[]) {
 
   vector<unsigned int> multiplicity_counter(arguments.nhistograms, 0);
 
+  // Simulations with variance-reduction techniques (see the README of utr) contain a 'weight' branch, and each entry has to be weighted accordingly.
+  // If several entries are summed up by the addback or multiplicity options, the sum is weighted by the mean of their weights, weighted by the energy depositions.
+  const bool weighted = !arguments.unweighted && fileChain.GetBranch("weight");
+  if (weighted) {
+    for (auto h : hist) {
+      h->Sumw2();
+    }
+    if (arguments.verbose) {
+      cout << "> Found 'weight' branch, histograms are filled with weighted entries" << endl;
+    }
+  }
+
   // Fill histogram from TBranch in TChain with user-defined conditions
   // Define variables and automatically update their values from the ROOT tree using the GetEntry method after registering them with the SetBranchAddress method
   double Event, lastEvent;
+  double Copy = 0., lastCopy; // Biased simulations write the copies of an event one after another, which must not be added back
   double Volume; // Needs to be double to correctly work with GetEntry and SetBranchAddress methods
   unsigned int lastVolume; // Needs to be unsigned int to correctly work with array indices
   double Edep;
+  double Weight = 1.;
   vector<double> EdepBuffer(arguments.nhistograms, 0.);
+  vector<double> WeightedEdepBuffer(arguments.nhistograms, 0.);
+  vector<double> WeightBuffer(arguments.nhistograms, 1.); // Weight of the last buffered entry, used if the buffered energy is zero
 
   fileChain.SetBranchAddress(arguments.quantity.c_str(), &Edep);
   fileChain.SetBranchAddress("volume", &Volume);
+  if (weighted) {
+    fileChain.SetBranchAddress("weight", &Weight);
+  }
   if (arguments.addback) {
     fileChain.SetBranchAddress("event", &Event);
+    if (fileChain.GetBranch("copy")) {
+      fileChain.SetBranchAddress("copy", &Copy);
+    }
   } else {
     Event = -1; // If addback is disabled, Event will not be relevant in the code below, and the ROOT tree is not required to contain it
   }
@@ -295,33 +328,41 @@ int main(int argc, char *argv[]) {
     entry++;
   }
   lastEvent = Event;
+  lastCopy = Copy;
   lastVolume = (unsigned int)Volume;
   EdepBuffer[lastVolume] = Edep;
+  WeightedEdepBuffer[lastVolume] = Weight * Edep;
+  WeightBuffer[lastVolume] = Weight;
 
   // Process next events in loops
   while (entry < fileChain.GetEntries()) {
     // Get the entry, this sets the values for the Edep, Volume and Event variables
     fileChain.GetEntry(entry);
     if ((unsigned int)Volume < arguments.nhistograms) { // nhistograms=MAXID+1 so must always be greater than Volume to consider that Volume
-      // If addback is disabled or the event number has changed:
-      if (!arguments.addback || lastEvent != Event) {
+      // If addback is disabled or the event number (or the copy of the event) has changed:
+      if (!arguments.addback || lastEvent != Event || lastCopy != Copy) {
         // First process the *last* event still in the buffer:
         // Increase the volumes multiplicity counter
         multiplicity_counter[lastVolume]++;
         // If multiplicity counter is high enough write the buffered energy value to the histogram
         if (multiplicity_counter[lastVolume] == arguments.multiplicity) {
-          hist[lastVolume]->Fill(EdepBuffer[lastVolume]); // Fill own histogram
-          hist[arguments.nhistograms]->Fill(EdepBuffer[lastVolume]); // Fill sum histogram
+          const double bufferWeight = EdepBuffer[lastVolume] > 0. ? WeightedEdepBuffer[lastVolume] / EdepBuffer[lastVolume] : WeightBuffer[lastVolume];
+          hist[lastVolume]->Fill(EdepBuffer[lastVolume], bufferWeight); // Fill own histogram
+          hist[arguments.nhistograms]->Fill(EdepBuffer[lastVolume], bufferWeight); // Fill sum histogram
           EdepBuffer[lastVolume] = 0.; // Reset energy buffer to zero
+          WeightedEdepBuffer[lastVolume] = 0.;
           multiplicity_counter[lastVolume] = 0; // Reset multiplicity counter to zero
         }
         // Now update history variables to *this* event and increase addback_counter
         addback_counter++;
         lastEvent = Event;
+        lastCopy = Copy;
         lastVolume = (unsigned int)Volume;
       }
       // Add Edep value to buffer (necessary for addback and multiplicity), note that the *last* Volume can now already be *this* event's volume
       EdepBuffer[lastVolume] += Edep;
+      WeightedEdepBuffer[lastVolume] += Weight * Edep;
+      WeightBuffer[lastVolume] = Weight;
     } else if (arguments.verbose && warningCounter < 10) {
       cout << "Warning: Entry with volume = " << (unsigned int)Volume << " > MAXID = " << arguments.nhistograms - 1 << " encountered. Skipping this entry." << endl;
       warningCounter++;
@@ -335,8 +376,9 @@ int main(int argc, char *argv[]) {
   // (Post)Process last event manually
   multiplicity_counter[lastVolume]++;
   if (multiplicity_counter[lastVolume] == arguments.multiplicity) {
-    hist[lastVolume]->Fill(EdepBuffer[lastVolume]); // Fill own histogram
-    hist[arguments.nhistograms]->Fill(EdepBuffer[lastVolume]); // Fill sum histogram
+    const double bufferWeight = EdepBuffer[lastVolume] > 0. ? WeightedEdepBuffer[lastVolume] / EdepBuffer[lastVolume] : WeightBuffer[lastVolume];
+    hist[lastVolume]->Fill(EdepBuffer[lastVolume], bufferWeight); // Fill own histogram
+    hist[arguments.nhistograms]->Fill(EdepBuffer[lastVolume], bufferWeight); // Fill sum histogram
   }
   addback_counter++;
 
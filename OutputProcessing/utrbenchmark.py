@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+
+import argparse
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+programName=os.path.basename(sys.argv[0])
+
+argparser = argparse.ArgumentParser(description="""
+Measure the event rate of utr for different numbers of threads
+
+Runs utr with the given macro file once for each number of threads and reads
+the average event rate of the last run from the final progress report of utr
+(which requires a nonzero /utr/progress/interval). The macro should start with
+a short warm-up run, in which the worker threads build their physics tables,
+followed by the measured run (see macros/examples/benchmark.mac).
+Prints the event rate, the rate per thread, the speedup and the parallel
+efficiency for each number of threads, and the largest number of threads
+whose parallel efficiency is still above the given threshold, i.e. the knee of
+the scaling curve.
+""", formatter_class=argparse.RawTextHelpFormatter)
+argparser.add_argument('macFile', metavar='MACROFILE', help='the macro file to run')
+argparser.add_argument('-t', '--threads', default=None, help="""\
+comma-separated numbers of threads (default: powers of two
+up to the CPU count, and the CPU count)
+""")
+argparser.add_argument('-u', '--utr', default=os.path.join(os.path.dirname(os.path.realpath(__file__)), "..", "build", "utr"), help="path of the utr executable (default: ../build/utr)")
+argparser.add_argument('-p', '--pin', default="none", choices=["none", "core", "node"], help="pinning of the worker threads, passed to utr (default: none)")
+argparser.add_argument('-r', '--runmanager', default="mt", choices=["mt", "tasking"], help="run manager, passed to utr (default: mt)")
+argparser.add_argument('-e', '--efficiency', type=float, default=0.8, help="minimum parallel efficiency for the knee (default: 0.8)")
+argparser.add_argument('-k', '--keepoutput', action='store_true', help="keep the output files of utr in the current directory")
+args=argparser.parse_args()
+
+if args.threads :
+    threadCounts=[int(t) for t in args.threads.split(",")]
+else :
+    threadCounts=[]
+    t=1
+    while t < os.cpu_count() :
+        threadCounts.append(t)
+        t*=2
+    threadCounts.append(os.cpu_count())
+
+# The last final progress report of utr, e.g. 'Finished: [  1000000/1000000]  100.00 %  Rate:   41250 /s  Running time: ...'
+finishedPattern=re.compile(r"Finished: \[\s*\d+/\d+\].*Rate:\s*(\d+) /s")
+
+results=[]
+for threads in threadCounts :
+    outputDir="." if args.keepoutput else tempfile.mkdtemp(prefix="utrbenchmark")
+    print(programName + ">", "Running utr with", threads, "threads...", flush=True)
+    proc=subprocess.run([
+        args.utr,
+        "--nthreads=" + str(threads),
+        "--runmanager=" + args.runmanager,
+        "--pin=" + args.pin,
+        "--outputdir=" + outputDir,
+        "--macrofile=" + args.macFile
+        ], stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    if not args.keepoutput :
+        shutil.rmtree(outputDir)
+    rates=finishedPattern.findall(proc.stdout)
+    if proc.returncode != 0 or not rates :
+        print(proc.stdout[-2000:])
+        exit("ERROR: utr with " + str(threads) + " threads failed or did not report its event rate! Aborting...")
+    results.append((threads, float(rates[-1])))
+
+# The speedup and the efficiency are relative to the rate per thread of the smallest number of threads
+(referenceThreads, referenceRate)=results[0]
+print()
+print(f"{'threads':>8} {'events/s':>12} {'events/s/thread':>16} {'speedup':>8} {'efficiency':>11}")
+knee=referenceThreads
+for (threads, rate) in results :
+    speedup=rate / referenceRate * referenceThreads
+    efficiency=speedup / threads
+    if efficiency >= args.efficiency :
+        knee=max(knee, threads)
+    print(f"{threads:>8} {rate:>12.0f} {rate/threads:>16.1f} {speedup:>8.2f} {efficiency:>11.2f}")
+print()
+print("Highest event rate:", max(results, key=lambda result: result[1])[0], "threads")
+print("Knee of the scaling curve (parallel efficiency >= " + str(args.efficiency) + "):", knee, "threads")
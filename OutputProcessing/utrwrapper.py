@@ -7,6 +7,9 @@ import subprocess
 import configparser
 import glob
 import datetime
+import shlex
+import threading
+import concurrent.futures
 
 startTime=datetime.datetime.now()
 programName=os.path.basename(sys.argv[0])
@@ -36,6 +39,11 @@ listing all available options with their effect and default values
 #niceness=18                          # Niceness to run utr with (Default: 18)
 #threads=20                           # Number of threads to run utr and make
 #                                     # with (Default: System's CPU count)
+#jobs=1                               # Number of utr processes to run
+#                                     # concurrently, sharing the threads, by
+#                                     # splitting a /control/loop or
+#                                     # /control/foreach in the macro into one
+#                                     # job per iteration (Default: 1)
 #utrPath=/path/to/utr                 # Path of utr's code (Default: Parent
 #                                     # directory of """+ programName +"""'s directory)
 #checkForExistingOutput=True          # Whether to check for already existing
@@ -167,6 +175,7 @@ if config["generalConfig"].getboolean("ensureTerminalMultiplexer", False) and 'T
 logging=config["generalConfig"].getboolean("logging", True)
 niceness=config["generalConfig"].get("niceness", 18)
 threads=config["generalConfig"].get("threads", os.cpu_count())
+jobs=config["generalConfig"].getint("jobs", 1)
 utrPath=os.path.realpath(os.path.join(
             os.path.dirname(__file__),
             ".."))
@@ -217,12 +226,17 @@ os.makedirs(outputDirRaw, exist_ok=True)
 os.makedirs(outputDirHists, exist_ok=True)
 
 # Check if output directory already contains files matching the supplied filename structure
-if checkForExistingOutput and not args.skipSimulation and glob.glob(
+if checkForExistingOutput and not args.skipSimulation and (glob.glob(
     glob.escape(os.path.join(outputDirRaw, filenamePrefix))
     + "*"
     + glob.escape(filenameSuffix)
     + "*"
-) :
+) or jobs > 1 and glob.glob(
+    os.path.join(glob.escape(outputDirRaw), "*", glob.escape(filenamePrefix))
+    + "*"
+    + glob.escape(filenameSuffix)
+    + "*"
+)) :
     exit("ERROR: Output directory seems to contain files matching the supplied filename structure! Aborting...")
 
 
@@ -230,13 +244,15 @@ if checkForExistingOutput and not args.skipSimulation and glob.glob(
 if logging :
     logfilePath=os.path.join(outputDir, filenamePrefix + "X" + filenameSuffix + "_" + startTime.strftime("%Y-%m-%d_%H-%M-%S") + ".log")
 
-# Define combined print and log function
+# Define combined print and log function (the lock keeps the lines of concurrent jobs intact)
+loggingLock=threading.Lock()
 def loggingPrint(*args, tag=programName + ">", **kwargs):
-    print(tag, *args, **kwargs)
-    if logging :
-        with open(logfilePath, "a") as f:
-            kwargs["file"]=f
-            print(tag, *args, **kwargs)
+    with loggingLock :
+        print(tag, *args, **kwargs)
+        if logging :
+            with open(logfilePath, "a") as f:
+                kwargs["file"]=f
+                print(tag, *args, **kwargs)
 
 # Define function to print and log errors and quit
 def error(*args, **kwargs) :
@@ -277,20 +293,25 @@ if logging :
 
 
 # Define function to run processes, respecting logging and checking exit status
-def runProcess(prog, procArgs, announce=True, **kwargs) :
+# If fatal is False, a failure is only reported and False is returned, so that concurrent jobs can continue
+def runProcess(prog, procArgs, announce=True, fatal=True, **kwargs) :
     if announce :
         currentTime=datetime.datetime.now()
         elapsedSeconds=int((currentTime-startTime).total_seconds())
         loggingPrint("Running", prog, " at", currentTime.strftime("%Y-%m-%d %H-%M-%S"), f"(current runtime: {elapsedSeconds//(60*60)}h {(elapsedSeconds//60)%60:02}m {elapsedSeconds%60:02}s)")
     if not logging :
-        if (subprocess.run(procArgs, **kwargs).returncode != 0) :
-            error(prog, "failed!")
+        returncode=subprocess.run(procArgs, **kwargs).returncode
     else :
         with subprocess.Popen(procArgs, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True, **kwargs) as proc :
             for line in proc.stdout:
                 loggingPrint(line, tag=prog+">", end="")
-            if (proc.wait() != 0) :
-                error(prog, "failed!")
+            returncode=proc.wait()
+    if returncode != 0 :
+        if fatal :
+            error(prog, "failed!")
+        loggingPrint(prog, "failed!", tag="ERROR:", file=sys.stderr)
+        return False
+    return True
 
 
 # Compile the programs
@@ -321,44 +342,124 @@ if processOutput :
     runProcess("cmake on OutputProcessing scripts", ["cmake", "-S", "OutputProcessing", "-B", "build/OutputProcessing"], cwd=utrPath)
     runProcess("buildsystem on OutputProcessing scripts", ["cmake", "--build", "build/OutputProcessing", "-j", str(threads)], cwd=utrPath)
 
-# Run utr (if not skipped)
-if not args.skipSimulation :
-    runProcess("utr", [
-        "nice", "-n" + str(niceness),
-        os.path.join(utrPath, "build", "utr"),
-        "--nthreads=" + str(threads),
-        "--outputdir=" + outputDirRaw + "",
-        "--macrofile=" + macFile + ""
-        ],
-        env=environmentVariables
-    )
-
-# Process the output if requested
-if processOutput :
-    currentTime=datetime.datetime.now()
-    elapsedSeconds=int((currentTime-startTime).total_seconds())
-    loggingPrint("Processing output at", currentTime.strftime("%Y-%m-%d %H-%M-%S"), f"(current runtime: {elapsedSeconds//(60*60)}h {(elapsedSeconds//60)%60:02}m {elapsedSeconds%60:02}s)")
+# Define function to process all simulation output files in a directory with getHistogram and histogramToTxt
+def processOutputDir(rawDir, fatal=True) :
     # Get a list of all simulation output basenames (without _t{THREADID}.root) by the known composition of the output filenames and the always present _t0 file
     outputFiles=glob.glob(
-        glob.escape(os.path.join(outputDirRaw, filenamePrefix))
+        glob.escape(os.path.join(rawDir, filenamePrefix))
         + "*"
         + glob.escape(filenameSuffix + "_t0.root")
     )
-    loggingPrint("Found", len(outputFiles), "output files to process")
+    loggingPrint("Found", len(outputFiles), "output files to process in '" + rawDir + "'")
+    success=True
     for rootFilename in outputFiles :
         loggingPrint("Processing output file '" + rootFilename.rpartition("_t")[0] + "'...")
         # Strip _t0.root and directory name from string
         rootFilename=os.path.basename(rootFilename).rpartition("_t")[0]
-        runProcess(getHistogramExe, [
+        success=runProcess(getHistogramExe, [
             os.path.join(utrPath, "build", "OutputProcessing", getHistogramExe),
             "--pattern1=" + rootFilename + "_t",
-            "--inputdir=" + outputDirRaw,
+            "--inputdir=" + rawDir,
             "--outputdir=" + outputDirHists
-            ] + getHistogramArgs, announce=False)
-        runProcess("histogramToTxt", [
+            ] + getHistogramArgs, announce=False, fatal=fatal) and runProcess("histogramToTxt", [
             os.path.join(utrPath, "build", "OutputProcessing", "histogramToTxt"),
             os.path.join(outputDirHists, rootFilename) + "_hist.root"
-            ] + histogramToTxtArgs, announce=False)
+            ] + histogramToTxtArgs, announce=False, fatal=fatal) and success
+    return success
+
+# Define function to split the macro into one job per iteration of its /control/loop or /control/foreach command
+# Each job is a copy of the macro, in which the loop is replaced by a single execution of the looped macro with the loop variable set by /control/alias
+def expandLoop() :
+    with open(macFile) as openMacFile :
+        macroLines=openMacFile.readlines()
+    loopLines=[i for (i, line) in enumerate(macroLines) if line.split()[:1] in (["/control/loop"], ["/control/foreach"])]
+    if len(loopLines) != 1 :
+        error("To run concurrent jobs (jobs=" + str(jobs) + "), the extended macro file must contain exactly one /control/loop or /control/foreach command, but", len(loopLines), "were found!")
+    loopLine=macroLines[loopLines[0]]
+    if "{" in loopLine :
+        error("The loop command '" + loopLine.strip() + "' must not contain aliases to be split into concurrent jobs!")
+    splitLine=shlex.split(loopLine)
+    if splitLine[0] == "/control/loop" :
+        if len(splitLine) < 5 :
+            error("The loop command '" + loopLine.strip() + "' must have at least four arguments: macro file, counter name, initial value and final value!")
+        # Reproduce the values of G4UImanager::Loop, which formats them with the default precision of a C++ stream. The step size is optional and 1 by default.
+        (loopMacro, loopVariable, initialValue, finalValue)=(splitLine[1], splitLine[2], float(splitLine[3]), float(splitLine[4]))
+        stepSize=float(splitLine[5]) if len(splitLine) > 5 else 1.
+        values=[]
+        value=initialValue
+        while (stepSize > 0 and value <= finalValue) or (stepSize < 0 and value >= finalValue) :
+            values.append(f"{value:g}")
+            value+=stepSize
+    else :
+        (loopMacro, loopVariable, values)=(splitLine[1], splitLine[2], " ".join(splitLine[3:]).split())
+    jobList=[]
+    for value in values :
+        jobName=loopVariable + "_" + value
+        jobDir=os.path.join(outputDirRaw, jobName)
+        jobLines=macroLines[:loopLines[0]] + ["/control/alias " + loopVariable + " " + value + "\n", "/control/execute " + loopMacro + "\n"] + macroLines[loopLines[0]+1:]
+        jobList.append((jobName, jobDir, jobLines))
+    return jobList
+
+# Define function to run a single job, returns whether it succeeded
+def runJob(jobName, jobDir, jobLines, jobThreads) :
+    os.makedirs(jobDir, exist_ok=True)
+    jobMacFile=os.path.join(jobDir, jobName + ".mac")
+    with open(jobMacFile, "w") as openJobMacFile :
+        openJobMacFile.writelines(jobLines)
+    return runProcess("utr[" + jobName + "]", [
+        "nice", "-n" + str(niceness),
+        os.path.join(utrPath, "build", "utr"),
+        "--nthreads=" + str(jobThreads),
+        "--outputdir=" + jobDir + "",
+        "--macrofile=" + jobMacFile + ""
+        ],
+        fatal=False,
+        env=environmentVariables
+    )
+
+# Run utr (if not skipped)
+if not args.skipSimulation and jobs <= 1 :
+    runProcess("utr", [
+        "nice", "-n" + str(niceness),
+        os.path.join(utrPath, "build", "utr"),
+        "--nthreads=" + str(threads),
+        "--outputdir=" + outputDirRaw + "",
+        "--macrofile=" + macFile + ""
+        ],
+        env=environmentVariables
+    )
+elif not args.skipSimulation :
+    # Each iteration of the loop runs as a separate utr process with its own output directory, at most 'jobs' processes at the same time, which share the threads
+    # Compared to a single process which loops over all iterations, no thread is idle while a run waits for its slowest thread
+    jobList=expandLoop()
+    jobThreads=max(1, int(threads) // jobs)
+    loggingPrint("Running", len(jobList), "jobs,", min(jobs, len(jobList)), "at a time with", jobThreads, "threads each")
+    # The output of each finished job is processed in a separate thread while the following jobs are still simulating, one job after another
+    failedJobs=[]
+    with concurrent.futures.ThreadPoolExecutor(max_workers=1) as processingPool :
+        processingResults={}
+        with concurrent.futures.ThreadPoolExecutor(max_workers=jobs) as jobPool :
+            jobResults={jobPool.submit(runJob, jobName, jobDir, jobLines, jobThreads): (jobName, jobDir) for (jobName, jobDir, jobLines) in jobList}
+            for result in concurrent.futures.as_completed(jobResults) :
+                (jobName, jobDir)=jobResults[result]
+                if not result.result() :
+                    failedJobs.append(jobName)
+                elif processOutput :
+                    processingResults[processingPool.submit(processOutputDir, jobDir, False)]=jobName
+        failedJobs+=[jobName for (result, jobName) in processingResults.items() if not result.result()]
+    if failedJobs :
+        error(len(failedJobs), "of", len(jobList), "jobs failed:", ", ".join(failedJobs))
+
+# Process the output if requested (the output of concurrent jobs was already processed)
+if processOutput and (args.skipSimulation or jobs <= 1) :
+    currentTime=datetime.datetime.now()
+    elapsedSeconds=int((currentTime-startTime).total_seconds())
+    loggingPrint("Processing output at", currentTime.strftime("%Y-%m-%d %H-%M-%S"), f"(current runtime: {elapsedSeconds//(60*60)}h {(elapsedSeconds//60)%60:02}m {elapsedSeconds%60:02}s)")
+    processOutputDir(outputDirRaw)
+    # The output of concurrent jobs is in one subdirectory per job
+    if jobs > 1 :
+        for jobDir in sorted(glob.glob(os.path.join(glob.escape(outputDirRaw), "*", ""))) :
+            processOutputDir(jobDir)
 
 currentTime=datetime.datetime.now()
 elapsedSeconds=int((currentTime-startTime).total_seconds())
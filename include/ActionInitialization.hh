@@ -33,9 +33,4 @@ class ActionInitialization : public G4VUserActionInitialization {
 
   virtual void BuildForMaster() const;
   virtual void Build() const;
-
-  void setNThreads(const int nt) { n_threads = nt; };
-
-  private:
-  G4int n_threads;
 };
@@ -0,0 +1,64 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4VUserTrackInformation.hh"
+#include "globals.hh"
+
+// Variance-reduction techniques replace a particle by several copies with different statistical weights,
+// which are alternative histories of the same event. Energy depositions of different copies must not be
+// summed up, therefore each track carries the ID of the copy it belongs to. Copy 0 is the unbiased part
+// of the event, all other IDs are assigned in the order in which the copies are created and are only
+// unique within an event.
+class BiasedCopyInformation : public G4VUserTrackInformation {
+  public:
+  BiasedCopyInformation(G4int id) : G4VUserTrackInformation("BiasedCopyInformation"), copy_id(id){};
+
+  G4int Get_Copy_ID() const { return copy_id; };
+  void Set_Copy_ID(G4int id) { copy_id = id; };
+
+  private:
+  G4int copy_id;
+};
+
+class BiasedCopies {
+  public:
+  static G4int Get_Copy_ID(const G4Track *track);
+  // Start a new copy with the given track
+  static void New_Copy(G4Track *track);
+  // Put a secondary into the copy of its parent
+  static void Join_Copy(G4Track *secondary, const G4Track *parent);
+
+  // Called by the SteppingAction after each step. A track whose weight was changed in the step starts a new copy,
+  // so that all hits of a copy have the same weight. Secondaries which were not assigned to a copy by the biasing
+  // operation itself join the copy of their parent before the step if they have its weight, or its copy after the
+  // step if they are a different particle with its new weight (e.g. the electron of a forced Compton scattering).
+  // All others, e.g. the clones of a split particle, start new copies.
+  static void Update(const G4Step *step);
+  // Called by the EventAction at the end of each event
+  static void Reset() { n_copies = 0; };
+
+  private:
+  static void Set_Copy_ID(G4Track *track, G4int copy_id);
+
+  static G4ThreadLocal G4int n_copies;
+};
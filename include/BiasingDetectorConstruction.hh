@@ -0,0 +1,74 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "G4LogicalVolume.hh"
+#include "G4RotationMatrix.hh"
+#include "G4String.hh"
+#include "G4ThreeVector.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VUserDetectorConstruction.hh"
+
+using std::vector;
+
+// Wrapper around the DetectorConstruction of a setup, which attaches Geant4 biasing operators to
+// the logical volumes of the given physical volumes, typically thin targets:
+//   - Forced collisions (G4BOptrForceCollision, FORCED_COLLISION): Each particle of the biased
+//     species which enters the volume is split into a copy which is forced to interact inside the
+//     volume and a copy which crosses it without interaction. Their weights are the interaction and
+//     the survival probability, respectively.
+//   - Directional splitting (DirectionalSplittingOperator, DIRECTIONAL_SPLITTING): Photons which
+//     scatter inside the volume are split towards the sensitive detectors (see DirectionalSplitting.hh).
+// The biasing operators are thread-local, so they are created in ConstructSDandField().
+// A logical volume can only be biased by a single operator.
+class BiasingDetectorConstruction : public G4VUserDetectorConstruction {
+  public:
+  BiasingDetectorConstruction(G4VUserDetectorConstruction *detector_construction) : detector_construction(detector_construction), world(nullptr){};
+  ~BiasingDetectorConstruction();
+
+  G4VPhysicalVolume *Construct() override;
+  void ConstructSDandField() override;
+
+  // Must be called before /run/initialize
+  static void Add_Forced_Collision_Volume(const G4String &physical_volume_name) { forced_collision_volumes.push_back(physical_volume_name); };
+  static void Add_Splitting_Volume(const G4String &physical_volume_name) { splitting_volumes.push_back(physical_volume_name); };
+  static void Set_Splitting_Factor(G4int factor) { splitting_factor = factor; };
+
+  private:
+  struct Placement {
+    G4VPhysicalVolume *physical_volume;
+    G4ThreeVector position; // Global position of the origin of the volume
+  };
+  // Collect the global positions of all physical volumes in the geometry tree below volume
+  static void Collect_Placements(G4VPhysicalVolume *volume, const G4ThreeVector &position, const G4RotationMatrix &rotation, vector<Placement> &placements);
+  static G4LogicalVolume *Find_Logical_Volume(const G4String &physical_volume_name);
+  void Attach_Forced_Collision_Operators(vector<G4LogicalVolume *> &biased_volumes);
+  void Attach_Splitting_Operators(vector<G4LogicalVolume *> &biased_volumes);
+
+  G4VUserDetectorConstruction *detector_construction;
+  G4VPhysicalVolume *world;
+
+  static vector<G4String> forced_collision_volumes;
+  static vector<G4String> splitting_volumes;
+  static G4int splitting_factor;
+};
@@ -0,0 +1,68 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <vector>
+
+#include "G4LogicalVolume.hh"
+#include "G4RotationMatrix.hh"
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+using std::vector;
+
+// Collects the bricks of a wall (see Bricks.hh). To build a wall, pass a BrickWall to the constructors of the brick
+// classes, call their Put() methods as usual, and call BrickWall::Construct() after all bricks have been put.
+//
+// By default, every brick is placed immediately as a G4PVPlacement of its own, exactly like a brick without a wall.
+// If utr is built with the MERGE_BRICK_WALLS option, Construct() merges all bricks of the same material into a
+// single voxelized G4MultiUnion, which is placed once. The navigator then sees one daughter volume per material
+// instead of hundreds, and particles inside the wall do not stop at the boundaries between adjacent bricks.
+// A G4PVParameterised is not used, since it has to be the only daughter of its mother volume, and the beam pipe
+// passes through the walls.
+class BrickWall {
+  public:
+  BrickWall(G4LogicalVolume *world_Logical, G4String name) : World_Logical(world_Logical), Name(name){};
+  ~BrickWall(){};
+
+  void Add(G4LogicalVolume *brick_logical, G4String brick_name, G4RotationMatrix *rotation, G4ThreeVector position);
+  void Construct();
+
+  // Default: true if utr is built with MERGE_BRICK_WALLS. Only used by the brick wall benchmark.
+  static void Set_Merge(G4bool merge_walls) { merge = merge_walls; };
+  static G4bool Get_Merge() { return merge; };
+
+  // One rotation matrix is shared by all bricks with the same rotation angles, whether they belong to a wall or not
+  static G4RotationMatrix *Get_Rotation(G4double angle_x, G4double angle_y, G4double angle_z);
+  // Forget the shared rotation matrices (see SharedVolumes.hh)
+  static void Clear_Rotations();
+
+  private:
+  G4LogicalVolume *World_Logical;
+  G4String Name;
+
+  vector<G4LogicalVolume *> Brick_Logicals;
+  vector<G4RotationMatrix *> Brick_Rotations;
+  vector<G4ThreeVector> Brick_Positions;
+
+  static G4bool merge;
+  static vector<G4ThreeVector> rotation_angles;
+  static vector<G4RotationMatrix *> rotations;
+};
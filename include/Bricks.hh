@@ -35,11 +35,22 @@ along with utr.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4SystemOfUnits.hh"
 #include "G4UnitsTable.hh"
 
-#include "DetectorConstruction.hh"
+#include "BrickWall.hh"
+#include "Units.hh"
+
+// Places a brick directly in the mother volume, or adds it to a wall if one is given
+inline void Place_Brick(BrickWall *brick_wall, G4RotationMatrix *rot, G4ThreeVector position, G4LogicalVolume *brick_logical, G4String name, G4LogicalVolume *world_logical) {
+  if (brick_wall) {
+    brick_wall->Add(brick_logical, name, rot, position);
+    return;
+  }
+  new G4PVPlacement(rot, position, brick_logical, name, world_logical, false, 0);
+}
 
 class NormBrick {
   private:
   G4LogicalVolume *World_Logical;
+  BrickWall *brick_wall;
 
   G4LogicalVolume *NormBrick_Logical;
   G4Box *NormBrick_Solid;
@@ -54,7 +65,7 @@ class NormBrick {
   G4double M;
   G4double S;
 
-  NormBrick(G4LogicalVolume *world_Logical) {
+  NormBrick(G4LogicalVolume *world_Logical, BrickWall *wall = nullptr) : brick_wall(wall) {
     L = 200. * mm;
     M = 100. * mm;
     S = 50. * mm;
@@ -78,26 +89,22 @@ class NormBrick {
   ~NormBrick(){};
 
   void Put(G4double x, G4double y, G4double z) {
-    new G4PVPlacement(0, G4ThreeVector(x, y, z), NormBrick_Logical,
-                      "NormBrick", World_Logical, false, 0);
+    Place_Brick(brick_wall, 0, G4ThreeVector(x, y, z), NormBrick_Logical, "NormBrick", World_Logical);
   }
 
   void Put(G4double x, G4double y, G4double z, G4double angle_x,
            G4double angle_y, G4double angle_z) {
 
-    rot = new G4RotationMatrix();
-    rot->rotateX(angle_x);
-    rot->rotateY(angle_y);
-    rot->rotateZ(angle_z);
+    rot = BrickWall::Get_Rotation(angle_x, angle_y, angle_z);
 
-    new G4PVPlacement(rot, G4ThreeVector(x, y, z), NormBrick_Logical,
-                      "NormBrick", World_Logical, false, 0);
+    Place_Brick(brick_wall, rot, G4ThreeVector(x, y, z), NormBrick_Logical, "NormBrick", World_Logical);
   }
 };
 
 class NormBrickWithHole {
   private:
   G4LogicalVolume *World_Logical;
+  BrickWall *brick_wall;
 
   G4LogicalVolume *NormBrickWithHole_Logical;
   G4SubtractionSolid *NormBrickWithHole_Solid;
@@ -109,7 +116,7 @@ class NormBrickWithHole {
   G4double S;
   G4double Hole_Radius;
 
-  NormBrickWithHole(G4LogicalVolume *world_Logical) {
+  NormBrickWithHole(G4LogicalVolume *world_Logical, BrickWall *wall = nullptr) : brick_wall(wall) {
     L = 200. * mm;
     M = 100. * mm;
     S = 50. * mm;
@@ -144,27 +151,22 @@ class NormBrickWithHole {
   ~NormBrickWithHole(){};
 
   void Put(G4double x, G4double y, G4double z) {
-    new G4PVPlacement(0, G4ThreeVector(x, y, z), NormBrickWithHole_Logical,
-                      "NormBrickWithHole", World_Logical, false, 0);
+    Place_Brick(brick_wall, 0, G4ThreeVector(x, y, z), NormBrickWithHole_Logical, "NormBrickWithHole", World_Logical);
   }
 
   void Put(G4double x, G4double y, G4double z, G4double angle_x,
            G4double angle_y, G4double angle_z) {
 
-    rot = new G4RotationMatrix();
-    rot->rotateX(angle_x);
-    rot->rotateY(angle_y);
-    rot->rotateZ(angle_z);
+    rot = BrickWall::Get_Rotation(angle_x, angle_y, angle_z);
 
-    new G4PVPlacement(rot, G4ThreeVector(x, y, z),
-                      NormBrickWithHole_Logical, "NormBrickWithHole",
-                      World_Logical, false, 0);
+    Place_Brick(brick_wall, rot, G4ThreeVector(x, y, z), NormBrickWithHole_Logical, "NormBrickWithHole", World_Logical);
   }
 };
 
 class ShortNormBrick {
   private:
   G4LogicalVolume *World_Logical;
+  BrickWall *brick_wall;
 
   G4LogicalVolume *ShortNormBrick_Logical;
   G4Box *ShortNormBrick_Solid;
@@ -179,7 +181,7 @@ class ShortNormBrick {
   G4double M;
   G4double S;
 
-  ShortNormBrick(G4LogicalVolume *world_Logical) {
+  ShortNormBrick(G4LogicalVolume *world_Logical, BrickWall *wall = nullptr) : brick_wall(wall) {
     L = 100. * mm;
     M = 100. * mm;
     S = 50. * mm;
@@ -204,26 +206,22 @@ class ShortNormBrick {
   ~ShortNormBrick(){};
 
   void Put(G4double x, G4double y, G4double z) {
-    new G4PVPlacement(0, G4ThreeVector(x, y, z), ShortNormBrick_Logical,
-                      "ShortNormBrick", World_Logical, false, 0);
+    Place_Brick(brick_wall, 0, G4ThreeVector(x, y, z), ShortNormBrick_Logical, "ShortNormBrick", World_Logical);
   }
 
   void Put(G4double x, G4double y, G4double z, G4double angle_x,
            G4double angle_y, G4double angle_z) {
 
-    rot = new G4RotationMatrix();
-    rot->rotateX(angle_x);
-    rot->rotateY(angle_y);
-    rot->rotateZ(angle_z);
+    rot = BrickWall::Get_Rotation(angle_x, angle_y, angle_z);
 
-    new G4PVPlacement(rot, G4ThreeVector(x, y, z), ShortNormBrick_Logical,
-                      "ShortNormBrick", World_Logical, false, 0);
+    Place_Brick(brick_wall, rot, G4ThreeVector(x, y, z), ShortNormBrick_Logical, "ShortNormBrick", World_Logical);
   }
 };
 
 class ShortBrickWithHole {
   private:
   G4LogicalVolume *World_Logical;
+  BrickWall *brick_wall;
 
   G4LogicalVolume *ShortBrickWithHole_Logical;
   G4SubtractionSolid *ShortBrickWithHole_Solid;
@@ -239,7 +237,7 @@ class ShortBrickWithHole {
   G4double S;
   G4double Hole_Radius;
 
-  ShortBrickWithHole(G4LogicalVolume *world_Logical) {
+  ShortBrickWithHole(G4LogicalVolume *world_Logical, BrickWall *wall = nullptr) : brick_wall(wall) {
     L = 100. * mm;
     M = 100. * mm;
     S = 50. * mm;
@@ -277,27 +275,22 @@ class ShortBrickWithHole {
   ~ShortBrickWithHole(){};
 
   void Put(G4double x, G4double y, G4double z) {
-    new G4PVPlacement(0, G4ThreeVector(x, y, z), ShortBrickWithHole_Logical,
-                      "ShortBrickWithHole", World_Logical, false, 0);
+    Place_Brick(brick_wall, 0, G4ThreeVector(x, y, z), ShortBrickWithHole_Logical, "ShortBrickWithHole", World_Logical);
   }
 
   void Put(G4double x, G4double y, G4double z, G4double angle_x,
            G4double angle_y, G4double angle_z) {
 
-    rot = new G4RotationMatrix();
-    rot->rotateX(angle_x);
-    rot->rotateY(angle_y);
-    rot->rotateZ(angle_z);
+    rot = BrickWall::Get_Rotation(angle_x, angle_y, angle_z);
 
-    new G4PVPlacement(rot, G4ThreeVector(x, y, z),
-                      ShortBrickWithHole_Logical, "ShortBrickWithHole",
-                      World_Logical, false, 0);
+    Place_Brick(brick_wall, rot, G4ThreeVector(x, y, z), ShortBrickWithHole_Logical, "ShortBrickWithHole", World_Logical);
   }
 };
 
 class HalfShortBrickWithHole {
   private:
   G4LogicalVolume *World_Logical;
+  BrickWall *brick_wall;
 
   G4LogicalVolume *HalfShortBrickWithHole_Logical;
   G4SubtractionSolid *HalfShortBrickWithHole_Solid;
@@ -313,7 +306,7 @@ class HalfShortBrickWithHole {
   G4double S;
   G4double Hole_Radius;
 
-  HalfShortBrickWithHole(G4LogicalVolume *world_Logical) {
+  HalfShortBrickWithHole(G4LogicalVolume *world_Logical, BrickWall *wall = nullptr) : brick_wall(wall) {
     L = 100. * mm;
     M = 50. * mm;
     S = 50. * mm;
@@ -351,28 +344,22 @@ class HalfShortBrickWithHole {
   ~HalfShortBrickWithHole(){};
 
   void Put(G4double x, G4double y, G4double z) {
-    new G4PVPlacement(0, G4ThreeVector(x, y, z),
-                      HalfShortBrickWithHole_Logical,
-                      "HalfShortBrickWithHole", World_Logical, false, 0);
+    Place_Brick(brick_wall, 0, G4ThreeVector(x, y, z), HalfShortBrickWithHole_Logical, "HalfShortBrickWithHole", World_Logical);
   }
 
   void Put(G4double x, G4double y, G4double z, G4double angle_x,
            G4double angle_y, G4double angle_z) {
 
-    rot = new G4RotationMatrix();
-    rot->rotateX(angle_x);
-    rot->rotateY(angle_y);
-    rot->rotateZ(angle_z);
+    rot = BrickWall::Get_Rotation(angle_x, angle_y, angle_z);
 
-    new G4PVPlacement(rot, G4ThreeVector(x, y, z),
-                      HalfShortBrickWithHole_Logical,
-                      "HalfShortBrickWithHole", World_Logical, false, 0);
+    Place_Brick(brick_wall, rot, G4ThreeVector(x, y, z), HalfShortBrickWithHole_Logical, "HalfShortBrickWithHole", World_Logical);
   }
 };
 
 class ConcreteBrick {
   private:
   G4LogicalVolume *World_Logical;
+  BrickWall *brick_wall;
 
   G4LogicalVolume *ConcreteBrick_Logical;
   G4Box *ConcreteBrick_Solid;
@@ -387,7 +374,7 @@ class ConcreteBrick {
   G4double M;
   G4double S;
 
-  ConcreteBrick(G4LogicalVolume *world_Logical) {
+  ConcreteBrick(G4LogicalVolume *world_Logical, BrickWall *wall = nullptr) : brick_wall(wall) {
     L = 390. * mm;
     M = 190. * mm;
     S = 190. * mm;
@@ -412,26 +399,22 @@ class ConcreteBrick {
   ~ConcreteBrick(){};
 
   void Put(G4double x, G4double y, G4double z) {
-    new G4PVPlacement(0, G4ThreeVector(x, y, z), ConcreteBrick_Logical,
-                      "ConcreteBrick", World_Logical, false, 0);
+    Place_Brick(brick_wall, 0, G4ThreeVector(x, y, z), ConcreteBrick_Logical, "ConcreteBrick", World_Logical);
   }
 
   void Put(G4double x, G4double y, G4double z, G4double angle_x,
            G4double angle_y, G4double angle_z) {
 
-    rot = new G4RotationMatrix();
-    rot->rotateX(angle_x);
-    rot->rotateY(angle_y);
-    rot->rotateZ(angle_z);
+    rot = BrickWall::Get_Rotation(angle_x, angle_y, angle_z);
 
-    new G4PVPlacement(rot, G4ThreeVector(x, y, z), ConcreteBrick_Logical,
-                      "ConcreteBrick", World_Logical, false, 0);
+    Place_Brick(brick_wall, rot, G4ThreeVector(x, y, z), ConcreteBrick_Logical, "ConcreteBrick", World_Logical);
   }
 };
 
 class BridgeBrick {
   private:
   G4LogicalVolume *World_Logical;
+  BrickWall *brick_wall;
 
   G4LogicalVolume *BridgeBrick_Logical;
   G4SubtractionSolid *BridgeBrick_Solid;
@@ -447,7 +430,7 @@ class BridgeBrick {
   G4double S;
   G4double Hole_Radius;
 
-  BridgeBrick(G4LogicalVolume *world_Logical) {
+  BridgeBrick(G4LogicalVolume *world_Logical, BrickWall *wall = nullptr) : brick_wall(wall) {
     L = 190. * mm;
     M = 95. * mm;
     S = 60. * mm;
@@ -483,26 +466,22 @@ class BridgeBrick {
   ~BridgeBrick(){};
 
   void Put(G4double x, G4double y, G4double z) {
-    new G4PVPlacement(0, G4ThreeVector(x, y, z), BridgeBrick_Logical,
-                      "BridgeBrick", World_Logical, false, 0);
+    Place_Brick(brick_wall, 0, G4ThreeVector(x, y, z), BridgeBrick_Logical, "BridgeBrick", World_Logical);
   }
 
   void Put(G4double x, G4double y, G4double z, G4double angle_x,
            G4double angle_y, G4double angle_z) {
 
-    rot = new G4RotationMatrix();
-    rot->rotateX(angle_x);
-    rot->rotateY(angle_y);
-    rot->rotateZ(angle_z);
+    rot = BrickWall::Get_Rotation(angle_x, angle_y, angle_z);
 
-    new G4PVPlacement(rot, G4ThreeVector(x, y, z), BridgeBrick_Logical,
-                      "BridgeBrick", World_Logical, false, 0);
+    Place_Brick(brick_wall, rot, G4ThreeVector(x, y, z), BridgeBrick_Logical, "BridgeBrick", World_Logical);
   }
 };
 
 class ThinNormBrick {
   private:
   G4LogicalVolume *World_Logical;
+  BrickWall *brick_wall;
 
   G4LogicalVolume *ThinNormBrick_Logical;
   G4Box *ThinNormBrick_Solid;
@@ -517,7 +496,7 @@ class ThinNormBrick {
   G4double M;
   G4double S;
 
-  ThinNormBrick(G4LogicalVolume *world_Logical) {
+  ThinNormBrick(G4LogicalVolume *world_Logical, BrickWall *wall = nullptr) : brick_wall(wall) {
     L = 200. * mm;
     M = 50. * mm;
     S = 50. * mm;
@@ -542,26 +521,22 @@ class ThinNormBrick {
   ~ThinNormBrick(){};
 
   void Put(G4double x, G4double y, G4double z) {
-    new G4PVPlacement(0, G4ThreeVector(x, y, z), ThinNormBrick_Logical,
-                      "ThinNormBrick", World_Logical, false, 0);
+    Place_Brick(brick_wall, 0, G4ThreeVector(x, y, z), ThinNormBrick_Logical, "ThinNormBrick", World_Logical);
   }
 
   void Put(G4double x, G4double y, G4double z, G4double angle_x,
            G4double angle_y, G4double angle_z) {
 
-    rot = new G4RotationMatrix();
-    rot->rotateX(angle_x);
-    rot->rotateY(angle_y);
-    rot->rotateZ(angle_z);
+    rot = BrickWall::Get_Rotation(angle_x, angle_y, angle_z);
 
-    new G4PVPlacement(rot, G4ThreeVector(x, y, z), ThinNormBrick_Logical,
-                      "ThinNormBrick", World_Logical, false, 0);
+    Place_Brick(brick_wall, rot, G4ThreeVector(x, y, z), ThinNormBrick_Logical, "ThinNormBrick", World_Logical);
   }
 };
 
 class ShortThinNormBrick {
   private:
   G4LogicalVolume *World_Logical;
+  BrickWall *brick_wall;
 
   G4LogicalVolume *ShortThinNormBrick_Logical;
   G4Box *ShortThinNormBrick_Solid;
@@ -576,7 +551,7 @@ class ShortThinNormBrick {
   G4double M;
   G4double S;
 
-  ShortThinNormBrick(G4LogicalVolume *world_Logical) {
+  ShortThinNormBrick(G4LogicalVolume *world_Logical, BrickWall *wall = nullptr) : brick_wall(wall) {
     L = 100. * mm;
     M = 50. * mm;
     S = 50. * mm;
@@ -603,27 +578,22 @@ class ShortThinNormBrick {
   ~ShortThinNormBrick(){};
 
   void Put(G4double x, G4double y, G4double z) {
-    new G4PVPlacement(0, G4ThreeVector(x, y, z), ShortThinNormBrick_Logical,
-                      "ShortThinNormBrick", World_Logical, false, 0);
+    Place_Brick(brick_wall, 0, G4ThreeVector(x, y, z), ShortThinNormBrick_Logical, "ShortThinNormBrick", World_Logical);
   }
 
   void Put(G4double x, G4double y, G4double z, G4double angle_x,
            G4double angle_y, G4double angle_z) {
 
-    rot = new G4RotationMatrix();
-    rot->rotateX(angle_x);
-    rot->rotateY(angle_y);
-    rot->rotateZ(angle_z);
+    rot = BrickWall::Get_Rotation(angle_x, angle_y, angle_z);
 
-    new G4PVPlacement(rot, G4ThreeVector(x, y, z),
-                      ShortThinNormBrick_Logical, "ShortThinNormBrick",
-                      World_Logical, false, 0);
+    Place_Brick(brick_wall, rot, G4ThreeVector(x, y, z), ShortThinNormBrick_Logical, "ShortThinNormBrick", World_Logical);
   }
 };
 
 class FlatFlatThinNormBrick {
   private:
   G4LogicalVolume *World_Logical;
+  BrickWall *brick_wall;
 
   G4LogicalVolume *FlatFlatThinNormBrick_Logical;
   G4Box *FlatFlatThinNormBrick_Solid;
@@ -638,7 +608,7 @@ class FlatFlatThinNormBrick {
   G4double M;
   G4double S;
 
-  FlatFlatThinNormBrick(G4LogicalVolume *world_Logical) {
+  FlatFlatThinNormBrick(G4LogicalVolume *world_Logical, BrickWall *wall = nullptr) : brick_wall(wall) {
     L = 200. * mm;
     M = 50. * mm;
     S = 12.5 * mm;
@@ -665,28 +635,22 @@ class FlatFlatThinNormBrick {
   ~FlatFlatThinNormBrick(){};
 
   void Put(G4double x, G4double y, G4double z) {
-    new G4PVPlacement(0, G4ThreeVector(x, y, z),
-                      FlatFlatThinNormBrick_Logical,
-                      "FlatFlatThinNormBrick", World_Logical, false, 0);
+    Place_Brick(brick_wall, 0, G4ThreeVector(x, y, z), FlatFlatThinNormBrick_Logical, "FlatFlatThinNormBrick", World_Logical);
   }
 
   void Put(G4double x, G4double y, G4double z, G4double angle_x,
            G4double angle_y, G4double angle_z) {
 
-    rot = new G4RotationMatrix();
-    rot->rotateX(angle_x);
-    rot->rotateY(angle_y);
-    rot->rotateZ(angle_z);
+    rot = BrickWall::Get_Rotation(angle_x, angle_y, angle_z);
 
-    new G4PVPlacement(rot, G4ThreeVector(x, y, z),
-                      FlatFlatThinNormBrick_Logical,
-                      "FlatFlatThinNormBrick", World_Logical, false, 0);
+    Place_Brick(brick_wall, rot, G4ThreeVector(x, y, z), FlatFlatThinNormBrick_Logical, "FlatFlatThinNormBrick", World_Logical);
   }
 };
 
 class ThreeQuarterShortNormBrick {
   private:
   G4LogicalVolume *World_Logical;
+  BrickWall *brick_wall;
 
   G4LogicalVolume *ThreeQuarterShortNormBrick_Logical;
   G4Box *ThreeQuarterShortNormBrick_Solid;
@@ -701,7 +665,7 @@ class ThreeQuarterShortNormBrick {
   G4double M;
   G4double S;
 
-  ThreeQuarterShortNormBrick(G4LogicalVolume *world_Logical) {
+  ThreeQuarterShortNormBrick(G4LogicalVolume *world_Logical, BrickWall *wall = nullptr) : brick_wall(wall) {
     L = 150. * mm;
     M = 100. * mm;
     S = 50. * mm;
@@ -728,28 +692,22 @@ class ThreeQuarterShortNormBrick {
   ~ThreeQuarterShortNormBrick(){};
 
   void Put(G4double x, G4double y, G4double z) {
-    new G4PVPlacement(
-        0, G4ThreeVector(x, y, z), ThreeQuarterShortNormBrick_Logical,
-        "ThreeQuarterShortNormBrick", World_Logical, false, 0);
+    Place_Brick(brick_wall, 0, G4ThreeVector(x, y, z), ThreeQuarterShortNormBrick_Logical, "ThreeQuarterShortNormBrick", World_Logical);
   }
 
   void Put(G4double x, G4double y, G4double z, G4double angle_x,
            G4double angle_y, G4double angle_z) {
 
-    rot = new G4RotationMatrix();
-    rot->rotateX(angle_x);
-    rot->rotateY(angle_y);
-    rot->rotateZ(angle_z);
+    rot = BrickWall::Get_Rotation(angle_x, angle_y, angle_z);
 
-    new G4PVPlacement(
-        rot, G4ThreeVector(x, y, z), ThreeQuarterShortNormBrick_Logical,
-        "ThreeQuarterShortNormBrick", World_Logical, false, 0);
+    Place_Brick(brick_wall, rot, G4ThreeVector(x, y, z), ThreeQuarterShortNormBrick_Logical, "ThreeQuarterShortNormBrick", World_Logical);
   }
 };
 
 class FlatConcreteBrick {
   private:
   G4LogicalVolume *World_Logical;
+  BrickWall *brick_wall;
 
   G4LogicalVolume *FlatConcreteBrick_Logical;
   G4Box *FlatConcreteBrick_Solid;
@@ -764,7 +722,7 @@ class FlatConcreteBrick {
   G4double M;
   G4double S;
 
-  FlatConcreteBrick(G4LogicalVolume *world_Logical) {
+  FlatConcreteBrick(G4LogicalVolume *world_Logical, BrickWall *wall = nullptr) : brick_wall(wall) {
     L = 390. * mm;
     M = 190. * mm;
     S = 95. * mm;
@@ -790,20 +748,14 @@ class FlatConcreteBrick {
   ~FlatConcreteBrick(){};
 
   void Put(G4double x, G4double y, G4double z) {
-    new G4PVPlacement(0, G4ThreeVector(x, y, z), FlatConcreteBrick_Logical,
-                      "FlatConcreteBrick", World_Logical, false, 0);
+    Place_Brick(brick_wall, 0, G4ThreeVector(x, y, z), FlatConcreteBrick_Logical, "FlatConcreteBrick", World_Logical);
   }
 
   void Put(G4double x, G4double y, G4double z, G4double angle_x,
            G4double angle_y, G4double angle_z) {
 
-    rot = new G4RotationMatrix();
-    rot->rotateX(angle_x);
-    rot->rotateY(angle_y);
-    rot->rotateZ(angle_z);
+    rot = BrickWall::Get_Rotation(angle_x, angle_y, angle_z);
 
-    new G4PVPlacement(rot, G4ThreeVector(x, y, z),
-                      FlatConcreteBrick_Logical, "FlatConcreteBrick",
-                      World_Logical, false, 0);
+    Place_Brick(brick_wall, rot, G4ThreeVector(x, y, z), FlatConcreteBrick_Logical, "FlatConcreteBrick", World_Logical);
   }
 };
@@ -0,0 +1,50 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "G4String.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VUserDetectorConstruction.hh"
+
+// Wrapper around the DetectorConstruction of a setup, which stores the constructed geometry as a
+// GDML file in a cache directory. If a GDML file for the same setup and geometry-related build
+// options already exists, it is read instead of calling the Construct() method of the setup.
+// Sensitive detectors are still created by the ConstructSDandField() method of the setup, which
+// looks up the logical volumes by their names.
+class CachedDetectorConstruction : public G4VUserDetectorConstruction {
+  public:
+  CachedDetectorConstruction(G4VUserDetectorConstruction *detector_construction, const G4String &cache_dir);
+  ~CachedDetectorConstruction();
+
+  G4VPhysicalVolume *Construct() override;
+  void ConstructSDandField() override;
+
+  // Name of the cache file: <cache_dir>/<hash of setup and geometry-related build options>.gdml
+  G4String Get_Cache_Filename() const;
+
+  // Write the geometry which is currently used for tracking to a GDML file
+  static void Export(const G4String &filename);
+
+  private:
+  static void Write(const G4String &filename, G4VPhysicalVolume *world);
+
+  G4VUserDetectorConstruction *detector_construction;
+  G4String cache_dir;
+};
@@ -62,7 +62,28 @@ class CeBr3_2x2 : public Detector {
   void Construct(G4ThreeVector global_coordinates, G4double theta, G4double phi, G4double dist_from_center, G4double intrinsic_rotation_angle) const override;
 
   void disableConnectors() { use_connectors = false; };
+  // Forget the shared model, whose volumes are deleted when the geometry is rebuilt (see SharedVolumes.hh)
+  static void Clear_Model() {
+    delete model;
+    model = nullptr;
+  };
 
   private:
   bool use_connectors;
+
+  // Material, solids and passive logical volumes which are the same for all CeBr3_2x2 detectors.
+  // They are constructed only once and shared by all placements. The crystal, which carries the
+  // sensitive detector, and its mother volumes get their own logical volumes for each detector.
+  struct Model {
+    G4Material *crystal_material;
+    G4VSolid *main_case_solid;
+    G4VSolid *main_case_vacuum_solid;
+    G4VSolid *crystal_solid;
+    G4LogicalVolume *pmt_logical;
+    G4LogicalVolume *magnetic_shielding_logical;
+    G4LogicalVolume *connector_base_logical;
+    G4LogicalVolume *connector_hv_logical;
+    G4LogicalVolume *connector_signal_logical;
+  };
+  static Model *model;
 };
@@ -26,6 +26,10 @@ along with utr.  If not, see <http://www.gnu.org/licenses/>.
 #include <vector>
 
 #include "G4LogicalVolume.hh"
+#include "G4RotationMatrix.hh"
+#include "G4ThreeVector.hh"
+
+#include "FilterStack.hh"
 
 using std::vector;
 
@@ -45,15 +49,19 @@ class Detector {
   // to shield low-energy radiation. Similar to the filters, additional wraps
   // will be wrapped around previous ones.
   void Add_Wrap(G4String wrap_material, G4double wrap_thickness);
+  // Merge adjacent filters of the same material and size into a single volume. This reduces the
+  // number of volumes, but the individual filters can no longer be distinguished.
+  void Merge_Filters() { filters.Merge_Filters(); };
 
   protected:
   G4LogicalVolume *world_Logical;
   G4String detector_name;
 
-  vector<G4String> filter_materials;
-  vector<G4double> filter_thicknesses;
-  vector<G4double> filter_radii;
+  FilterStack filters;
 
   vector<G4String> wrap_materials;
   vector<G4double> wrap_thicknesses;
+
+  // Places the filters along the symmetry axis (see FilterStack::Construct()).
+  G4double Construct_Filters(G4RotationMatrix *rotation, G4ThreeVector global_coordinates, G4ThreeVector symmetry_axis, G4double dist_from_center, G4double default_radius, bool square = false) const { return filters.Construct(rotation, global_coordinates, symmetry_axis, dist_from_center, default_radius, square); };
 };
@@ -0,0 +1,103 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include "G4FastStep.hh"
+#include "G4FastTrack.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Region.hh"
+#include "G4Step.hh"
+#include "G4VFastSimulationModel.hh"
+#include "globals.hh"
+
+using std::map;
+using std::vector;
+
+// Tabulated response of the sensitive volumes to photons, which is used to replace the simulation
+// of the particle showers inside the detector crystals by a single step.
+//
+// In the calibration mode, the energy of each primary photon which enters a sensitive volume and
+// the total energy deposition in that volume during the event are recorded. For each logical volume
+// and each bin of the incident energy, the table contains the probabilities of no energy
+// deposition, of a full-energy deposition, and the distribution of the deposited fraction of the
+// incident energy (Compton continuum, escape peaks, backscatter, ...).
+// In the simulation mode, the DetectorResponseModel samples the energy deposition of each photon
+// which enters a tabulated volume from the row of the closest incident energy, and kills the photon.
+class DetectorResponse {
+  public:
+  // Calibration mode
+  static void Set_Calibration_File(const G4String &filename) { calibration_filename = filename; };
+  static bool Calibrating() { return calibration_filename != ""; };
+  static void Set_Energy_Bin_Width(G4double width);
+  static void Record_Step(const G4Step *step); // Called by the SteppingAction
+  static void End_Of_Event(); // Called by the EventAction
+  // Add the calibration data of the current thread to the total (called by each RunAction at the end of a run)
+  static void Merge();
+  static void Write();
+
+  // Simulation mode
+  static void Read(const G4String &filename);
+  // Use the response of calibrated_volume for volume, e.g. for several detectors of the same model
+  static void Use_Response(const G4String &volume, const G4String &calibrated_volume) { aliases[volume] = calibrated_volume; };
+  static bool Has_Response(const G4String &volume);
+  static G4double Sample_Energy_Deposition(const G4String &volume, G4double energy);
+  // Create the fast-simulation model for the sensitive volumes which have a response (called in ConstructSDandField())
+  static void Construct_Model();
+
+  private:
+  struct Row {
+    G4long n_zero;
+    G4long n_full;
+    vector<G4long> continuum; // Histogram of the deposited fraction of the incident energy
+    vector<G4double> cumulative; // Cumulative distribution of [zero, continuum bins, full], built by Read()
+    Row();
+    void Add(const Row &other);
+  };
+  typedef map<G4int, Row> Table; // Rows for each bin of the incident energy
+
+  static const G4String &Find_Table_Name(const G4String &volume);
+
+  static const unsigned int n_fraction_bins;
+  static G4double energy_bin_width;
+  static G4String calibration_filename;
+  static map<G4String, Table> tables;
+  static map<G4String, G4String> aliases;
+
+  struct Entry {
+    G4double energy; // Energy of the primary photon when it entered the volume, negative if none has entered
+    G4double energy_deposition;
+  };
+  static G4ThreadLocal map<G4String, Table> *thread_tables;
+  static G4ThreadLocal map<const G4LogicalVolume *, Entry> *event_entries;
+};
+
+// Fast-simulation model for the envelope of the sensitive volumes
+class DetectorResponseModel : public G4VFastSimulationModel {
+  public:
+  DetectorResponseModel(G4Region *envelope) : G4VFastSimulationModel("DetectorResponseModel", envelope){};
+
+  G4bool IsApplicable(const G4ParticleDefinition &particle) override;
+  G4bool ModelTrigger(const G4FastTrack &fast_track) override;
+  void DoIt(const G4FastTrack &fast_track, G4FastStep &fast_step) override;
+};
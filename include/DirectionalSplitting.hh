@@ -0,0 +1,83 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "G4BiasingProcessInterface.hh"
+#include "G4ParticleChange.hh"
+#include "G4ThreeVector.hh"
+#include "G4VBiasingOperation.hh"
+#include "G4VBiasingOperator.hh"
+#include "globals.hh"
+
+using std::vector;
+
+// Directional splitting of photon scattering (Compton and Rayleigh) in a volume, typically the target.
+// For each scattering, the interaction is sampled splitting_factor times:
+//   - Scattered photons which head towards a detector are kept with 1/splitting_factor of the original weight.
+//   - Scattered photons which head elsewhere survive a Russian roulette with the probability
+//     1/splitting_factor and keep the original weight.
+//   - Electrons and other secondaries are only taken from the first sample and keep the original weight.
+// The track itself continues as the first surviving photon, all others are added as secondaries.
+// Each surviving photon except the one of the first sample is tagged as a new copy of the event (see BiasedCopies.hh).
+class DirectionalSplittingOperation : public G4VBiasingOperation {
+  public:
+  DirectionalSplittingOperation(const G4String &name);
+
+  void Set_Splitting_Factor(G4int factor) { splitting_factor = factor; };
+  // Add a cone around the direction of a detector, as seen from the splitting volume
+  void Add_Cone(const G4ThreeVector &direction, G4double half_angle);
+
+  const G4VBiasingInteractionLaw *ProvideOccurenceBiasingInteractionLaw(const G4BiasingProcessInterface *, G4ForceCondition &) override { return nullptr; };
+  G4double DistanceToApplyOperation(const G4Track *, G4double, G4ForceCondition *) override { return DBL_MAX; };
+  G4VParticleChange *GenerateBiasingFinalState(const G4Track *, const G4Step *) override { return nullptr; };
+  G4VParticleChange *ApplyFinalStateBiasing(const G4BiasingProcessInterface *callingProcess, const G4Track *track, const G4Step *step, G4bool &) override;
+
+  private:
+  bool Towards_Detector(const G4ThreeVector &direction) const;
+
+  struct Photon {
+    G4ThreeVector direction;
+    G4double energy;
+    G4ThreeVector polarization;
+    G4double weight;
+  };
+
+  G4int splitting_factor;
+  vector<G4ThreeVector> cone_directions;
+  vector<G4double> cone_cos_half_angles;
+  G4ParticleChange particle_change;
+};
+
+class DirectionalSplittingOperator : public G4VBiasingOperator {
+  public:
+  DirectionalSplittingOperator(G4int splitting_factor);
+
+  void Add_Cone(const G4ThreeVector &direction, G4double half_angle) { operation.Add_Cone(direction, half_angle); };
+
+  private:
+  G4VBiasingOperation *ProposeNonPhysicsBiasingOperation(const G4Track *, const G4BiasingProcessInterface *) override { return nullptr; };
+  G4VBiasingOperation *ProposeOccurenceBiasingOperation(const G4Track *, const G4BiasingProcessInterface *) override { return nullptr; };
+  G4VBiasingOperation *ProposeFinalStateBiasingOperation(const G4Track *track, const G4BiasingProcessInterface *callingProcess) override;
+
+  DirectionalSplittingOperation operation;
+};
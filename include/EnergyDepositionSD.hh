@@ -19,11 +19,14 @@ along with utr.  If not, see <http://www.gnu.org/licenses/>.
 */
 #pragma once
 
+#include <vector>
+
+#include "G4ThreeVector.hh"
 #include "G4VSensitiveDetector.hh"
 
 #include "TargetHit.hh"
 
-#include <vector>
+using std::vector;
 
 class G4Step;
 class G4HCofThisEvent;
@@ -40,10 +43,28 @@ class EnergyDepositionSD : public G4VSensitiveDetector {
   virtual void EndOfEvent(G4HCofThisEvent *hitCollection);
   unsigned int GetDetectorID() { return detectorID; };
   void SetDetectorID(unsigned int detID) { detectorID = detID; };
-  static std::vector<bool> anyDetectorHitInEvent; // Needed for EVENT_EVENTWISE mode, signals whether an entry (row) needs to be written to the root file for the current event (or whether the row would be zeroes only)
+
+  // Write the rows of all detectors for the current event to the output file. Called by the EventAction, because the
+  // rows of a copy (see BiasedCopies.hh) are only complete after the EndOfEvent() of all detectors.
+  static void Write_Event();
 
   private:
   TargetHitsCollection *hitsCollection;
   G4int detectorID;
   G4int eventID;
+
+  // Total energy deposition of one copy in one detector. All hits of a copy have the same weight, and the
+  // other quantities are taken from its first hit.
+  struct Deposition {
+    G4int copyID;
+    G4int detectorID;
+    G4int eventID;
+    G4double energyDeposition;
+    G4double weight;
+    G4double kineticEnergy;
+    G4int particleType;
+    G4ThreeVector position;
+    G4ThreeVector momentum;
+  };
+  static G4ThreadLocal vector<Deposition> *depositions;
 };
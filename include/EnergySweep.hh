@@ -0,0 +1,59 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "G4Event.hh"
+#include "globals.hh"
+
+using std::vector;
+
+// Energy sweep, which replaces a /control/loop over many runs with monoenergetic primaries by a
+// single run with the same number of events for each energy.
+//
+// The events are assigned to the energies in turn, i.e. the event with the index k in the run (or
+// in the RunChain) has the energy number k % n_energies, so that any part of the run, e.g. the
+// events of a single thread or of an interrupted run, contains all energies in equal proportions.
+// The primary generator sets the energy of all primaries of the event, and the sensitive detectors
+// write it to an additional ntuple column "ebeam". Compared to one run per energy, the
+// initialization of the runs and the opening of the output files happens only once, and the output
+// of all energies is written to the same files.
+class EnergySweep {
+  public:
+  static void Set_Energies(const vector<G4double> &energies);
+  // Energies min, min + step, ..., max
+  static void Set_Energy_Range(G4double min, G4double max, G4double step);
+  // Simulates n_events_per_energy for each energy in a RunChain
+  static void BeamOn(G4long n_events_per_energy);
+
+  // True during the run of BeamOn, only then the energies are set and the ntuple column is written
+  static bool Is_Active() { return active; };
+  // Called by the primary generator after the primary vertices have been generated
+  static void Set_Primary_Energy(G4Event *event);
+  // Energy of the current event of this thread
+  static G4double Get_Energy() { return current_energy; };
+
+  private:
+  static vector<G4double> energies;
+  static G4bool active;
+  static G4ThreadLocal G4double current_energy;
+};
@@ -19,8 +19,6 @@ along with utr.  If not, see <http://www.gnu.org/licenses/>.
 */
 #pragma once
 
-#include <time.h>
-
 #include "G4UserEventAction.hh"
 #include "globals.hh"
 
@@ -30,9 +28,4 @@ class EventAction : public G4UserEventAction {
   virtual ~EventAction();
 
   virtual void EndOfEventAction(const G4Event *);
-
-  void setNThreads(const int nt) { n_threads = (G4double)nt; };
-
-  private:
-  G4int n_threads;
 };
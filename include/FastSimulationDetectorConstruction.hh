@@ -0,0 +1,44 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "G4VPhysicalVolume.hh"
+#include "G4VUserDetectorConstruction.hh"
+
+#include "DetectorResponse.hh"
+
+// Wrapper around the DetectorConstruction of a setup, which creates the fast-simulation model of
+// the tabulated detector responses (see DetectorResponse.hh). The models are thread-local, so
+// they are created in ConstructSDandField().
+class FastSimulationDetectorConstruction : public G4VUserDetectorConstruction {
+  public:
+  FastSimulationDetectorConstruction(G4VUserDetectorConstruction *detector_construction) : detector_construction(detector_construction){};
+  ~FastSimulationDetectorConstruction() { delete detector_construction; };
+
+  G4VPhysicalVolume *Construct() override { return detector_construction->Construct(); };
+  void ConstructSDandField() override {
+    detector_construction->ConstructSDandField();
+    DetectorResponse::Construct_Model();
+  };
+
+  private:
+  G4VUserDetectorConstruction *detector_construction;
+};
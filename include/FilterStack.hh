@@ -0,0 +1,79 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Stack of disk- or square-shaped filters which is placed along a symmetry axis in front of an
+// object, usually a detector. It is used by all classes derived from Detector (see Add_Filter()
+// there), but can also be used on its own, e.g. for detectors which are not implemented as a
+// Detector class or instead of the fixed filter types in Filters.hh.
+#pragma once
+
+#include <vector>
+
+#include "G4LogicalVolume.hh"
+#include "G4RotationMatrix.hh"
+#include "G4String.hh"
+#include "G4ThreeVector.hh"
+
+using std::vector;
+
+class FilterStack {
+  public:
+  // The names of the physical volumes of the filters start with name
+  FilterStack(G4LogicalVolume *world_Logical, G4String name) : world_Logical(world_Logical), name(name), merge_filters(false){};
+
+  // The first filter will be placed closest to the object, all others on top of the previous one
+  // in the direction of the symmetry axis. A negative radius is replaced by the default radius
+  // which is given to Construct().
+  void Add_Filter(G4String filter_material, G4double filter_thickness, G4double filter_radius);
+  // Merge adjacent filters of the same material and size into a single volume. This reduces the
+  // number of volumes, but the individual filters can no longer be distinguished.
+  void Merge_Filters() { merge_filters = true; };
+
+  // Places the filters along the symmetry axis, starting at a distance dist_from_center from
+  // global_coordinates and moving towards global_coordinates. Filters with a negative radius get
+  // the radius default_radius. Round filters are G4Tubs. Square filters are G4Boxes whose half
+  // side length is the filter radius. Returns the total thickness of the filters.
+  G4double Construct(G4RotationMatrix *rotation, G4ThreeVector global_coordinates, G4ThreeVector symmetry_axis, G4double dist_from_center, G4double default_radius, bool square = false) const;
+
+  // Filter logical volumes only depend on the material, the size and the color. They are
+  // constructed once and shared by all filter stacks.
+  static G4LogicalVolume *Get_Filter_Logical(const G4String &material, G4double thickness, G4double radius, bool square, bool red);
+  // Forget the shared filters, whose volumes are deleted when the geometry is rebuilt (see SharedVolumes.hh)
+  static void Clear_Filter_Logicals() { filter_logicals.clear(); };
+
+  private:
+  G4LogicalVolume *world_Logical;
+  G4String name;
+
+  vector<G4String> filter_materials;
+  vector<G4double> filter_thicknesses;
+  vector<G4double> filter_radii;
+  bool merge_filters;
+
+  struct Filter_Logical {
+    G4String material;
+    G4double thickness;
+    G4double radius;
+    bool square;
+    bool red;
+    G4LogicalVolume *logical;
+  };
+  static vector<Filter_Logical> filter_logicals;
+};
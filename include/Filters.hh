@@ -16,6 +16,10 @@ GNU General Public License for more details.
 You should have received a copy of the GNU General Public License
 along with utr.  If not, see <http://www.gnu.org/licenses/>.
 */
+
+// Fixed filter types of the geometries before the 2018 campaign. Each object constructs its own
+// logical volume. New geometries should use FilterStack (see FilterStack.hh) instead, which shares
+// the logical volumes of identical filters between all stacks.
 #pragma once
 
 #include "G4Box.hh"
@@ -0,0 +1,57 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "G4String.hh"
+#include "G4VUserDetectorConstruction.hh"
+
+// Access to the DetectorConstruction of the selected setup.
+// Every DetectorConstruction is compiled together with DetectorConstruction/GeometryPluginFactory.cc,
+// which exports C functions that create it and return its properties. By default, they are linked
+// into the utr executable. If the GEOMETRY_PLUGINS build option is set, each setup is compiled into
+// a shared library (plugin) instead, which is loaded at runtime with Load().
+class GeometryPlugin {
+  public:
+  // Load the plugin of a setup, given either as "<CAMPAIGN>/<DETECTOR_CONSTRUCTION>" relative to the
+  // plugin directory, or as a path to a shared library. Returns false if the plugin could not be loaded.
+  static bool Load(const G4String &geometry);
+  // Returns nullptr if utr was built with GEOMETRY_PLUGINS and no plugin has been loaded
+  static G4VUserDetectorConstruction *Create_Detector_Construction();
+  static unsigned int Get_Max_Sensitive_Detector_ID();
+  // "<CAMPAIGN>/<DETECTOR_CONSTRUCTION>" of the selected setup
+  static G4String Get_Geometry_Name();
+  // Build options which change the geometry, e.g. "USE_TARGETS=ON ... TARGET=154Sm"
+  static G4String Get_Geometry_Build_Options();
+
+  private:
+  typedef G4VUserDetectorConstruction *(*Create_Function)();
+  typedef unsigned int (*Max_Sensitive_Detector_ID_Function)(const G4VUserDetectorConstruction *);
+  typedef const char *(*Geometry_Name_Function)();
+
+  static void *handle;
+  static Create_Function create_function;
+  static Max_Sensitive_Detector_ID_Function max_sensitive_detector_id_function;
+  static Geometry_Name_Function geometry_name_function;
+  static Geometry_Name_Function geometry_build_options_function;
+
+  // The DetectorConstruction created by the plugin. It is not necessarily the one registered
+  // with the G4RunManager, which may be a CachedDetectorConstruction wrapped around it.
+  static G4VUserDetectorConstruction *detector_construction;
+};
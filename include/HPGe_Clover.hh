@@ -22,12 +22,16 @@ along with utr.  If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include <vector>
+
 #include "G4ExtrudedSolid.hh"
 #include "G4LogicalVolume.hh"
 
 #include "Detector.hh"
 #include "HPGe_Clover_Properties.hh"
 
+using std::vector;
+
 class HPGe_Clover : public Detector {
   public:
   HPGe_Clover(G4LogicalVolume *World_Logical, G4String name) : Detector(World_Logical, name), use_dewar(false){};
@@ -39,8 +43,31 @@ class HPGe_Clover : public Detector {
   void setProperties(HPGe_Clover_Properties &prop) { properties = prop; };
   void useDewar() { use_dewar = true; };
 
+  // Forget the shared models, whose volumes are deleted when the geometry is rebuilt (see SharedVolumes.hh)
+  static void Clear_Models() { models.clear(); };
+
   private:
   HPGe_Clover_Properties properties;
   bool use_dewar;
   G4VSolid *rounded_box(const G4String name, const G4double side_length, const G4double length, const G4double rounding_radius, const G4int n_points_per_corner) const;
+
+  // Solids and logical volumes which are identical for all clover detectors of the same model, i.e.
+  // with the same properties. They are constructed only once and shared by all placements of the
+  // model. The four crystals, which carry the sensitive detectors, and their mother volumes get
+  // their own logical volumes for each detector, but share the solids.
+  struct Model {
+    HPGe_Clover_Properties properties;
+    bool with_dewar;
+
+    G4VSolid *end_cap_front_solid;
+    G4VSolid *vacuum_solid;
+    G4LogicalVolume *air_front_logical;
+    G4VSolid *crystal_solid;
+    G4LogicalVolume *end_cap_back_logical;
+    G4LogicalVolume *connection_logical;
+    G4LogicalVolume *dewar_logical;
+  };
+  const Model &Get_Model() const;
+  static bool Is_Same_Model(const HPGe_Clover_Properties &a, const HPGe_Clover_Properties &b, bool with_dewar);
+  static vector<Model> models;
 };
@@ -46,9 +46,41 @@ class HPGe_Coaxial : public Detector {
   void useFilterCaseRing() { use_filter_case_ring = true; };
   void useDewar() { use_dewar = true; };
 
+  // Solids of the crystal and the cold finger with the face (tip) at z = 0 and the base at z = length.
+  // By default, their rounded edges are approximated by G4Polycones. With csg == true, they are
+  // composed of a few analytic solids (G4Tubs, G4Torus, G4Orb) instead, which represent the shape
+  // exactly. The latter is used in the geometry if the USE_CSG_CRYSTALS build option is set.
+  static G4VSolid *Crystal_Solid(const HPGe_Coaxial_Properties &properties, const G4String &name, bool csg);
+  static G4VSolid *Cold_Finger_Solid(const HPGe_Coaxial_Properties &properties, G4double cold_finger_length, const G4String &name, bool csg);
+  // Forget the shared models, whose volumes are deleted when the geometry is rebuilt (see SharedVolumes.hh)
+  static void Clear_Models() { models.clear(); };
+
   private:
   HPGe_Coaxial_Properties properties;
   bool use_filter_case;
   bool use_filter_case_ring;
   bool use_dewar;
+
+  // Solids and logical volumes which are identical for all detectors of the same model, i.e. with
+  // the same properties. They are constructed only once and shared by all placements of the model.
+  // The crystal, which carries the sensitive detector, and the vacuum inside the end cap that
+  // contains it get their own logical volumes for each detector, but share the solids.
+  struct Model {
+    HPGe_Coaxial_Properties properties;
+    bool with_dewar;
+
+    G4LogicalVolume *end_cap_side_logical;
+    G4LogicalVolume *end_cap_window_logical;
+    G4VSolid *end_cap_vacuum_solid;
+    G4LogicalVolume *mount_cup_side_logical;
+    G4LogicalVolume *mount_cup_face_logical;
+    G4LogicalVolume *mount_cup_base_logical;
+    G4LogicalVolume *cold_finger_logical;
+    G4VSolid *crystal_solid;
+    G4LogicalVolume *connection_logical;
+    G4LogicalVolume *dewar_logical;
+  };
+  const Model &Get_Model() const;
+  static bool Is_Same_Model(const HPGe_Coaxial_Properties &a, const HPGe_Coaxial_Properties &b, bool with_dewar);
+  static vector<Model> models;
 };
@@ -0,0 +1,56 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "G4GeometrySampler.hh"
+#include "globals.hh"
+
+using std::pair;
+using std::vector;
+
+// Geometric importance sampling in the mass geometry, using Geant4's importance-sampling framework.
+// Each physical volume is a geometry cell with an importance value (default: 1).
+// When a particle of the biased species crosses a boundary from a cell with importance I1 into a cell with importance I2,
+//   - it is split into I2/I1 copies, each with 1/(I2/I1) of the original weight, if I2 > I1,
+//   - it survives a Russian roulette with probability I2/I1 and gets its weight multiplied by I1/I2, if I2 < I1.
+// For a thick shield, the importance should increase by about the attenuation factor of each layer along the direction of penetration.
+// The statistical weights are written to the 'weight' column of the output (EVENT_WEIGHT).
+class ImportanceSampling {
+  public:
+  // Sampler which is registered with the physics list via G4ImportanceBiasing
+  static G4GeometrySampler *Get_Sampler();
+
+  // Set the importance of all physical volumes whose names contain the pattern (case-insensitive).
+  // If several patterns match a volume, the one which was set last takes precedence.
+  static void Set_Importance(const G4String &pattern, G4double importance);
+  // Write the importance values to the importance store of the current thread (called by each RunAction at the beginning of a run)
+  static void Fill_Importance_Store();
+  static void Print();
+
+  private:
+  static G4double Get_Importance(const G4String &physical_volume_name);
+
+  static G4GeometrySampler *sampler;
+  static vector<pair<G4String, G4double>> importances;
+};
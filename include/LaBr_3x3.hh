@@ -45,9 +45,28 @@ class LaBr_3x3 : public Detector {
   void useFilterCase() { use_filter_case = true; };
   void useFilterCaseRing() { use_filter_case_ring = true; };
   void useHousing() { use_housing = true; };
+  // Forget the shared models, whose volumes are deleted when the geometry is rebuilt (see SharedVolumes.hh)
+  static void Clear_Models() { models.clear(); };
 
   private:
   bool use_filter_case;
   bool use_filter_case_ring;
   bool use_housing;
+
+  // Material, solids and passive logical volumes which are the same for all LaBr_3x3 detectors.
+  // They are constructed only once (separately for detectors with and without housing) and shared
+  // by all placements. The crystal, which carries the sensitive detector, and its mother volumes
+  // get their own logical volumes for each detector, but share the solids.
+  struct Model {
+    bool with_housing;
+
+    G4Material *crystal_material;
+    G4VSolid *crystal_housing_solid;
+    G4VSolid *vacuum_solid;
+    G4VSolid *crystal_solid;
+    G4LogicalVolume *circuit_housing_1_logical;
+    G4LogicalVolume *circuit_housing_2_logical;
+    G4LogicalVolume *circuit_housing_3_and_pmt_logical;
+  };
+  static vector<Model> models;
 };
@@ -19,8 +19,25 @@ along with utr.  If not, see <http://www.gnu.org/licenses/>.
 */
 #pragma once
 
+#include <cmath>
+#include <utility>
+#include <vector>
+
 #include "G4SystemOfUnits.hh"
 
+#include "utrConfig.h"
+
+using std::pair;
+using std::vector;
+
+// Reduces the number of z planes of a polycone which has been sampled at nsteps points.
+// The simplification follows the Ramer-Douglas-Peucker algorithm: starting from the first and the
+// last plane, the plane whose inner or outer radius deviates most from the linear interpolation
+// between the planes kept so far is added, until no plane deviates by more than the tolerance.
+// Since G4Polycone interpolates linearly between its planes, the deviation is measured in radial
+// direction at constant z. A tolerance of zero only removes planes which lie exactly on a straight
+// line, i.e. the result is at least as accurate as the input.
+
 class OptimizePolycone {
 
   public:
@@ -28,50 +45,96 @@ class OptimizePolycone {
 
   G4int Optimize(double *zPlane, double *rInner, double *rOuter,
                  double *zPlaneOpt, double *rInnerOpt, double *rOuterOpt,
-                 int nsteps, G4String PolyconeName) {
-
-    G4double last_ri = rInner[0];
-    G4double last_ro = rOuter[0];
-
-    zPlaneOpt[0] = zPlane[0];
-    rInnerOpt[0] = last_ri;
-    rOuterOpt[0] = last_ro;
-
-    G4int nsteps_optimized = 1;
-
-    for (int i = 1; i < nsteps - 1; i++) {
-      if (rInner[i] != last_ri || rOuter[i] != last_ro) {
-        zPlaneOpt[nsteps_optimized] = zPlane[i - 1];
-        rInnerOpt[nsteps_optimized] = rInner[i - 1];
-        rOuterOpt[nsteps_optimized] = rOuter[i - 1];
-
-        zPlaneOpt[nsteps_optimized + 1] = zPlane[i];
-        rInnerOpt[nsteps_optimized + 1] = rInner[i];
-        rOuterOpt[nsteps_optimized + 1] = rOuter[i];
-
-        last_ri = rInner[i];
-        last_ro = rOuter[i];
+                 int nsteps, G4String PolyconeName, G4double tolerance = polycone_tolerance * mm) {
+
+    vector<bool> keep(nsteps, false);
+    keep[0] = true;
+    keep[nsteps - 1] = true;
+
+    // Explicit stack of the intervals which still need to be checked, to avoid deep recursion
+    vector<pair<int, int>> intervals;
+    intervals.push_back(pair<int, int>(0, nsteps - 1));
+
+    G4double max_deviation = 0.;
+    G4double deviation;
+    int max_index;
+    while (!intervals.empty()) {
+      int first = intervals.back().first;
+      int last = intervals.back().second;
+      intervals.pop_back();
+
+      max_deviation = 0.;
+      max_index = -1;
+      for (int i = first + 1; i < last; i++) {
+        deviation = fmax(Deviation(zPlane, rInner, first, last, i), Deviation(zPlane, rOuter, first, last, i));
+        if (deviation > max_deviation) {
+          max_deviation = deviation;
+          max_index = i;
+        }
+      }
 
-        nsteps_optimized += 2;
+      if (max_index >= 0 && max_deviation > tolerance) {
+        keep[max_index] = true;
+        intervals.push_back(pair<int, int>(first, max_index));
+        intervals.push_back(pair<int, int>(max_index, last));
       }
     }
 
-    zPlaneOpt[nsteps_optimized] = zPlane[nsteps - 1];
-    rInnerOpt[nsteps_optimized] = rInner[nsteps - 1];
-    rOuterOpt[nsteps_optimized] = rOuter[nsteps - 1];
-
-    nsteps_optimized++;
+    // Copy the remaining planes and determine the largest deviation of the removed ones
+    G4int nsteps_optimized = 0;
+    int last_kept = 0;
+    max_deviation = 0.;
+    for (int i = 0; i < nsteps; i++) {
+      if (keep[i]) {
+        zPlaneOpt[nsteps_optimized] = zPlane[i];
+        rInnerOpt[nsteps_optimized] = rInner[i];
+        rOuterOpt[nsteps_optimized] = rOuter[i];
+        nsteps_optimized++;
+
+        for (int j = last_kept + 1; j < i; j++) {
+          deviation = fmax(Deviation(zPlane, rInner, last_kept, i, j), Deviation(zPlane, rOuter, last_kept, i, j));
+          if (deviation > max_deviation) {
+            max_deviation = deviation;
+          }
+        }
+        last_kept = i;
+      }
+    }
 
     G4double reductionfactor =
         (1. - (double)nsteps_optimized / nsteps) * 100.;
-    G4double tolerance = (zPlane[nsteps - 1] - zPlane[0]) / nsteps;
+    G4double resolution = fabs(zPlane[nsteps - 1] - zPlane[0]) / (nsteps - 1);
 
     G4cout << "Polycone " << PolyconeName << " optimized." << G4endl;
-    G4cout << "  Using " << reductionfactor
-           << " percent less points than uniform Polycone." << G4endl;
-    G4cout << "  Geometrical resolution: " << tolerance / mm << "mm"
+    G4cout << "  Using " << nsteps_optimized << " of " << nsteps << " planes ("
+           << reductionfactor << " percent less points than uniform Polycone)."
            << G4endl;
+    G4cout << "  Maximum radial deviation: " << max_deviation / um
+           << " um (tolerance: " << tolerance / um << " um)" << G4endl;
+    G4cout << "  Geometrical resolution of the sampling: " << resolution / mm
+           << "mm" << G4endl;
 
     return nsteps_optimized;
   }
+
+  private:
+  // Radial deviation of plane i from the line between the planes first and last
+  static G4double Deviation(const double *zPlane, const double *r, int first, int last, int i) {
+    G4double dz = zPlane[last] - zPlane[first];
+
+    // Jump of the radius at constant z: Only radii outside the interval deviate
+    if (dz == 0.) {
+      G4double r_min = r[first] < r[last] ? r[first] : r[last];
+      G4double r_max = r[first] < r[last] ? r[last] : r[first];
+      if (r[i] < r_min) {
+        return r_min - r[i];
+      }
+      if (r[i] > r_max) {
+        return r[i] - r_max;
+      }
+      return 0.;
+    }
+
+    return fabs(r[i] - (r[first] + (r[last] - r[first]) * (zPlane[i] - zPlane[first]) / dz));
+  }
 };
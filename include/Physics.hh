@@ -19,12 +19,38 @@ along with utr.  If not, see <http://www.gnu.org/licenses/>.
 */
 #pragma once
 
+#include <vector>
+
 #include "G4VModularPhysicsList.hh"
+#include "globals.hh"
 
 #include "utrConfig.h"
 
 class Physics : public G4VModularPhysicsList {
 
   public:
-  Physics();
+  // Comma-separated names of the EM, hadronic elastic and hadronic inelastic physics constructors,
+  // e.g. "livermore,extra", or "none". They are given by the --em, --elastic and --inelastic
+  // options of utr, the defaults by the EM_*, HADRON_ELASTIC_* and HADRON_INELASTIC_* build options.
+  struct Selection {
+    G4String em;
+    G4String elastic;
+    G4String inelastic;
+  };
+  static Selection Default_Selection();
+
+  // The macro file is only used by the EM physics "auto", which uses the polarized Livermore
+  // models only if the macro file sets a polarized beam
+  Physics(const Selection &selection = Default_Selection(), const G4String &macrofile = "");
+
+  // Sets the default cuts and creates the regions of the RegionManager
+  void SetCuts() override;
+
+  private:
+  static std::vector<G4String> Split(const G4String &list);
+  // True if the macro file, or a macro file executed by it, contains a nonzero /gps/polarization
+  static bool Uses_Polarized_Beam(const G4String &macrofile, unsigned int depth = 0);
+  void Register_EM(const G4String &name, const G4String &macrofile);
+  void Register_Hadron_Elastic(const G4String &name);
+  void Register_Hadron_Inelastic(const G4String &name);
 };
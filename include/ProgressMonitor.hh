@@ -0,0 +1,93 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "G4Threading.hh"
+#include "globals.hh"
+
+using std::vector;
+
+// Progress and throughput of the simulation, summed over all threads.
+//
+// Each thread counts its events in its own counter, which fills a whole cache line, so that the
+// EventActions of different threads never write to the same cache line and no atomic
+// read-modify-write operation is needed. A single reporter thread, which is started and stopped
+// by the RunAction of the master, reads the counters at a fixed wall-clock interval and prints
+// the number of events, the current and average event rates, the estimated remaining time and
+// the spread of the number of events between the threads. Inside a RunChain, the progress of the
+// whole chain is shown.
+// The reporter thread is not a Geant4 thread, whose G4cout is only set up by Geant4 (and is a null
+// pointer for other threads in Geant4 < 11), so it writes to std::cout directly.
+class ProgressMonitor {
+  public:
+  // Default: PROGRESS_INTERVAL, 0 switches the progress reports off
+  static void Set_Interval(G4double interval_in_seconds) { interval = interval_in_seconds; };
+
+  // Called by the EventAction of each thread at the end of an event
+  static void Count_Event() {
+    const size_t slot = G4Threading::G4GetThreadId() > 0 ? G4Threading::G4GetThreadId() : 0;
+    if (slot < counters.size()) {
+      // Only this thread writes to its counter, the relaxed load and store compile to plain moves
+      std::atomic<G4long> &events = counters[slot].events;
+      events.store(events.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    } else {
+      // Threads without an own counter, which should not exist, share one
+      overflow_events.fetch_add(1, std::memory_order_relaxed);
+    }
+  };
+
+  // Called by the RunAction of the master at the beginning and at the end of each run.
+  // Start() allocates one counter per thread of the run manager, whose number may have been changed by /run/numberOfThreads.
+  static void Start(G4long n_events_run);
+  static void Stop();
+
+  private:
+  static void Report_Loop();
+  static void Print(bool final);
+  static G4long Get_Counted_Events();
+
+  // alignas(64) instead of std::hardware_destructive_interference_size, which is not provided by all supported compilers
+  struct alignas(64) Counter {
+    std::atomic<G4long> events{0};
+  };
+  static vector<Counter> counters;
+  static std::atomic<G4long> overflow_events;
+
+  static G4double interval;
+
+  static G4long total_events;
+  static G4long start_offset;
+  static std::chrono::steady_clock::time_point start_time;
+  static G4long last_events;
+  static std::chrono::steady_clock::time_point last_time;
+
+  static std::thread reporter;
+  static std::mutex mutex;
+  static std::condition_variable stop_condition;
+  static G4bool stop_requested;
+};
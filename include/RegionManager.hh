@@ -0,0 +1,80 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <array>
+#include <utility>
+#include <vector>
+
+#include "G4LogicalVolume.hh"
+#include "G4Region.hh"
+#include "G4String.hh"
+
+using std::array;
+using std::pair;
+using std::vector;
+
+// Assigns production cuts to the logical volumes of the geometry according to their role in the
+// experiment. Fine cuts are only needed where the secondaries may reach a detector (sensitive
+// volumes, targets and materials close to the detectors like filters), while coarse cuts are
+// sufficient in the bulk shielding and the support structures. The roles are determined by:
+//   1. sensitive:  volumes which have a sensitive detector attached
+//   2. target, shielding: volumes whose names contain one of the patterns of the role (case-insensitive),
+//      or whose material is in the list of shielding materials
+//   3. structural: all other volumes, which are part of Geant4's default region
+// The regions are created by Physics::SetCuts() during /run/initialize, if they were enabled with /utr/regions/enable.
+// The cut of Geant4's default region is only changed if the cut of the structural role was set explicitly.
+class RegionManager {
+  public:
+  enum Role { sensitive,
+              target,
+              shielding,
+              structural,
+              n_roles };
+
+  static void Construct_Regions();
+  // Region of a role, which is created with the cut of the role if it does not exist yet.
+  // Used by other classes which need a region for the volumes of a role before the cuts are set.
+  static G4Region *Get_Region(Role role);
+
+  static bool Set_Cut(const G4String &role_name, G4double cut);
+  static bool Add_Volume(const G4String &role_name, const G4String &pattern);
+  static void Set_Enabled(bool enable) { enabled = enable; };
+  static bool Get_Enabled() { return enabled; };
+  static void Print();
+
+  static Role Classify(const G4LogicalVolume *logical_volume);
+  // Prints an error and returns false if the name is not one of the roles
+  static bool Find_Role(const G4String &role_name, Role &role);
+  static G4String Get_Role_Name(Role role) { return role_names[role]; };
+
+  private:
+  static void Apply_Cut(Role role);
+
+  static bool enabled;
+  static bool structural_cut_set;
+  static const array<G4String, n_roles> role_names;
+  static array<G4double, n_roles> cuts;
+  static array<unsigned int, n_roles> n_volumes;
+  // Patterns added by the user take precedence over the default ones
+  static vector<pair<G4String, Role>> user_patterns;
+  static const vector<pair<G4String, Role>> default_patterns;
+  static const vector<G4String> shielding_materials;
+};
@@ -0,0 +1,63 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "G4Event.hh"
+#include "globals.hh"
+
+// Response-matrix run mode (RESPONSE_MATRIX build option), which replaces loops over many runs
+// with monoenergetic primaries by a single run.
+//
+// The energy of the primary particles of each event is sampled uniformly from an energy range,
+// either continuously or from a grid with a fixed step. Instead of an ntuple, one 2D histogram
+// of the true primary energy versus the energy deposition is filled for each sensitive detector,
+// together with a 1D histogram of the number of primaries for each bin of the true energy, which
+// is needed to normalize the response matrices. Histograms are merged over all threads by Geant4
+// and written to the output file of the master thread.
+class ResponseMatrix {
+  public:
+  static void Set_Energy_Range(G4double min, G4double max);
+  // Distance of the energies on the grid, a step of 0 samples the energies continuously (default)
+  static void Set_Energy_Step(G4double step);
+  // Width of the bins of the energy deposition, and of the true energy if it is sampled continuously (default: 10 keV)
+  static void Set_Bin_Width(G4double width);
+
+  // Called by the RunAction of each thread before the output file is opened
+  static void Create_Histograms();
+  // Called by the primary generator after the primary vertices have been generated
+  static void Sample_Primary_Energy(G4Event *event);
+  // Called by the EventAction at the end of each event
+  static void Fill_Primary(const G4Event *event);
+  // Called by the EnergyDepositionSD for each detector with a nonzero energy deposition in the current event
+  static void Fill(unsigned int detector_id, G4double energy_deposition, G4double weight);
+
+  private:
+  static G4double Get_True_Energy(const G4Event *event);
+
+  static G4double energy_min;
+  static G4double energy_max;
+  static G4double energy_step;
+  static G4double bin_width;
+
+  static G4ThreadLocal G4int primaries_id;
+  static G4ThreadLocal G4int first_matrix_id;
+  static G4ThreadLocal unsigned int n_matrices;
+};
@@ -38,7 +38,9 @@ enum output_flags : short {
   MOMX = 8,
   MOMY = 9,
   MOMZ = 10,
-  NFLAGS = 11
+  WEIGHT = 11,
+  COPY = 12,
+  NFLAGS = 13
 };
 
 class RunAction : public G4UserRunAction {
@@ -50,4 +52,11 @@ class RunAction : public G4UserRunAction {
   virtual void EndOfRunAction(const G4Run *);
 
   G4String GetOutputFlagName(unsigned int n);
+
+  private:
+  // In multithreaded mode, each worker thread writes its own output file, and the master thread only needs one if histograms are merged into it
+  static G4bool MasterWritesOutput();
+
+  // The output file stays open between the sub-runs of a RunChain
+  G4bool outputOpen;
 };
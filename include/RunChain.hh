@@ -0,0 +1,77 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "globals.hh"
+
+#include "Sharding.hh"
+
+// Chain of runs for more events than a single /run/beamOn can simulate, started by /utr/beamOn64.
+//
+// The events are simulated in sub-runs of at most max_events_per_run events without a
+// re-initialization. All sub-runs write to the same output files, which are only closed by the
+// RunAction after the last sub-run. The event IDs in the output files and the progress are counted
+// over the whole chain with 64 bits. Each event is seeded with its own MixMax stream (see Sharding),
+// so the random numbers of an event only depend on the master seed, the shard and the index of
+// the event in the chain, but not on the size of the sub-runs.
+//
+// With checkpoints, the sub-runs have the checkpoint size instead, and the output files are closed
+// after each sub-run, i.e. each checkpoint gets its own set of output files. A manifest with the
+// seeds and the number of completed events is written after each sub-run. A chain which was
+// interrupted, e.g. by the preemption of a cluster node, can be resumed from the manifest with the
+// --resume option of utr: The same /utr/beamOn64 command then skips the completed sub-runs and
+// reproduces exactly the remaining ones.
+class RunChain {
+  public:
+  static void BeamOn(G4long n_events);
+
+  // Number of events per checkpoint, 0 switches the checkpoints off (default)
+  static void Set_Checkpoint_Events(G4long n_events) { checkpoint_events = n_events; };
+  // Default: <output directory>/<filename prefix>.checkpoint
+  static void Set_Manifest(const G4String &filename) { manifest_filename = filename; };
+  // Read a manifest before the random number engine is seeded, returns false if it is invalid
+  static bool Resume(const G4String &filename);
+
+  // True during all but the last sub-run of a chain without checkpoints, i.e. the output files must stay open at the end of the run
+  static bool Keeps_Output_Open() { return n_events_left > 0 && checkpoint_events == 0; };
+  // Number of events of the chain, 0 if no chain is running
+  static G4long Get_Total_Events() { return total_events; };
+  // Number of events in the previous sub-runs of the chain
+  static G4long Get_Event_Offset() { return event_offset; };
+  // Event ID which is unique in the whole chain and all shards
+  static G4double Global_Event_ID(G4int event_id) { return Sharding::Get_Event_ID_Offset() + event_offset + event_id; };
+
+  static const G4int max_events_per_run = 1000000000;
+
+  private:
+  static G4String Get_Manifest();
+  static void Write_Manifest();
+
+  static G4long total_events;
+  static G4long event_offset;
+  static G4long n_events_left;
+
+  static G4long checkpoint_events;
+  static G4String manifest_filename;
+  static G4long resume_total_events;
+  static G4long resume_checkpoint_events;
+  static G4long resume_completed_events;
+};
@@ -0,0 +1,82 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "globals.hh"
+
+// Seeding of the random number engine for one logical simulation which is split into several
+// independent processes (shards), e.g. on different nodes.
+//
+// The master thread uses a MixMax engine, whose seeds (master seed, shard index) select one of
+// the MixMax streams which are guaranteed not to overlap. The seeds which the run manager draws
+// from the master engine for each event are not used, since two 32 bit values drawn at random
+// repeat after about 10^8 to 10^9 events. Instead, the primary generator reseeds the engine of
+// its thread at the beginning of each event with the stream selected by (master seed, shard, run,
+// index of the event in the run or RunChain), so all events of all shards use independent streams
+// without any coordination between the processes, independent of the number of threads.
+// The master seed must fit into 32 bits, the shard index and the index of the run are used with 16 bits each.
+// The event IDs in the output files are shifted by shard * 2^40, which is larger than the number
+// of events of any realistic simulation, so that the event IDs of merged outputs are unique. Since
+// they are stored as doubles, which are exact up to 2^53, there can be at most 2^13 = 8192 shards.
+class Sharding {
+  public:
+  // Parses "<i>/<n>", returns false if it is invalid
+  static bool Set_Shard(const G4String &shard);
+  // Returns false if the seed does not fit into 32 bits
+  static bool Set_Master_Seed(G4long seed) {
+    if (seed < 0 || seed > max_master_seed) {
+      return false;
+    }
+    master_seed = seed;
+    master_seed_set = true;
+    return true;
+  };
+  // Sets the random number engine, with a master seed from the time and process ID if none was given
+  static void Seed_Engine();
+  // Selects a new stream of the master engine for each sub-run of a RunChain
+  static void Reseed(G4long sub_run);
+  // Called by the RunAction of the master at the beginning of each run, and by RunChain::BeamOn once for the whole chain
+  static void Next_Run() { ++run_index; };
+  // Called by the primary generator of each thread before any random number of the event is used
+  static void Seed_Event(G4int event_id);
+
+  // True if --seed or --shard was given, only then the metadata ntuple is written
+  static bool Is_Used() { return master_seed_set || n_shards > 1; };
+  static G4long Get_Master_Seed() { return master_seed; };
+  static G4long Get_Shard_Index() { return shard_index; };
+  static G4long Get_Number_Of_Shards() { return n_shards; };
+  static G4double Get_Event_ID_Offset() { return shard_index * 1099511627776.; };
+
+  static const G4long max_master_seed = 0xffffffffL;
+  static const G4long max_shards = 8192;
+
+  // Called by the RunAction of each thread before and after the output file is opened
+  static void Create_Metadata_Ntuple();
+  static void Fill_Metadata_Ntuple();
+
+  private:
+  static G4long master_seed;
+  static G4bool master_seed_set;
+  static G4long shard_index;
+  static G4long n_shards;
+  static G4long run_index;
+  static G4ThreadLocal G4int metadata_ntuple_id;
+};
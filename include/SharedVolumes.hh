@@ -0,0 +1,50 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "G4VPhysicalVolume.hh"
+#include "G4VUserDetectorConstruction.hh"
+
+// Several classes keep static caches of the solids, logical volumes and rotation matrices which they
+// share between all their instances, e.g. the detector models of HPGe_Coaxial. The Geant4 stores
+// own these objects and delete them when the geometry is rebuilt (/run/reinitializeGeometry), so
+// the caches must not outlive a single construction of the geometry. Clear() forgets all of them.
+class SharedVolumes {
+  public:
+  static void Clear();
+};
+
+// Wrapper around the DetectorConstruction of a setup, which clears the caches of shared volumes
+// before every construction of the geometry.
+class SharedVolumesDetectorConstruction : public G4VUserDetectorConstruction {
+  public:
+  SharedVolumesDetectorConstruction(G4VUserDetectorConstruction *detector_construction) : detector_construction(detector_construction){};
+  ~SharedVolumesDetectorConstruction() { delete detector_construction; };
+
+  G4VPhysicalVolume *Construct() override {
+    SharedVolumes::Clear();
+    return detector_construction->Construct();
+  };
+  void ConstructSDandField() override { detector_construction->ConstructSDandField(); };
+
+  private:
+  G4VUserDetectorConstruction *detector_construction;
+};
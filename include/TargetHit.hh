@@ -47,6 +47,8 @@ class TargetHit : public G4VHit {
   void SetEventID(G4int id) { eventID = id; };
   void SetPosition(G4ThreeVector p) { pos = p; };
   void SetMomentum(G4ThreeVector momentum) { mom = momentum; };
+  void SetWeight(G4double w) { weight = w; };
+  void SetCopyID(G4int id) { copyID = id; };
 
   G4double GetKineticEnergy() { return ekin; };
   G4double GetEnergyDeposition() { return edep; };
@@ -55,6 +57,8 @@ class TargetHit : public G4VHit {
   G4int GetEventID() { return eventID; };
   G4ThreeVector GetPosition() { return pos; };
   G4ThreeVector GetMomentum() { return mom; };
+  G4double GetWeight() { return weight; };
+  G4int GetCopyID() { return copyID; };
 
   private:
   G4double ekin;
@@ -64,6 +68,8 @@ class TargetHit : public G4VHit {
   G4int eventID;
   G4ThreeVector pos;
   G4ThreeVector mom;
+  G4double weight;
+  G4int copyID;
 };
 
 typedef G4THitsCollection<TargetHit> TargetHitsCollection;
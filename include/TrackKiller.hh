@@ -0,0 +1,91 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <array>
+#include <unordered_map>
+
+#include "G4LogicalVolume.hh"
+#include "G4ThreeVector.hh"
+#include "G4Track.hh"
+#include "globals.hh"
+
+#include "RegionManager.hh"
+
+using std::array;
+using std::unordered_map;
+
+// Configuration and statistics of the track-killing policies, which are applied by the
+// StackingAction and the SteppingAction:
+//   - Charged secondaries are killed when they are created with a kinetic energy below a
+//     threshold, which is set for each volume role of the RegionManager (default: 0, i.e. off).
+//   - Any particle is killed when it leaves a region of interest (ROI), a box or a sphere
+//     around the setup (default: no ROI).
+// The numbers of killed tracks and their kinetic energies are summed over all threads and printed at the end of each run.
+class TrackKiller {
+  public:
+  enum ROI_Shape { none,
+                   box,
+                   sphere };
+
+  static void Set_Threshold(RegionManager::Role role, G4double threshold);
+  static G4double Get_Threshold(RegionManager::Role role) { return thresholds[role]; };
+  static void Set_ROI_Box(G4ThreeVector half_lengths);
+  static void Set_ROI_Sphere(G4double radius);
+  static void Set_ROI_Center(G4ThreeVector center) { roi_center = center; };
+  static void Remove_ROI() { roi_shape = none; };
+
+  // Used by the StackingAction for new secondaries
+  static bool Below_Threshold(const G4Track *track);
+  // Used by the SteppingAction, true if a step went from the inside of the ROI to the outside
+  static bool Leaves_ROI(const G4ThreeVector &pre_step_position, const G4ThreeVector &post_step_position) {
+    return roi_shape != none && Inside_ROI(pre_step_position) && !Inside_ROI(post_step_position);
+  };
+  static void Count_ROI_Kill(G4double kinetic_energy);
+
+  // Add the statistics of the current thread to the total (called by each RunAction at the end of a run)
+  static void Merge();
+  static void Reset();
+  static void Print();
+
+  private:
+  static bool Inside_ROI(const G4ThreeVector &position);
+  static RegionManager::Role Get_Role(const G4LogicalVolume *logical_volume);
+
+  static array<G4double, RegionManager::n_roles> thresholds;
+  static G4bool any_threshold;
+
+  static ROI_Shape roi_shape;
+  static G4ThreeVector roi_center;
+  static G4ThreeVector roi_half_lengths;
+  static G4double roi_radius;
+
+  struct Statistics {
+    array<G4long, RegionManager::n_roles> threshold_kills;
+    array<G4double, RegionManager::n_roles> threshold_energy;
+    G4long roi_kills;
+    G4double roi_energy;
+    void Add(const Statistics &other);
+  };
+  static G4ThreadLocal Statistics *thread_statistics;
+  static Statistics total_statistics;
+  // Roles of the logical volumes, cached because the classification compares strings
+  static G4ThreadLocal unordered_map<const G4LogicalVolume *, RegionManager::Role> *roles;
+};
@@ -0,0 +1,57 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "G4UserWorkerInitialization.hh"
+#include "globals.hh"
+
+using std::vector;
+
+// Pins each worker thread to a CPU core or to the cores of a NUMA node (--pin option of utr).
+//
+// By default, the operating system may move the worker threads between the cores and between
+// the sockets of a machine. Pinning keeps the caches of a thread warm and, since Linux places a
+// memory page on the NUMA node of the thread which touches it first, it also keeps the
+// thread-local memory of a worker on its own node: the G4Allocator pools of the hits, tracks and
+// touchables and the per-thread malloc arenas of glibc. The threads are pinned in
+// WorkerInitialize, before a worker allocates any of its own memory. The threads are distributed
+// round-robin over the cores or NUMA nodes which the process is allowed to use (e.g. with taskset
+// or by a batch system).
+class WorkerInitialization : public G4UserWorkerInitialization {
+  public:
+  enum Pinning { none,
+                 core,
+                 node };
+
+  // Parses "none", "core" or "node", returns false if the mode is unknown
+  static bool Set_Pinning(const G4String &mode);
+  static Pinning Get_Pinning() { return pinning; };
+
+  virtual void WorkerInitialize() const override;
+
+  private:
+  // CPU sets to which the threads are assigned, one per core or one per NUMA node
+  static vector<vector<int>> Get_CPU_Sets();
+
+  static Pinning pinning;
+};
@@ -39,9 +39,10 @@ class utrFilenameTools {
   static unsigned int incrementFilenameID() { return ++filenameID; };
   static void setUseFilenameID(unsigned int ufid) { useFilenameID = ufid; };
   static bool getUseFilenameID() { return useFilenameID; };
-  static unsigned int findNextFreeFilenameID();
-  static string getMasterFilename();
-  static void deleteMasterFilename();
+  static unsigned int findNextFreeFilenameID(); // Single scan of the output directory, the ID after the highest existing one
+  static void reserveNextFilenameID(); // Increments the file ID and reserves it atomically for the run of this process
+  static void releaseFilenameID(); // Removes the reservation after the output files of the run were closed
+  static string createMasterFile(); // Creates '{outputDir}/{filenamePrefix}N.root' atomically and returns its name, aborts if it already exists
 
   private:
   // statics are set as statics here so they are shared and available to all threads
@@ -50,5 +51,7 @@ class utrFilenameTools {
   static string filenamePrefix;
   static unsigned int filenameID;
   static bool useFilenameID;
-  static string masterFilename;
+  static string reservationFilename;
+
+  static unsigned int scanNextFreeFilenameID();
 };
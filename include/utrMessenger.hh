@@ -19,8 +19,12 @@ along with utr.  If not, see <http://www.gnu.org/licenses/>.
 */
 #pragma once
 
+#include "G4UIcmdWith3VectorAndUnit.hh"
 #include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
 #include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithoutParameter.hh"
 #include "G4UIcommand.hh"
 #include "G4UIdirectory.hh"
 #include "G4UImessenger.hh"
@@ -42,4 +46,50 @@ class utrMessenger : public G4UImessenger {
   G4UIcmdWithAString *setFilenameCmd;
   G4UIcmdWithABool *setUseFilenameIDCmd;
   G4UIcmdWithAString *appendZerosToVarCmd;
+  G4UIcmdWithAString *beamOn64Cmd;
+
+  G4UIdirectory *checkpointDirectory;
+  G4UIcmdWithAnInteger *setCheckpointEventsCmd;
+  G4UIcmdWithAString *setCheckpointManifestCmd;
+
+  G4UIdirectory *sweepDirectory;
+  G4UIcmdWithAString *setSweepEnergiesCmd;
+  G4UIcommand *setSweepRangeCmd;
+  G4UIcmdWithAString *sweepBeamOnCmd;
+
+  G4UIdirectory *progressDirectory;
+  G4UIcmdWithADoubleAndUnit *setProgressIntervalCmd;
+
+  G4UIdirectory *geometryDirectory;
+  G4UIcmdWithAString *exportGeometryCmd;
+
+  G4UIdirectory *regionsDirectory;
+  G4UIcmdWithABool *enableRegionsCmd;
+  G4UIcommand *setRegionCutCmd;
+  G4UIcommand *addRegionVolumeCmd;
+  G4UIcmdWithoutParameter *printRegionsCmd;
+
+  G4UIdirectory *killDirectory;
+  G4UIcommand *setKillThresholdCmd;
+  G4UIcmdWith3VectorAndUnit *setROIBoxCmd;
+  G4UIcmdWithADoubleAndUnit *setROISphereCmd;
+  G4UIcmdWith3VectorAndUnit *setROICenterCmd;
+  G4UIcmdWithoutParameter *removeROICmd;
+
+  G4UIdirectory *biasingDirectory;
+  G4UIcommand *setImportanceCmd;
+  G4UIcmdWithAString *forceCollisionCmd;
+  G4UIcmdWithAString *splitInVolumeCmd;
+  G4UIcmdWithAnInteger *setSplittingFactorCmd;
+
+  G4UIdirectory *fastsimDirectory;
+  G4UIcmdWithAString *calibrateResponseCmd;
+  G4UIcmdWithADoubleAndUnit *setResponseBinWidthCmd;
+  G4UIcmdWithAString *readResponseCmd;
+  G4UIcommand *useResponseCmd;
+
+  G4UIdirectory *responseMatrixDirectory;
+  G4UIcommand *setResponseMatrixRangeCmd;
+  G4UIcmdWithADoubleAndUnit *setResponseMatrixStepCmd;
+  G4UIcmdWithADoubleAndUnit *setResponseMatrixBinWidthCmd;
 };
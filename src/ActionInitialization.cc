@@ -32,11 +32,12 @@ along with utr.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "EventAction.hh"
 #include "RunAction.hh"
+#include "StackingAction.hh"
+#include "SteppingAction.hh"
 
 using std::vector;
 
-ActionInitialization::ActionInitialization() : G4VUserActionInitialization(),
-                                               n_threads(1) {}
+ActionInitialization::ActionInitialization() : G4VUserActionInitialization() {}
 
 ActionInitialization::~ActionInitialization() {}
 
@@ -53,11 +54,10 @@ void ActionInitialization::Build() const {
   SetUserAction(new GeneralParticleSource);
 #endif
 
-  EventAction *eventAction = new EventAction();
-#ifdef G4MULTITHREADED
-  eventAction->setNThreads(n_threads);
-#endif
-  SetUserAction(eventAction);
+  SetUserAction(new EventAction);
+
+  SetUserAction(new StackingAction);
+  SetUserAction(new SteppingAction);
 
   RunAction *runAction = new RunAction();
 
@@ -98,12 +98,18 @@ void ActionInitialization::Build() const {
 #ifdef EVENT_MOMZ
   record_quantity[MOMZ] = true;
 #endif
+#ifdef EVENT_WEIGHT
+  record_quantity[WEIGHT] = true;
+  record_quantity[COPY] = true;
+#endif
 
   if (G4Threading::G4GetThreadId() == 0) {
     G4cout << "================================================================"
               "================"
            << G4endl;
-#ifdef EVENT_EVENTWISE
+#ifdef RESPONSE_MATRIX
+    G4cout << "ActionInitialization: Response matrices (true primary energy vs. EDEP) will be saved to the output file" << G4endl;
+#elif defined EVENT_EVENTWISE
     G4cout << "ActionInitialization: EDEP will be saved to the output file in EVENTWISE mode" << G4endl;
 #else
     G4cout << "ActionInitialization: The following quantities will be saved to "
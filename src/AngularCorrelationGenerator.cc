@@ -30,6 +30,7 @@ along with utr.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "AngularCorrelationGenerator.hh"
 #include "AngularCorrelationMessenger.hh"
+#include "Sharding.hh"
 
 AngularCorrelationGenerator::AngularCorrelationGenerator()
     : G4VUserPrimaryGeneratorAction(), particleGun(0),
@@ -55,6 +56,7 @@ AngularCorrelationGenerator::~AngularCorrelationGenerator() {
 }
 
 void AngularCorrelationGenerator::GeneratePrimaries(G4Event *anEvent) {
+  Sharding::Seed_Event(anEvent->GetEventID());
 
 #ifdef CHECK_POSITION_GENERATOR
   check_position_generator();
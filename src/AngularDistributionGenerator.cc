@@ -30,6 +30,8 @@ along with utr.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "AngularDistributionGenerator.hh"
 #include "AngularDistributionMessenger.hh"
+#include "EnergySweep.hh"
+#include "Sharding.hh"
 
 #define MAX_ALLOWED_FAIL_CHANCE 1e-6
 
@@ -51,6 +53,7 @@ AngularDistributionGenerator::~AngularDistributionGenerator() {
 }
 
 void AngularDistributionGenerator::GeneratePrimaries(G4Event *anEvent) {
+  Sharding::Seed_Event(anEvent->GetEventID());
   particleGun->SetParticleDefinition(particleDefinition);
   particleGun->SetParticleEnergy(particleEnergy);
 
@@ -131,6 +134,9 @@ void AngularDistributionGenerator::GeneratePrimaries(G4Event *anEvent) {
     G4cout << "Warning: AngularDistributionGenerator: Monte-Carlo method could not determine a starting velocity vector after " << MAX_TRIES_MOMENTUM << " iterations" << G4endl;
 
   particleGun->GeneratePrimaryVertex(anEvent);
+  if (EnergySweep::Is_Active()) {
+    EnergySweep::Set_Primary_Energy(anEvent);
+  }
 }
 
 void AngularDistributionGenerator::check_momentum_generator() {
@@ -0,0 +1,69 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "BiasedCopies.hh"
+
+G4ThreadLocal G4int BiasedCopies::n_copies = 0;
+
+G4int BiasedCopies::Get_Copy_ID(const G4Track *track) {
+  const BiasedCopyInformation *information = static_cast<const BiasedCopyInformation *>(track->GetUserInformation());
+  return information ? information->Get_Copy_ID() : 0;
+}
+
+void BiasedCopies::New_Copy(G4Track *track) { Set_Copy_ID(track, ++n_copies); }
+
+void BiasedCopies::Join_Copy(G4Track *secondary, const G4Track *parent) { Set_Copy_ID(secondary, Get_Copy_ID(parent)); }
+
+void BiasedCopies::Set_Copy_ID(G4Track *track, G4int copy_id) {
+  // The track owns its information, which is deleted together with the track
+  BiasedCopyInformation *information = static_cast<BiasedCopyInformation *>(track->GetUserInformation());
+  if (information) {
+    information->Set_Copy_ID(copy_id);
+  } else {
+    track->SetUserInformation(new BiasedCopyInformation(copy_id));
+  }
+}
+
+void BiasedCopies::Update(const G4Step *step) {
+  G4Track *track = step->GetTrack();
+  const G4double weight_before = step->GetPreStepPoint()->GetWeight();
+  const G4int copy_id_before = Get_Copy_ID(track);
+
+  if (track->GetWeight() != weight_before) {
+    New_Copy(track);
+  }
+
+  for (auto secondary : *step->GetSecondaryInCurrentStep()) {
+    if (secondary->GetUserInformation()) {
+      continue;
+    }
+    // The secondaries are only handed to the stack after the stepping action, so they can still be modified
+    G4Track *new_track = const_cast<G4Track *>(secondary);
+    if (secondary->GetWeight() == weight_before) {
+      if (copy_id_before != 0) {
+        Set_Copy_ID(new_track, copy_id_before);
+      }
+    } else if (secondary->GetWeight() == track->GetWeight() && secondary->GetDefinition() != track->GetDefinition()) {
+      Join_Copy(new_track, track);
+    } else {
+      New_Copy(new_track);
+    }
+  }
+}
@@ -0,0 +1,156 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+
+#include "G4PhysicalConstants.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4Threading.hh"
+#include "G4UnitsTable.hh"
+#include "G4VSolid.hh"
+#include "G4VisExtent.hh"
+
+#include "BiasingDetectorConstruction.hh"
+#include "utrConfig.h"
+
+#ifdef FORCED_COLLISION
+#include "G4BOptrForceCollision.hh"
+#endif
+
+#ifdef DIRECTIONAL_SPLITTING
+#include "DirectionalSplitting.hh"
+#endif
+
+vector<G4String> BiasingDetectorConstruction::forced_collision_volumes = vector<G4String>();
+vector<G4String> BiasingDetectorConstruction::splitting_volumes = vector<G4String>();
+G4int BiasingDetectorConstruction::splitting_factor = 10;
+
+BiasingDetectorConstruction::~BiasingDetectorConstruction() {
+  delete detector_construction;
+}
+
+G4VPhysicalVolume *BiasingDetectorConstruction::Construct() {
+  world = detector_construction->Construct();
+  return world;
+}
+
+void BiasingDetectorConstruction::ConstructSDandField() {
+  detector_construction->ConstructSDandField();
+
+  vector<G4LogicalVolume *> biased_volumes;
+  Attach_Forced_Collision_Operators(biased_volumes);
+  Attach_Splitting_Operators(biased_volumes);
+}
+
+G4LogicalVolume *BiasingDetectorConstruction::Find_Logical_Volume(const G4String &physical_volume_name) {
+  for (auto physical_volume : *G4PhysicalVolumeStore::GetInstance()) {
+    if (physical_volume->GetName() == physical_volume_name) {
+      return physical_volume->GetLogicalVolume();
+    }
+  }
+  G4cerr << "Error: BiasingDetectorConstruction: Physical volume '" << physical_volume_name << "' not found." << G4endl;
+  throw std::exception();
+}
+
+void BiasingDetectorConstruction::Collect_Placements(G4VPhysicalVolume *volume, const G4ThreeVector &position, const G4RotationMatrix &rotation, vector<Placement> &placements) {
+  placements.push_back(Placement{volume, position});
+  G4LogicalVolume *logical_volume = volume->GetLogicalVolume();
+  for (size_t i = 0; i < logical_volume->GetNoDaughters(); ++i) {
+    G4VPhysicalVolume *daughter = logical_volume->GetDaughter(i);
+    Collect_Placements(daughter, position + rotation * daughter->GetTranslation(), rotation * daughter->GetObjectRotationValue(), placements);
+  }
+}
+
+void BiasingDetectorConstruction::Attach_Forced_Collision_Operators(vector<G4LogicalVolume *> &biased_volumes) {
+#ifdef FORCED_COLLISION
+  // The operator acts on a logical volume, i.e. on all of its placements.
+  for (auto name : forced_collision_volumes) {
+    G4LogicalVolume *logical_volume = Find_Logical_Volume(name);
+    if (std::find(biased_volumes.begin(), biased_volumes.end(), logical_volume) != biased_volumes.end()) {
+      continue;
+    }
+    biased_volumes.push_back(logical_volume);
+    G4BOptrForceCollision *force_collision = new G4BOptrForceCollision(forced_collision_particle, "ForceCollision_" + logical_volume->GetName());
+    force_collision->AttachTo(logical_volume);
+    if (G4Threading::IsMasterThread()) {
+      G4cout << "BiasingDetectorConstruction: Forcing collisions of '" << forced_collision_particle << "' in '" << logical_volume->GetName() << "'" << G4endl;
+    }
+  }
+#else
+  if (!forced_collision_volumes.empty()) {
+    G4cerr << "Error: utr was built without the FORCED_COLLISION option, so collisions cannot be forced." << G4endl;
+    throw std::exception();
+  }
+#endif
+}
+
+void BiasingDetectorConstruction::Attach_Splitting_Operators(vector<G4LogicalVolume *> &biased_volumes) {
+#ifdef DIRECTIONAL_SPLITTING
+  if (splitting_volumes.empty()) {
+    return;
+  }
+
+  // The directions of the detectors are determined from the global positions of the sensitive volumes
+  vector<Placement> placements;
+  Collect_Placements(world, G4ThreeVector(), G4RotationMatrix(), placements);
+
+  for (auto name : splitting_volumes) {
+    auto splitting_placement = std::find_if(placements.begin(), placements.end(), [&name](const Placement &placement) { return placement.physical_volume->GetName() == name; });
+    if (splitting_placement == placements.end()) {
+      G4cerr << "Error: BiasingDetectorConstruction: Physical volume '" << name << "' not found." << G4endl;
+      throw std::exception();
+    }
+    G4LogicalVolume *logical_volume = splitting_placement->physical_volume->GetLogicalVolume();
+    if (std::find(biased_volumes.begin(), biased_volumes.end(), logical_volume) != biased_volumes.end()) {
+      G4cerr << "Error: BiasingDetectorConstruction: '" << logical_volume->GetName() << "' is already biased by another operator." << G4endl;
+      throw std::exception();
+    }
+    biased_volumes.push_back(logical_volume);
+
+    DirectionalSplittingOperator *splitting = new DirectionalSplittingOperator(splitting_factor);
+    // Each cone contains the bounding sphere of a sensitive volume, as seen from any point of the bounding sphere of the splitting volume
+    const G4double splitting_radius = logical_volume->GetSolid()->GetExtent().GetExtentRadius();
+    G4int n_cones = 0;
+    for (auto placement : placements) {
+      G4LogicalVolume *detector_volume = placement.physical_volume->GetLogicalVolume();
+      if (!detector_volume->GetSensitiveDetector()) {
+        continue;
+      }
+      const G4ThreeVector direction = placement.position - splitting_placement->position;
+      const G4double radius = detector_volume->GetSolid()->GetExtent().GetExtentRadius() + splitting_radius;
+      const G4double half_angle = direction.mag() > radius ? std::asin(radius / direction.mag()) : pi;
+      splitting->Add_Cone(direction, half_angle);
+      ++n_cones;
+    }
+    splitting->AttachTo(logical_volume);
+
+    if (G4Threading::IsMasterThread()) {
+      G4cout << "BiasingDetectorConstruction: Splitting photons which scatter in '" << logical_volume->GetName() << "' by a factor of " << splitting_factor << " towards " << n_cones << " sensitive volumes" << G4endl;
+    }
+  }
+#else
+  if (!splitting_volumes.empty()) {
+    G4cerr << "Error: utr was built without the DIRECTIONAL_SPLITTING option, so photons cannot be split." << G4endl;
+    throw std::exception();
+  }
+#endif
+}
@@ -0,0 +1,112 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+
+#include "G4Material.hh"
+#include "G4MultiUnion.hh"
+#include "G4PVPlacement.hh"
+#include "G4Transform3D.hh"
+#include "G4VisAttributes.hh"
+
+#include "BrickWall.hh"
+#include "utrConfig.h"
+
+#ifdef MERGE_BRICK_WALLS
+G4bool BrickWall::merge = true;
+#else
+G4bool BrickWall::merge = false;
+#endif
+vector<G4ThreeVector> BrickWall::rotation_angles;
+vector<G4RotationMatrix *> BrickWall::rotations;
+
+void BrickWall::Add(G4LogicalVolume *brick_logical, G4String brick_name, G4RotationMatrix *rotation, G4ThreeVector position) {
+  if (!merge) {
+    new G4PVPlacement(rotation, position, brick_logical, brick_name, World_Logical, false, 0);
+    return;
+  }
+  Brick_Logicals.push_back(brick_logical);
+  Brick_Rotations.push_back(rotation);
+  Brick_Positions.push_back(position);
+}
+
+void BrickWall::Construct() {
+  if (!merge) {
+    return;
+  }
+
+  vector<G4Material *> materials;
+  for (auto brick_logical : Brick_Logicals) {
+    if (std::find(materials.begin(), materials.end(), brick_logical->GetMaterial()) == materials.end()) {
+      materials.push_back(brick_logical->GetMaterial());
+    }
+  }
+
+  for (auto material : materials) {
+    G4MultiUnion *Wall_Solid = new G4MultiUnion(Name + "_" + material->GetName() + "_Solid");
+    const G4VisAttributes *Wall_VisAttributes = nullptr;
+    for (size_t i = 0; i < Brick_Logicals.size(); ++i) {
+      if (Brick_Logicals[i]->GetMaterial() == material) {
+        // G4PVPlacement takes the inverse rotation of the placed volume, G4Transform3D the rotation itself
+        Wall_Solid->AddNode(*Brick_Logicals[i]->GetSolid(), G4Transform3D(Brick_Rotations[i] ? Brick_Rotations[i]->inverse() : G4RotationMatrix(), Brick_Positions[i]));
+        Wall_VisAttributes = Brick_Logicals[i]->GetVisAttributes();
+      }
+    }
+    Wall_Solid->Voxelize();
+
+    G4LogicalVolume *Wall_Logical = new G4LogicalVolume(Wall_Solid, material, Name + "_" + material->GetName() + "_Logical", 0, 0, 0);
+    if (Wall_VisAttributes) {
+      Wall_Logical->SetVisAttributes(Wall_VisAttributes);
+    }
+    new G4PVPlacement(0, G4ThreeVector(), Wall_Logical, Name + "_" + material->GetName(), World_Logical, false, 0);
+  }
+
+  G4cout << "BrickWall " << Name << ": Merged " << Brick_Logicals.size() << " bricks into " << materials.size() << " volume(s)" << G4endl;
+
+  Brick_Logicals.clear();
+  Brick_Rotations.clear();
+  Brick_Positions.clear();
+}
+
+G4RotationMatrix *BrickWall::Get_Rotation(G4double angle_x, G4double angle_y, G4double angle_z) {
+  const G4ThreeVector angles(angle_x, angle_y, angle_z);
+  for (size_t i = 0; i < rotation_angles.size(); ++i) {
+    if (rotation_angles[i] == angles) {
+      return rotations[i];
+    }
+  }
+
+  G4RotationMatrix *rot = new G4RotationMatrix();
+  rot->rotateX(angle_x);
+  rot->rotateY(angle_y);
+  rot->rotateZ(angle_z);
+
+  rotation_angles.push_back(angles);
+  rotations.push_back(rot);
+
+  return rot;
+}
+
+void BrickWall::Clear_Rotations() {
+  // The matrices are not deleted, because G4PVPlacement does not own its rotation, and the placements of the previous
+  // geometry are only deleted if it is destroyed explicitly.
+  rotation_angles.clear();
+  rotations.clear();
+}
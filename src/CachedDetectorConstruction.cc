@@ -0,0 +1,129 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <iomanip>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "G4Navigator.hh"
+#include "G4TransportationManager.hh"
+#include "G4Version.hh"
+#include "globals.hh"
+
+#include "CachedDetectorConstruction.hh"
+#include "GeometryPlugin.hh"
+#include "utrConfig.h"
+
+#ifdef WITH_GDML
+#include "G4GDMLParser.hh"
+#endif
+
+CachedDetectorConstruction::CachedDetectorConstruction(G4VUserDetectorConstruction *detector_construction, const G4String &cache_dir) : detector_construction(detector_construction), cache_dir(cache_dir) {}
+
+CachedDetectorConstruction::~CachedDetectorConstruction() {
+  delete detector_construction;
+}
+
+G4String CachedDetectorConstruction::Get_Cache_Filename() const {
+  // The key contains everything that changes the constructed geometry without changing the setup.
+  // Changes of the source code of a setup are not detected, so the cache has to be cleared after editing a geometry.
+  std::stringstream key;
+  key << GeometryPlugin::Get_Geometry_Name() << "|" << GeometryPlugin::Get_Geometry_Build_Options() << "|" << G4VERSION_NUMBER;
+
+  // 64 bit FNV-1a hash, which is independent of the compiler and the standard library in contrast to std::hash
+  uint64_t hash = 14695981039346656037ULL;
+  for (const char c : key.str()) {
+    hash = (hash ^ (unsigned char)c) * 1099511628211ULL;
+  }
+
+  std::stringstream filename;
+  filename << cache_dir << "/" << std::hex << std::setw(16) << std::setfill('0') << hash << ".gdml";
+  return filename.str();
+}
+
+G4VPhysicalVolume *CachedDetectorConstruction::Construct() {
+#ifdef WITH_GDML
+  const G4String cache_filename = Get_Cache_Filename();
+
+  struct stat buffer;
+  if (stat(cache_filename.c_str(), &buffer) == 0) {
+    G4cout << "CachedDetectorConstruction: Reading geometry of '" << GeometryPlugin::Get_Geometry_Name() << "' from " << cache_filename << G4endl;
+    G4GDMLParser parser;
+    // Schema validation is skipped, since the file has been written by utr itself
+    parser.Read(cache_filename, false);
+    return parser.GetWorldVolume();
+  }
+
+  G4VPhysicalVolume *world = detector_construction->Construct();
+
+  if (stat(cache_dir.c_str(), &buffer) != 0 && mkdir(cache_dir.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH) == -1) {
+    G4cerr << "Error: Could not create geometry cache directory '" << cache_dir << "'" << G4endl;
+    throw std::exception();
+  }
+  G4cout << "CachedDetectorConstruction: Writing geometry of '" << GeometryPlugin::Get_Geometry_Name() << "' to " << cache_filename << G4endl;
+  Write(cache_filename, world);
+  return world;
+#else
+  G4cerr << "Error: utr was built without the WITH_GDML option, so the geometry cannot be cached." << G4endl;
+  throw std::exception();
+#endif
+}
+
+void CachedDetectorConstruction::ConstructSDandField() {
+  detector_construction->ConstructSDandField();
+}
+
+void CachedDetectorConstruction::Export(const G4String &filename) {
+  G4VPhysicalVolume *world = G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume();
+  if (!world) {
+    G4cerr << "Error: The geometry has not been constructed yet. Run /run/initialize first." << G4endl;
+    return;
+  }
+  G4cout << "Exporting geometry to " << filename << G4endl;
+  Write(filename, world);
+}
+
+#ifdef WITH_GDML
+void CachedDetectorConstruction::Write(const G4String &filename, G4VPhysicalVolume *world) {
+  // G4GDMLParser refuses to overwrite files. The geometry is written to a temporary file first and then
+  // renamed, so that several utr processes which share a cache directory never read an incomplete file.
+  std::stringstream temporary_filename;
+  temporary_filename << filename << "." << getpid() << ".tmp.gdml";
+  std::remove(temporary_filename.str().c_str());
+
+  G4GDMLParser parser;
+  // The names are stored with their pointer addresses to make them unique. The addresses are stripped
+  // again when the file is read, so that the logical volumes can be found by name in ConstructSDandField().
+  parser.Write(temporary_filename.str(), world, true);
+
+  if (std::rename(temporary_filename.str().c_str(), filename.c_str()) != 0) {
+    G4cerr << "Error: Could not write GDML file '" << filename << "'" << G4endl;
+    std::remove(temporary_filename.str().c_str());
+  }
+}
+#else
+void CachedDetectorConstruction::Write(const G4String &, G4VPhysicalVolume *) {
+  G4cerr << "Error: utr was built without the WITH_GDML option, so the geometry cannot be exported." << G4endl;
+}
+#endif
@@ -31,6 +31,8 @@ using std::stringstream;
 
 #include "CeBr3_2x2.hh"
 
+CeBr3_2x2::Model *CeBr3_2x2::model = nullptr;
+
 void CeBr3_2x2::Construct(G4ThreeVector global_coordinates, G4double theta, G4double phi, G4double dist_from_center, G4double intrinsic_rotation_angle) const {
   /*********** Dimensions ***********/
 
@@ -82,9 +84,6 @@ void CeBr3_2x2::Construct(G4ThreeVector global_coordinates, G4double theta, G4do
   const G4String pmt_material = "G4_Al"; // Assumption
   const G4String magnetic_shielding_material = "G4_Al"; // Assumption (it is called 'magnetic shield' in the drawing)
   const G4String connector_material = "G4_Al"; // Assume that the connectors on top are made of the same material
-  auto *CeBr3 = new G4Material("CeBr3", 5.1 * g / cm3, 2); // Density from Wikipedia
-  CeBr3->AddElement(nist->FindOrBuildElement("Ce"), 1);
-  CeBr3->AddElement(nist->FindOrBuildElement("Br"), 3);
 
   /*********** Orientation in space ***********/
 
@@ -98,92 +97,94 @@ void CeBr3_2x2::Construct(G4ThreeVector global_coordinates, G4double theta, G4do
     rotation_matrix->rotateZ(intrinsic_rotation_angle);
   }
 
+  /*********** Shared model ***********/
+
+  // All CeBr3_2x2 detectors are identical, so the material, the solids and all passive logical volumes
+  // which do not contain the crystal are only constructed for the first detector.
+  if (model == nullptr) {
+    model = new Model();
+    const G4String model_name = "CeBr3_2x2_model";
+
+    // The material outlives the geometry, so it is only defined once, even if the geometry is rebuilt
+    model->crystal_material = G4Material::GetMaterial("CeBr3", false);
+    if (model->crystal_material == nullptr) {
+      model->crystal_material = new G4Material("CeBr3", 5.1 * g / cm3, 2); // Density from Wikipedia
+      model->crystal_material->AddElement(nist->FindOrBuildElement("Ce"), 1);
+      model->crystal_material->AddElement(nist->FindOrBuildElement("Br"), 3);
+    }
+
+    model->main_case_solid = new G4Tubs(model_name + "_main_case_solid", 0., main_case_outer_radius, main_case_length / 2., 0., twopi);
+    model->main_case_vacuum_solid = new G4Tubs(model_name + "_main_case_vacuum_solid", 0., main_case_inner_radius, main_case_inner_length / 2., 0., twopi);
+    model->crystal_solid = new G4Tubs(model_name + "_crystal_solid", 0., crystal_and_pmt_radius, crystal_length / 2., 0., twopi);
+
+    auto *pmt_solid = new G4Tubs(model_name + "_pmt_solid", crystal_and_pmt_radius - pmt_wall_thickness, crystal_and_pmt_radius, pmt_length / 2., 0., twopi);
+    model->pmt_logical = new G4LogicalVolume(pmt_solid, nist->FindOrBuildMaterial(pmt_material), model_name + "_pmt_logical");
+    model->pmt_logical->SetVisAttributes(G4Color::Blue());
+
+    auto *magnetic_shielding_solid = new G4Tubs(model_name + "_magnetic_shielding_solid", magnetic_shielding_inner_radius, magnetic_shielding_outer_radius, magnetic_shielding_length / 2., 0., twopi);
+    model->magnetic_shielding_logical = new G4LogicalVolume(magnetic_shielding_solid, nist->FindOrBuildMaterial(magnetic_shielding_material), model_name + "_magnetic_shielding_logical");
+    model->magnetic_shielding_logical->SetVisAttributes(G4Color(0.75, 0.75, 0.75));
+
+    auto *connector_base_solid = new G4Tubs(model_name + "_connector_base_solid", 0., connector_base_outer_radius, 0.5 * connector_base_length, 0., twopi);
+    model->connector_base_logical = new G4LogicalVolume(connector_base_solid, nist->FindOrBuildMaterial(connector_material), model_name + "_connector_base_logical");
+    model->connector_base_logical->SetVisAttributes(G4Color::Grey());
+
+    auto *connector_base_inside_solid = new G4Tubs(model_name + "_connector_base_inside_solid", 0., connector_base_outer_radius - connector_base_wall_thickness, connector_base_length / 2. - connector_base_wall_thickness, 0., twopi);
+    auto *connector_base_inside_logical = new G4LogicalVolume(connector_base_inside_solid, nist->FindOrBuildMaterial("G4_AIR"), model_name + "_connector_base_inside_logical"); // Assume it is filled predominantly with low-density material.
+    connector_base_inside_logical->SetVisAttributes(G4Color::White());
+    new G4PVPlacement(nullptr, G4ThreeVector(0, 0, 0), connector_base_inside_logical, model_name + "_connector_base_inside", model->connector_base_logical, 0, 0, false);
+
+    auto *connector_hv_solid = new G4Tubs(model_name + "_connector_hv_solid", 0., connector_hv_radius, 0.5 * connector_hv_length, 0., twopi);
+    model->connector_hv_logical = new G4LogicalVolume(connector_hv_solid, nist->FindOrBuildMaterial(connector_material), model_name + "_connector_hv_logical");
+    model->connector_hv_logical->SetVisAttributes(G4Color::Grey());
+
+    auto *connector_signal_solid = new G4Tubs(model_name + "_connector_signal_solid", 0., connector_signal_radius, 0.5 * connector_signal_length, 0., twopi);
+    model->connector_signal_logical = new G4LogicalVolume(connector_signal_solid, nist->FindOrBuildMaterial(connector_material), model_name + "_connector_signal_logical");
+    model->connector_signal_logical->SetVisAttributes(G4Color::Grey());
+  }
+
   /*********** Front ***********/
 
   // Main case, mother volume for all internals
 
-  auto *main_case_solid = new G4Tubs(detector_name + "_main_case_solid", 0., main_case_outer_radius, main_case_length / 2., 0., twopi);
-  auto *main_case_logical = new G4LogicalVolume(main_case_solid, nist->FindOrBuildMaterial(main_case_material), detector_name + "_main_case_logical");
+  auto *main_case_logical = new G4LogicalVolume(model->main_case_solid, nist->FindOrBuildMaterial(main_case_material), detector_name + "_main_case_logical");
   main_case_logical->SetVisAttributes(G4Color::Grey());
   new G4PVPlacement(rotation_matrix, global_coordinates + (dist_from_center + main_case_length / 2.) * e_r, main_case_logical, detector_name + "_main_case", world_Logical, 0, 0, false);
 
   // Main case vacuum mother volume for crystal and pmt, which are assumed to be sourounded by this vacuum
 
-  auto *main_case_vacuum_solid = new G4Tubs(detector_name + "_main_case_vacuum_solid", 0., main_case_inner_radius, main_case_inner_length / 2., 0., twopi);
-  auto *main_case_vacuum_logical = new G4LogicalVolume(main_case_vacuum_solid, nist->FindOrBuildMaterial("G4_Galactic"), detector_name + "_main_case_vacuum_logical");
+  auto *main_case_vacuum_logical = new G4LogicalVolume(model->main_case_vacuum_solid, nist->FindOrBuildMaterial("G4_Galactic"), detector_name + "_main_case_vacuum_logical");
   main_case_vacuum_logical->SetVisAttributes(G4Color(1., 1., 1., 0.75));
   new G4PVPlacement(nullptr, G4ThreeVector(0, 0, (main_case_entrance_window_thickness - main_case_wall_thickness) / 2.), main_case_vacuum_logical, detector_name + "_main_case_vacuum", main_case_logical, 0, 0, false);
 
   // Crystal
 
-  auto *crystal_solid = new G4Tubs(detector_name + "_crystal_solid", 0., crystal_and_pmt_radius, crystal_length / 2., 0., twopi);
-  auto *crystal_logical = new G4LogicalVolume(crystal_solid, CeBr3, detector_name);
+  auto *crystal_logical = new G4LogicalVolume(model->crystal_solid, model->crystal_material, detector_name);
   crystal_logical->SetVisAttributes(G4Color::Green());
   new G4PVPlacement(nullptr, G4ThreeVector(0, 0, -main_case_inner_length / 2. + crystal_to_entrance_window_gap + crystal_length / 2.), crystal_logical, detector_name + "_crystal", main_case_vacuum_logical, 0, 0, false);
 
   // PMT wall (PMT is a hollow cylinder here)
 
-  auto *pmt_solid = new G4Tubs(detector_name + "_pmt_solid", crystal_and_pmt_radius - pmt_wall_thickness, crystal_and_pmt_radius, pmt_length / 2., 0., twopi);
-  auto *pmt_logical = new G4LogicalVolume(pmt_solid, nist->FindOrBuildMaterial(pmt_material), detector_name + "_pmt_logical");
-  pmt_logical->SetVisAttributes(G4Color::Blue());
-  new G4PVPlacement(nullptr, G4ThreeVector(0, 0, main_case_inner_length / 2 - pmt_length / 2.), pmt_logical, detector_name + "_pmt", main_case_vacuum_logical, 0, 0, false);
+  new G4PVPlacement(nullptr, G4ThreeVector(0, 0, main_case_inner_length / 2 - pmt_length / 2.), model->pmt_logical, detector_name + "_pmt", main_case_vacuum_logical, 0, 0, false);
 
   // Magnetic shielding
 
-  auto *magnetic_shielding_solid = new G4Tubs(detector_name + "_magnetic_shielding_solid", magnetic_shielding_inner_radius, magnetic_shielding_outer_radius, magnetic_shielding_length / 2., 0., twopi);
-  auto *magnetic_shielding_logical = new G4LogicalVolume(magnetic_shielding_solid, nist->FindOrBuildMaterial(magnetic_shielding_material), detector_name + "_magnetic_shielding_logical");
-  magnetic_shielding_logical->SetVisAttributes(G4Color(0.75, 0.75, 0.75));
-  new G4PVPlacement(rotation_matrix, global_coordinates + (dist_from_center + magnetic_shielding_offset + magnetic_shielding_length / 2.) * e_r, magnetic_shielding_logical, detector_name + "_magnetic_shielding", world_Logical, 0, 0, false);
+  new G4PVPlacement(rotation_matrix, global_coordinates + (dist_from_center + magnetic_shielding_offset + magnetic_shielding_length / 2.) * e_r, model->magnetic_shielding_logical, detector_name + "_magnetic_shielding", world_Logical, 0, 0, false);
 
   // Connector base
 
-  auto *connector_base_solid = new G4Tubs(detector_name + "_connector_base_solid", 0., connector_base_outer_radius, 0.5 * connector_base_length, 0., twopi);
-  auto *connector_base_logical = new G4LogicalVolume(connector_base_solid, nist->FindOrBuildMaterial(connector_material), detector_name + "_connector_base_logical");
-  connector_base_logical->SetVisAttributes(G4Color::Grey());
-  new G4PVPlacement(rotation_matrix, global_coordinates + (dist_from_center + main_case_length + 0.5 * connector_base_length) * e_r, connector_base_logical, detector_name + "_connector_base", world_Logical, 0, 0, false);
-
-  auto *connector_base_inside_solid = new G4Tubs(detector_name + "_connector_base_inside_solid", 0., connector_base_outer_radius - connector_base_wall_thickness, connector_base_length / 2. - connector_base_wall_thickness, 0., twopi);
-  auto *connector_base_inside_logical = new G4LogicalVolume(connector_base_inside_solid, nist->FindOrBuildMaterial("G4_AIR"), detector_name + "_connector_base_inside_logical"); // Assume it is filled predominantly with low-density material.
-  connector_base_inside_logical->SetVisAttributes(G4Color::White());
-  new G4PVPlacement(nullptr, G4ThreeVector(0, 0, 0), connector_base_inside_logical, detector_name + "_connector_base_inside", connector_base_logical, 0, 0, false);
+  new G4PVPlacement(rotation_matrix, global_coordinates + (dist_from_center + main_case_length + 0.5 * connector_base_length) * e_r, model->connector_base_logical, detector_name + "_connector_base", world_Logical, 0, 0, false);
 
   if (use_connectors) {
     // HV connector
-    auto *connector_hv_solid = new G4Tubs(detector_name + "_connector_hv_solid", 0., connector_hv_radius, 0.5 * connector_hv_length, 0., twopi);
-    auto *connector_hv_logical = new G4LogicalVolume(connector_hv_solid, nist->FindOrBuildMaterial(connector_material), detector_name + "_connector_hv_logical");
-    connector_hv_logical->SetVisAttributes(G4Color::Grey());
-    new G4PVPlacement(rotation_matrix, global_coordinates + (dist_from_center + total_housing_length + 0.5 * connector_hv_length) * e_r + 0.5 / sqrt(2.) * connector_base_outer_radius * e_theta + 0.5 / sqrt(2.) * connector_base_outer_radius * e_phi, connector_hv_logical, detector_name + "_connector_hv", world_Logical, 0, 0, false);
+    new G4PVPlacement(rotation_matrix, global_coordinates + (dist_from_center + total_housing_length + 0.5 * connector_hv_length) * e_r + 0.5 / sqrt(2.) * connector_base_outer_radius * e_theta + 0.5 / sqrt(2.) * connector_base_outer_radius * e_phi, model->connector_hv_logical, detector_name + "_connector_hv", world_Logical, 0, 0, false);
 
     // Signal connector
-    auto *connector_signal_solid = new G4Tubs(detector_name + "_connector_signal_solid", 0., connector_signal_radius, 0.5 * connector_signal_length, 0., twopi);
-    auto *connector_signal_logical = new G4LogicalVolume(connector_signal_solid, nist->FindOrBuildMaterial(connector_material), detector_name + "_connector_signal_logical");
-    connector_signal_logical->SetVisAttributes(G4Color::Grey());
-    new G4PVPlacement(rotation_matrix, global_coordinates + (dist_from_center + total_housing_length + 0.5 * connector_signal_length) * e_r + 0.5 / sqrt(2.) * connector_base_outer_radius * e_theta - 0.5 / sqrt(2.) * connector_base_outer_radius * e_phi, connector_signal_logical, detector_name + "_connector_signal", world_Logical, 0, 0, false);
+    new G4PVPlacement(rotation_matrix, global_coordinates + (dist_from_center + total_housing_length + 0.5 * connector_signal_length) * e_r + 0.5 / sqrt(2.) * connector_base_outer_radius * e_theta - 0.5 / sqrt(2.) * connector_base_outer_radius * e_phi, model->connector_signal_logical, detector_name + "_connector_signal", world_Logical, 0, 0, false);
   }
 
   /************* Filters *************/
-  G4double filter_position_z = 0.; // Will be gradually increased to be able to place filters on top of each other
-
-  if (filter_materials.size()) {
-    G4Tubs *filter_solid = nullptr;
-    G4LogicalVolume *filter_logical = nullptr;
-    G4double filter_radius;
-    stringstream filter_base_name_ss;
-    for (unsigned int i = 0; i < filter_materials.size(); ++i) {
-      filter_radius = (filter_radii[i] < 0.) ? main_case_outer_radius : filter_radii[i]; // A negative filter radius value tells us to use the detector front radius as the filter radius
-      filter_base_name_ss << detector_name << "_filter_" << i + 1 << "_" << filter_materials[i] << "_" << filter_thicknesses[i] / mm << "mm_x_" << filter_radius / mm << "mm";
-      filter_solid = new G4Tubs(filter_base_name_ss.str() + "_solid", 0., filter_radius, filter_thicknesses[i] / 2., 0., twopi);
-      filter_logical = new G4LogicalVolume(filter_solid, nist->FindOrBuildMaterial(filter_materials[i]), filter_base_name_ss.str() + "_logical");
-      if (i % 2 == 0) {
-        filter_logical->SetVisAttributes(G4Color::Red());
-      } else {
-        filter_logical->SetVisAttributes(G4Color::Green());
-      }
-      new G4PVPlacement(rotation_matrix, global_coordinates + (dist_from_center - filter_position_z - filter_thicknesses[i] / 2.) * e_r, filter_logical, filter_base_name_ss.str(), world_Logical, 0, 0, false);
-      filter_position_z = filter_position_z + filter_thicknesses[i];
-      filter_base_name_ss.str("");
-    }
-  }
+  Construct_Filters(rotation_matrix, global_coordinates, e_r, dist_from_center, main_case_outer_radius);
 
   /************* Wraps *************/
   if (wrap_materials.size()) {
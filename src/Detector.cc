@@ -21,12 +21,11 @@ along with utr.  If not, see <http://www.gnu.org/licenses/>.
 #include "Detector.hh"
 
 Detector::Detector(G4LogicalVolume *World_Logical, G4String name) : world_Logical(World_Logical),
-                                                                    detector_name(name) {}
+                                                                    detector_name(name),
+                                                                    filters(World_Logical, name) {}
 
 void Detector::Add_Filter(G4String filter_material, G4double filter_thickness, G4double filter_radius) {
-  filter_materials.push_back(filter_material);
-  filter_thicknesses.push_back(filter_thickness);
-  filter_radii.push_back(filter_radius);
+  filters.Add_Filter(filter_material, filter_thickness, filter_radius);
 }
 
 void Detector::Add_Wrap(G4String wrap_material, G4double wrap_thickness) {
@@ -0,0 +1,298 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#include "G4AutoLock.hh"
+#include "G4Gamma.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
+#include "G4UnitsTable.hh"
+#include "G4VPhysicalVolume.hh"
+#include "Randomize.hh"
+
+#include "DetectorResponse.hh"
+#include "RegionManager.hh"
+
+namespace {
+G4Mutex calibration_mutex = G4MUTEX_INITIALIZER;
+// Relative deviation of the energy deposition from the incident energy which still counts as a full-energy deposition
+const G4double full_energy_tolerance = 1e-9;
+} // namespace
+
+const unsigned int DetectorResponse::n_fraction_bins = 1024;
+G4double DetectorResponse::energy_bin_width = 10. * keV;
+G4String DetectorResponse::calibration_filename = "";
+map<G4String, DetectorResponse::Table> DetectorResponse::tables = map<G4String, DetectorResponse::Table>();
+map<G4String, G4String> DetectorResponse::aliases = map<G4String, G4String>();
+G4ThreadLocal map<G4String, DetectorResponse::Table> *DetectorResponse::thread_tables = nullptr;
+G4ThreadLocal map<const G4LogicalVolume *, DetectorResponse::Entry> *DetectorResponse::event_entries = nullptr;
+
+DetectorResponse::Row::Row() : n_zero(0), n_full(0), continuum(n_fraction_bins, 0) {}
+
+void DetectorResponse::Row::Add(const Row &other) {
+  n_zero += other.n_zero;
+  n_full += other.n_full;
+  for (unsigned int i = 0; i < n_fraction_bins; ++i) {
+    continuum[i] += other.continuum[i];
+  }
+}
+
+void DetectorResponse::Set_Energy_Bin_Width(G4double width) {
+  if (!tables.empty()) {
+    G4cerr << "Error: DetectorResponse: The energy bin width cannot be changed after calibration data have been recorded or read." << G4endl;
+    throw std::exception();
+  }
+  energy_bin_width = width;
+}
+
+void DetectorResponse::Record_Step(const G4Step *step) {
+  const G4StepPoint *pre_step_point = step->GetPreStepPoint();
+  const G4LogicalVolume *logical_volume = pre_step_point->GetPhysicalVolume()->GetLogicalVolume();
+  if (!logical_volume->GetSensitiveDetector()) {
+    return;
+  }
+
+  if (!event_entries) {
+    event_entries = new map<const G4LogicalVolume *, Entry>();
+  }
+  auto entry = event_entries->find(logical_volume);
+  if (entry == event_entries->end()) {
+    entry = event_entries->insert(std::make_pair(logical_volume, Entry{-1., 0.})).first;
+  }
+
+  const G4Track *track = step->GetTrack();
+  if (entry->second.energy < 0. && track->GetParentID() == 0 && track->GetDefinition() == G4Gamma::Definition() && pre_step_point->GetStepStatus() == fGeomBoundary) {
+    entry->second.energy = pre_step_point->GetKineticEnergy();
+  }
+  entry->second.energy_deposition += step->GetTotalEnergyDeposit();
+}
+
+void DetectorResponse::End_Of_Event() {
+  if (!event_entries) {
+    return;
+  }
+  if (!thread_tables) {
+    thread_tables = new map<G4String, Table>();
+  }
+
+  for (auto entry : *event_entries) {
+    if (entry.second.energy <= 0.) {
+      continue;
+    }
+    Row &row = (*thread_tables)[entry.first->GetName()][(G4int)(entry.second.energy / energy_bin_width)];
+    const G4double fraction = entry.second.energy_deposition / entry.second.energy;
+    if (entry.second.energy_deposition <= 0.) {
+      ++row.n_zero;
+    } else if (fraction >= 1. - full_energy_tolerance) {
+      ++row.n_full;
+    } else {
+      ++row.continuum[(unsigned int)(fraction * n_fraction_bins)];
+    }
+  }
+  event_entries->clear();
+}
+
+void DetectorResponse::Merge() {
+  if (!thread_tables) {
+    return;
+  }
+  G4AutoLock lock(&calibration_mutex);
+  for (auto table : *thread_tables) {
+    for (auto row : table.second) {
+      tables[table.first][row.first].Add(row.second);
+    }
+  }
+  thread_tables->clear();
+}
+
+void DetectorResponse::Write() {
+  std::ofstream file(calibration_filename);
+  if (!file.is_open()) {
+    G4cerr << "Error: DetectorResponse: Could not open '" << calibration_filename << "' for writing." << G4endl;
+    throw std::exception();
+  }
+
+  // One row per volume and bin of the incident energy: volume, bin, n_zero, n_full, continuum
+  file << "# utr detector response" << G4endl;
+  file << "energy_bin_width " << energy_bin_width / MeV << G4endl;
+  file << "fraction_bins " << n_fraction_bins << G4endl;
+  for (auto table : tables) {
+    G4long n_photons = 0;
+    for (auto row : table.second) {
+      file << table.first << " " << row.first << " " << row.second.n_zero << " " << row.second.n_full;
+      n_photons += row.second.n_zero + row.second.n_full;
+      for (auto n : row.second.continuum) {
+        file << " " << n;
+        n_photons += n;
+      }
+      file << G4endl;
+    }
+    G4cout << "DetectorResponse: " << table.first << ": " << n_photons << " photons in " << table.second.size() << " energy bins of " << G4BestUnit(energy_bin_width, "Energy") << G4endl;
+  }
+  G4cout << "DetectorResponse: Wrote response tables to " << calibration_filename << G4endl;
+}
+
+void DetectorResponse::Read(const G4String &filename) {
+  std::ifstream file(filename);
+  if (!file.is_open()) {
+    G4cerr << "Error: DetectorResponse: Could not open '" << filename << "'." << G4endl;
+    throw std::exception();
+  }
+
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream values(line);
+    G4String key;
+    values >> key;
+    if (key == "energy_bin_width") {
+      G4double width;
+      values >> width;
+      if (!tables.empty() && width * MeV != energy_bin_width) {
+        G4cerr << "Error: DetectorResponse: '" << filename << "' uses a different energy bin width than the response tables which have already been read." << G4endl;
+        throw std::exception();
+      }
+      energy_bin_width = width * MeV;
+    } else if (key == "fraction_bins") {
+      unsigned int n;
+      values >> n;
+      if (n != n_fraction_bins) {
+        G4cerr << "Error: DetectorResponse: '" << filename << "' has " << n << " instead of " << n_fraction_bins << " fraction bins." << G4endl;
+        throw std::exception();
+      }
+    } else {
+      G4int bin;
+      Row row;
+      values >> bin >> row.n_zero >> row.n_full;
+      for (unsigned int i = 0; i < n_fraction_bins; ++i) {
+        values >> row.continuum[i];
+      }
+      if (values.fail()) {
+        G4cerr << "Error: DetectorResponse: Invalid row in '" << filename << "': " << line.substr(0, 80) << G4endl;
+        throw std::exception();
+      }
+      tables[key][bin].Add(row);
+    }
+  }
+
+  for (auto &table : tables) {
+    for (auto &row : table.second) {
+      vector<G4double> &cumulative = row.second.cumulative;
+      cumulative.resize(n_fraction_bins + 2);
+      cumulative[0] = row.second.n_zero;
+      for (unsigned int i = 0; i < n_fraction_bins; ++i) {
+        cumulative[i + 1] = cumulative[i] + row.second.continuum[i];
+      }
+      cumulative[n_fraction_bins + 1] = cumulative[n_fraction_bins] + row.second.n_full;
+    }
+  }
+  G4cout << "DetectorResponse: Read response tables for " << tables.size() << " volumes from " << filename << G4endl;
+}
+
+const G4String &DetectorResponse::Find_Table_Name(const G4String &volume) {
+  const auto alias = aliases.find(volume);
+  return alias == aliases.end() ? volume : alias->second;
+}
+
+bool DetectorResponse::Has_Response(const G4String &volume) {
+  return tables.find(Find_Table_Name(volume)) != tables.end();
+}
+
+G4double DetectorResponse::Sample_Energy_Deposition(const G4String &volume, G4double energy) {
+  const Table &table = tables.at(Find_Table_Name(volume));
+
+  // Row of the closest calibrated incident energy
+  const G4int bin = (G4int)(energy / energy_bin_width);
+  auto row = table.lower_bound(bin);
+  if (row == table.end()) {
+    --row;
+  } else if (row->first != bin && row != table.begin()) {
+    const auto previous = std::prev(row);
+    if (bin - previous->first < row->first - bin) {
+      row = previous;
+    }
+  }
+
+  const vector<G4double> &cumulative = row->second.cumulative;
+  const size_t i = std::upper_bound(cumulative.begin(), cumulative.end(), G4UniformRand() * cumulative.back()) - cumulative.begin();
+  if (i == 0) {
+    return 0.;
+  }
+  if (i > n_fraction_bins) {
+    return energy;
+  }
+  return (i - 1 + G4UniformRand()) / n_fraction_bins * energy;
+}
+
+void DetectorResponse::Construct_Model() {
+  if (Calibrating() || tables.empty()) {
+    return;
+  }
+
+  // The envelope of the model is the region of the sensitive volumes. It is shared by all threads,
+  // so the volumes are added by the master, while each thread creates its own model.
+  G4Region *envelope = RegionManager::Get_Region(RegionManager::sensitive);
+  if (G4Threading::IsMasterThread()) {
+    for (auto logical_volume : *G4LogicalVolumeStore::GetInstance()) {
+      if (!logical_volume->GetSensitiveDetector() || !Has_Response(logical_volume->GetName())) {
+        continue;
+      }
+      if (logical_volume->IsRootRegion() && logical_volume->GetRegion() != envelope) {
+        G4cout << "DetectorResponse: Warning: '" << logical_volume->GetName() << "' belongs to the region '" << logical_volume->GetRegion()->GetName() << "' and is simulated in full detail." << G4endl;
+        continue;
+      }
+      if (!logical_volume->IsRootRegion()) {
+        envelope->AddRootLogicalVolume(logical_volume);
+      }
+      G4cout << "DetectorResponse: Using the tabulated response for '" << logical_volume->GetName() << "'" << G4endl;
+    }
+  }
+  new DetectorResponseModel(envelope);
+}
+
+G4bool DetectorResponseModel::IsApplicable(const G4ParticleDefinition &particle) {
+  return &particle == G4Gamma::Definition();
+}
+
+G4bool DetectorResponseModel::ModelTrigger(const G4FastTrack &fast_track) {
+  // Like in the calibration (see DetectorResponse::Record_Step), only photons which enter the volume through its surface are replaced.
+  // Photons which are created inside, e.g. by bremsstrahlung, annihilation or fluorescence, are already part of the tabulated response.
+  const G4Step *step = fast_track.GetPrimaryTrack()->GetStep();
+  if (!step || step->GetPreStepPoint()->GetStepStatus() != fGeomBoundary || fast_track.GetEnvelopeSolid()->Inside(fast_track.GetPrimaryTrackLocalPosition()) != kSurface) {
+    return false;
+  }
+  return DetectorResponse::Has_Response(fast_track.GetEnvelopeLogicalVolume()->GetName());
+}
+
+void DetectorResponseModel::DoIt(const G4FastTrack &fast_track, G4FastStep &fast_step) {
+  const G4double energy_deposition = DetectorResponse::Sample_Energy_Deposition(fast_track.GetEnvelopeLogicalVolume()->GetName(), fast_track.GetPrimaryTrack()->GetKineticEnergy());
+  // The energy deposition is recorded by the sensitive detector of the volume, like the one of a regular step
+  fast_step.KillPrimaryTrack();
+  fast_step.ProposePrimaryTrackPathLength(0.);
+  fast_step.ProposeTotalEnergyDeposited(energy_deposition);
+}
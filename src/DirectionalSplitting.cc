@@ -0,0 +1,148 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cmath>
+
+#include "G4DynamicParticle.hh"
+#include "G4Gamma.hh"
+#include "G4ParticleChangeForGamma.hh"
+#include "G4Track.hh"
+#include "Randomize.hh"
+
+#include "BiasedCopies.hh"
+#include "DirectionalSplitting.hh"
+
+DirectionalSplittingOperation::DirectionalSplittingOperation(const G4String &name) : G4VBiasingOperation(name), splitting_factor(1) {
+  // The weights of the split photons are set by this operation and must not be overwritten by the weight of the parent
+  particle_change.SetSecondaryWeightByProcess(true);
+}
+
+void DirectionalSplittingOperation::Add_Cone(const G4ThreeVector &direction, G4double half_angle) {
+  cone_directions.push_back(direction.unit());
+  cone_cos_half_angles.push_back(std::cos(half_angle));
+}
+
+bool DirectionalSplittingOperation::Towards_Detector(const G4ThreeVector &direction) const {
+  for (size_t i = 0; i < cone_directions.size(); ++i) {
+    if (direction.dot(cone_directions[i]) >= cone_cos_half_angles[i]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+G4VParticleChange *DirectionalSplittingOperation::ApplyFinalStateBiasing(const G4BiasingProcessInterface *callingProcess, const G4Track *track, const G4Step *step, G4bool &) {
+  G4VParticleChange *process_final_state = callingProcess->GetWrappedProcess()->PostStepDoIt(*track, *step);
+  if (splitting_factor == 1 || !dynamic_cast<G4ParticleChangeForGamma *>(process_final_state)) {
+    return process_final_state;
+  }
+
+  particle_change.Initialize(*track);
+  particle_change.ProposeLocalEnergyDeposit(process_final_state->GetLocalEnergyDeposit());
+
+  const G4double weight = track->GetWeight();
+  const G4double survival_probability = 1. / splitting_factor;
+
+  vector<G4Track *> secondaries;
+  vector<Photon> photons;
+  G4bool first_photon_survived = false;
+
+  for (G4int i = 0; i < splitting_factor; ++i) {
+    if (i > 0) {
+      process_final_state = callingProcess->GetWrappedProcess()->PostStepDoIt(*track, *step);
+    }
+    for (G4int j = 0; j < process_final_state->GetNumberOfSecondaries(); ++j) {
+      G4Track *secondary = process_final_state->GetSecondary(j);
+      if (i == 0) {
+        secondary->SetWeight(weight);
+        secondaries.push_back(secondary);
+      } else {
+        delete secondary;
+      }
+    }
+
+    const G4ParticleChangeForGamma *gamma_final_state = static_cast<G4ParticleChangeForGamma *>(process_final_state);
+    const bool photon_alive = gamma_final_state->GetTrackStatus() == fAlive && gamma_final_state->GetProposedKineticEnergy() > 0.;
+    Photon photon{gamma_final_state->GetProposedMomentumDirection(), gamma_final_state->GetProposedKineticEnergy(), gamma_final_state->GetProposedPolarization(), weight};
+    process_final_state->Clear();
+    if (!photon_alive) {
+      continue;
+    }
+
+    if (Towards_Detector(photon.direction)) {
+      photon.weight = weight * survival_probability;
+    } else if (G4UniformRand() >= survival_probability) {
+      continue;
+    }
+    photons.push_back(photon);
+    if (i == 0) {
+      first_photon_survived = true;
+    }
+  }
+
+  // Each photon is a copy of its own (see BiasedCopies.hh). The secondaries of the first sample stay in the copy of the
+  // track, and so does the track if it continues as the photon of the first sample with its weight.
+  for (auto secondary : secondaries) {
+    BiasedCopies::Join_Copy(secondary, track);
+  }
+  if (!photons.empty() && !first_photon_survived) {
+    BiasedCopies::New_Copy(const_cast<G4Track *>(track));
+  }
+
+  // The track continues as the first surviving photon
+  if (photons.empty()) {
+    particle_change.ProposeTrackStatus(fStopAndKill);
+    particle_change.ProposeEnergy(0.);
+  } else {
+    particle_change.ProposeMomentumDirection(photons[0].direction);
+    particle_change.ProposeEnergy(photons[0].energy);
+    particle_change.ProposePolarization(photons[0].polarization);
+    particle_change.ProposeWeight(photons[0].weight);
+  }
+  for (size_t i = 1; i < photons.size(); ++i) {
+    G4Track *photon_track = new G4Track(new G4DynamicParticle(G4Gamma::Definition(), photons[i].direction, photons[i].energy), track->GetGlobalTime(), track->GetPosition());
+    photon_track->SetPolarization(photons[i].polarization);
+    photon_track->SetWeight(photons[i].weight);
+    photon_track->SetTouchableHandle(track->GetTouchableHandle());
+    BiasedCopies::New_Copy(photon_track);
+    secondaries.push_back(photon_track);
+  }
+
+  particle_change.SetNumberOfSecondaries(secondaries.size());
+  for (auto secondary : secondaries) {
+    particle_change.AddSecondary(secondary);
+  }
+  return &particle_change;
+}
+
+DirectionalSplittingOperator::DirectionalSplittingOperator(G4int splitting_factor) : G4VBiasingOperator("DirectionalSplittingOperator"), operation("DirectionalSplitting") {
+  operation.Set_Splitting_Factor(splitting_factor);
+}
+
+G4VBiasingOperation *DirectionalSplittingOperator::ProposeFinalStateBiasingOperation(const G4Track *track, const G4BiasingProcessInterface *callingProcess) {
+  if (track->GetDefinition() != G4Gamma::Definition()) {
+    return nullptr;
+  }
+  const G4String &process_name = callingProcess->GetWrappedProcess()->GetProcessName();
+  if (process_name == "compt" || process_name == "Rayl") {
+    return &operation;
+  }
+  return nullptr;
+}
@@ -18,8 +18,11 @@ You should have received a copy of the GNU General Public License
 along with utr.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+
 #include "EnergyDepositionSD.hh"
-#include "DetectorConstruction.hh"
+#include "BiasedCopies.hh"
+#include "GeometryPlugin.hh"
 #include "G4HCofThisEvent.hh"
 #include "G4RootAnalysisManager.hh"
 #include "G4RunManager.hh"
@@ -29,7 +32,10 @@ along with utr.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4ThreeVector.hh"
 #include "G4VProcess.hh"
 #include "G4ios.hh"
+#include "EnergySweep.hh"
+#include "ResponseMatrix.hh"
 #include "RunAction.hh"
+#include "RunChain.hh"
 #include "TargetHit.hh"
 
 #include "utrConfig.h"
@@ -68,84 +74,138 @@ G4bool EnergyDepositionSD::ProcessHits(G4Step *aStep, G4TouchableHistory *) {
   hit->SetEventID(eventID);
   hit->SetPosition(track->GetPosition());
   hit->SetMomentum(track->GetMomentum());
+  hit->SetWeight(aStep->GetPreStepPoint()->GetWeight());
+  hit->SetCopyID(BiasedCopies::Get_Copy_ID(track));
 
   hitsCollection->insert(hit);
 
   return true;
 }
 
-// Initialize static member needed for EVENT_EVENTWISE mode, actual initialization values is, however, set in utr.cc
-std::vector<bool> EnergyDepositionSD::anyDetectorHitInEvent = std::vector<bool>();
+G4ThreadLocal vector<EnergyDepositionSD::Deposition> *EnergyDepositionSD::depositions = nullptr;
 
 void EnergyDepositionSD::EndOfEvent(G4HCofThisEvent *) {
 
-  G4int nHits = hitsCollection->entries();
-  G4double totalEnergyDeposition = 0.;
+  // Sum up the energy depositions of each copy of the event separately. Without variance reduction, all hits belong to copy 0.
+  vector<Deposition> copies;
+  for (size_t i = 0; i < hitsCollection->entries(); ++i) {
+    TargetHit *hit = (*hitsCollection)[i];
+    auto copy = std::find_if(copies.begin(), copies.end(), [hit](const Deposition &deposition) { return deposition.copyID == hit->GetCopyID(); });
+    if (copy == copies.end()) {
+      copies.push_back(Deposition{hit->GetCopyID(), detectorID, eventID, 0., hit->GetWeight(), hit->GetKineticEnergy(), hit->GetParticleType(), hit->GetPosition(), hit->GetMomentum()});
+      copy = copies.end() - 1;
+    }
+    copy->energyDeposition += hit->GetEnergyDeposition();
+  }
 
-  for (G4int i = 0; i < nHits; i++) {
-    totalEnergyDeposition += (*hitsCollection)[i]->GetEnergyDeposition();
+  for (auto &copy : copies) {
+    if (copy.energyDeposition <= 0.) {
+      continue;
+    }
+#ifdef RESPONSE_MATRIX
+#ifdef EVENT_WEIGHT
+    ResponseMatrix::Fill(GetDetectorID(), copy.energyDeposition, copy.weight);
+#else
+    ResponseMatrix::Fill(GetDetectorID(), copy.energyDeposition, 1.);
+#endif
+#else
+    if (!depositions) {
+      depositions = new vector<Deposition>();
+    }
+    depositions->push_back(copy);
+#endif
   }
+}
 
-#ifdef EVENT_EVENTWISE
-  G4RootAnalysisManager *analysisManager = G4RootAnalysisManager::Instance();
-  if (totalEnergyDeposition > 0.) {
-    analysisManager->FillNtupleDColumn(0, GetDetectorID(), totalEnergyDeposition);
-    anyDetectorHitInEvent[G4Threading::G4GetThreadId()] = true;
+void EnergyDepositionSD::Write_Event() {
+  if (!depositions || depositions->empty()) {
+    return;
   }
-  if (anyDetectorHitInEvent[G4Threading::G4GetThreadId()] && GetDetectorID() == ((DetectorConstruction *)G4RunManager::GetRunManager()->GetUserDetectorConstruction())->Max_Sensitive_Detector_ID) {
+
+  // Write the rows of each copy one after another, so that the add-back of getHistogram never mixes copies
+  std::stable_sort(depositions->begin(), depositions->end(), [](const Deposition &a, const Deposition &b) { return a.copyID < b.copyID; });
+
+  G4RootAnalysisManager *analysisManager = G4RootAnalysisManager::Instance();
+
+#ifdef EVENT_EVENTWISE
+  // One row per copy, which contains the energy depositions of the copy in all detectors
+  for (auto first = depositions->begin(); first != depositions->end();) {
+    auto last = std::find_if(first, depositions->end(), [first](const Deposition &deposition) { return deposition.copyID != first->copyID; });
+    for (auto deposition = first; deposition != last; ++deposition) {
+      analysisManager->FillNtupleDColumn(0, deposition->detectorID, deposition->energyDeposition);
+    }
+#ifdef EVENT_WEIGHT
+    analysisManager->FillNtupleDColumn(0, GeometryPlugin::Get_Max_Sensitive_Detector_ID() + 1, first->weight);
+    const G4int ebeamColumn = GeometryPlugin::Get_Max_Sensitive_Detector_ID() + 2;
+#else
+    const G4int ebeamColumn = GeometryPlugin::Get_Max_Sensitive_Detector_ID() + 1;
+#endif
+    if (EnergySweep::Is_Active()) {
+      analysisManager->FillNtupleDColumn(0, ebeamColumn, EnergySweep::Get_Energy());
+    }
     analysisManager->AddNtupleRow();
-    anyDetectorHitInEvent[G4Threading::G4GetThreadId()] = false;
+    first = last;
   }
 #else
-  if (totalEnergyDeposition > 0.) {
-    G4RootAnalysisManager *analysisManager = G4RootAnalysisManager::Instance();
-
+  for (auto &deposition : *depositions) {
     unsigned int nentry = 0;
 
 #ifdef EVENT_ID
-    analysisManager->FillNtupleDColumn(nentry, eventID);
+    analysisManager->FillNtupleDColumn(nentry, RunChain::Global_Event_ID(deposition.eventID));
     ++nentry;
 #endif
 #ifdef EVENT_EDEP
-    analysisManager->FillNtupleDColumn(nentry, totalEnergyDeposition);
+    analysisManager->FillNtupleDColumn(nentry, deposition.energyDeposition);
     ++nentry;
 #endif
 #ifdef EVENT_EKIN
-    analysisManager->FillNtupleDColumn(nentry, (*hitsCollection)[0]->GetKineticEnergy());
+    analysisManager->FillNtupleDColumn(nentry, deposition.kineticEnergy);
     ++nentry;
 #endif
 #ifdef EVENT_PARTICLE
-    analysisManager->FillNtupleDColumn(nentry, (*hitsCollection)[0]->GetParticleType());
+    analysisManager->FillNtupleDColumn(nentry, deposition.particleType);
     ++nentry;
 #endif
 #ifdef EVENT_VOLUME
-    analysisManager->FillNtupleDColumn(nentry, GetDetectorID());
+    analysisManager->FillNtupleDColumn(nentry, deposition.detectorID);
     ++nentry;
 #endif
 #ifdef EVENT_POSX
-    analysisManager->FillNtupleDColumn(nentry, (*hitsCollection)[0]->GetPosition().x());
+    analysisManager->FillNtupleDColumn(nentry, deposition.position.x());
     ++nentry;
 #endif
 #ifdef EVENT_POSY
-    analysisManager->FillNtupleDColumn(nentry, (*hitsCollection)[0]->GetPosition().y());
+    analysisManager->FillNtupleDColumn(nentry, deposition.position.y());
     ++nentry;
 #endif
 #ifdef EVENT_POSZ
-    analysisManager->FillNtupleDColumn(nentry, (*hitsCollection)[0]->GetPosition().z());
+    analysisManager->FillNtupleDColumn(nentry, deposition.position.z());
     ++nentry;
 #endif
 #ifdef EVENT_MOMX
-    analysisManager->FillNtupleDColumn(nentry, (*hitsCollection)[0]->GetMomentum().x());
+    analysisManager->FillNtupleDColumn(nentry, deposition.momentum.x());
     ++nentry;
 #endif
 #ifdef EVENT_MOMY
-    analysisManager->FillNtupleDColumn(nentry, (*hitsCollection)[0]->GetMomentum().y());
+    analysisManager->FillNtupleDColumn(nentry, deposition.momentum.y());
     ++nentry;
 #endif
 #ifdef EVENT_MOMZ
-    analysisManager->FillNtupleDColumn(nentry, (*hitsCollection)[0]->GetMomentum().z());
+    analysisManager->FillNtupleDColumn(nentry, deposition.momentum.z());
+    ++nentry;
 #endif
+#ifdef EVENT_WEIGHT
+    analysisManager->FillNtupleDColumn(nentry, deposition.weight);
+    ++nentry;
+    analysisManager->FillNtupleDColumn(nentry, deposition.copyID);
+    ++nentry;
+#endif
+    if (EnergySweep::Is_Active()) {
+      analysisManager->FillNtupleDColumn(nentry, EnergySweep::Get_Energy());
+    }
     analysisManager->AddNtupleRow();
   }
 #endif
+
+  depositions->clear();
 }
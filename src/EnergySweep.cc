@@ -0,0 +1,86 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cmath>
+
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4UnitsTable.hh"
+
+#include "EnergySweep.hh"
+#include "RunChain.hh"
+#include "utrConfig.h"
+
+vector<G4double> EnergySweep::energies;
+G4bool EnergySweep::active = false;
+G4ThreadLocal G4double EnergySweep::current_energy = 0.;
+
+void EnergySweep::Set_Energies(const vector<G4double> &new_energies) {
+  for (auto energy : new_energies) {
+    if (energy <= 0.) {
+      G4cerr << "Error: EnergySweep: Invalid energy " << G4BestUnit(energy, "Energy") << "." << G4endl;
+      throw std::exception();
+    }
+  }
+  energies = new_energies;
+}
+
+void EnergySweep::Set_Energy_Range(G4double min, G4double max, G4double step) {
+  if (min <= 0. || max < min || step <= 0.) {
+    G4cerr << "Error: EnergySweep: Invalid energy range from " << G4BestUnit(min, "Energy") << " to " << G4BestUnit(max, "Energy") << " in steps of " << G4BestUnit(step, "Energy") << "." << G4endl;
+    throw std::exception();
+  }
+  const G4int n_energies = (G4int)std::floor((max - min) / step + 0.5) + 1;
+  energies.resize(n_energies);
+  for (G4int i = 0; i < n_energies; ++i) {
+    energies[i] = min + i * step;
+  }
+}
+
+void EnergySweep::BeamOn(G4long n_events_per_energy) {
+#ifdef RESPONSE_MATRIX
+  G4cerr << "Error: EnergySweep: The RESPONSE_MATRIX mode samples the energies itself, use /utr/responseMatrix/energyStep for a grid of energies." << G4endl;
+  return;
+#endif
+#if defined GENERATOR_ANGCORR && !defined GENERATOR_ANGDIST
+  G4cerr << "Error: EnergySweep: The AngularCorrelationGenerator emits cascades of particles with different energies, which can not be swept." << G4endl;
+  return;
+#endif
+  if (energies.empty()) {
+    G4cerr << "Error: EnergySweep: No energies were set. Use /utr/sweep/energies or /utr/sweep/energyRange before /utr/sweep/beamOn." << G4endl;
+    return;
+  }
+
+  G4cout << "EnergySweep: " << n_events_per_energy << " events for each of " << energies.size() << " energies from " << G4BestUnit(energies.front(), "Energy") << " to " << G4BestUnit(energies.back(), "Energy") << G4endl;
+  active = true;
+  RunChain::BeamOn(n_events_per_energy * (G4long)energies.size());
+  active = false;
+}
+
+void EnergySweep::Set_Primary_Energy(G4Event *event) {
+  const G4long index = (RunChain::Get_Event_Offset() + event->GetEventID()) % (G4long)energies.size();
+  current_energy = energies[index];
+
+  for (G4int i = 0; i < event->GetNumberOfPrimaryVertex(); ++i) {
+    for (G4PrimaryParticle *primary = event->GetPrimaryVertex(i)->GetPrimary(); primary; primary = primary->GetNext()) {
+      primary->SetKineticEnergy(current_energy);
+    }
+  }
+}
@@ -19,48 +19,35 @@ along with utr.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "EventAction.hh"
-#include "DetectorConstruction.hh"
 #include "G4Event.hh"
-#include "G4MTRunManager.hh"
-#include "G4RunManager.hh"
-#include <chrono>
 
+#include "BiasedCopies.hh"
+#include "DetectorResponse.hh"
+#include "EnergyDepositionSD.hh"
 #include "G4LogicalVolume.hh"
+#include "ProgressMonitor.hh"
+#include "ResponseMatrix.hh"
 #include "utrConfig.h"
 
-using std::setw;
-using std::string;
-using std::to_string;
-
-// static const auto StartRunTime = time();
-static const auto StartRunTime = std::chrono::steady_clock::now();
-
-EventAction::EventAction() : n_threads(1) {}
+EventAction::EventAction() {}
 
 EventAction::~EventAction() {}
 
 void EventAction::EndOfEventAction(const G4Event *event) {
-  int eID = event->GetEventID();
-  if (0 == (eID % print_progress)) {
-#ifdef G4MULTITHREADED
-    G4RunManager *runManager = G4MTRunManager::GetRunManager();
+#ifdef FAST_DETECTOR_RESPONSE
+  if (DetectorResponse::Calibrating()) {
+    DetectorResponse::End_Of_Event();
+  }
+#endif
+
+#ifdef RESPONSE_MATRIX
+  ResponseMatrix::Fill_Primary(event);
 #else
-    G4RunManager *runManager = G4RunManager::GetRunManager();
+  EnergyDepositionSD::Write_Event();
+#endif
+#if defined(IMPORTANCE_BIASING) || defined(FORCED_COLLISION) || defined(DIRECTIONAL_SPLITTING)
+  BiasedCopies::Reset();
 #endif
-    int NbEvents = runManager->GetNumberOfEventsToBeProcessed();
-    int threadID = G4Threading::G4GetThreadId();
-    int numberofpadchars = to_string(n_threads - 1).length() - to_string(threadID).length();
-    string padchars(numberofpadchars, ' ');
-    auto elapsedSeconds = (std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - StartRunTime)).count();
-    int days = elapsedSeconds / (24 * 3600);
-    int hours = (elapsedSeconds - days * (24 * 3600)) / 3600;
-    int minutes = (elapsedSeconds - days * (24 * 3600) - hours * 3600) / 60;
-    int sec = (elapsedSeconds - days * (24 * 3600) - hours * 3600 - minutes * 60);
-    float percent = (float)((float)eID / (float)NbEvents * 100.);
 
-    G4cout << padchars << "Progress: [" << setw(16) << eID << "/" << NbEvents << "]  "
-           << setw(4) << std::setprecision(2) << std::fixed << percent << " %"
-           << "\tRunning time: " << setw(3) << days << "d " << setw(2) << hours << "h " << setw(3) << minutes << "mn " << setw(3) << sec << "s"
-           << G4endl;
-  }
+  ProgressMonitor::Count_Event();
 }
@@ -0,0 +1,96 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <sstream>
+
+#include "G4Box.hh"
+#include "G4Color.hh"
+#include "G4NistManager.hh"
+#include "G4PVPlacement.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Tubs.hh"
+#include "G4VisAttributes.hh"
+
+#include "FilterStack.hh"
+
+using std::stringstream;
+
+vector<FilterStack::Filter_Logical> FilterStack::filter_logicals;
+
+void FilterStack::Add_Filter(G4String filter_material, G4double filter_thickness, G4double filter_radius) {
+  filter_materials.push_back(filter_material);
+  filter_thicknesses.push_back(filter_thickness);
+  filter_radii.push_back(filter_radius);
+}
+
+G4LogicalVolume *FilterStack::Get_Filter_Logical(const G4String &material, G4double thickness, G4double radius, bool square, bool red) {
+  for (auto &filter_logical : filter_logicals) {
+    if (filter_logical.material == material && filter_logical.thickness == thickness && filter_logical.radius == radius && filter_logical.square == square && filter_logical.red == red) {
+      return filter_logical.logical;
+    }
+  }
+
+  stringstream filter_base_name_ss;
+  filter_base_name_ss << "filter_" << material << "_" << thickness / mm << "mm_x_" << (square ? 2. * radius : radius) / mm << "mm" << (square ? "_square" : "") << (red ? "_red" : "_green");
+
+  G4VSolid *filter_solid = nullptr;
+  if (square) {
+    filter_solid = new G4Box(filter_base_name_ss.str() + "_solid", radius, radius, thickness / 2.);
+  } else {
+    filter_solid = new G4Tubs(filter_base_name_ss.str() + "_solid", 0., radius, thickness / 2., 0., twopi);
+  }
+  G4LogicalVolume *filter_logical = new G4LogicalVolume(filter_solid, G4NistManager::Instance()->FindOrBuildMaterial(material), filter_base_name_ss.str() + "_logical");
+  if (red) {
+    filter_logical->SetVisAttributes(G4Color::Red());
+  } else {
+    filter_logical->SetVisAttributes(G4Color::Green());
+  }
+
+  filter_logicals.push_back(Filter_Logical{material, thickness, radius, square, red, filter_logical});
+  return filter_logical;
+}
+
+G4double FilterStack::Construct(G4RotationMatrix *rotation, G4ThreeVector global_coordinates, G4ThreeVector symmetry_axis, G4double dist_from_center, G4double default_radius, bool square) const {
+  G4double filter_position_z = 0.; // Will be gradually increased to be able to place filters on top of each other
+
+  G4double filter_radius, filter_thickness;
+  unsigned int n_layers;
+  stringstream filter_name_ss;
+  for (unsigned int i = 0; i < filter_materials.size(); i += n_layers) {
+    filter_radius = (filter_radii[i] < 0.) ? default_radius : filter_radii[i]; // A negative filter radius value tells us to use the detector front radius as the filter radius
+    filter_thickness = filter_thicknesses[i];
+    n_layers = 1;
+
+    if (merge_filters) {
+      while (i + n_layers < filter_materials.size() && filter_materials[i + n_layers] == filter_materials[i] && ((filter_radii[i + n_layers] < 0.) ? default_radius : filter_radii[i + n_layers]) == filter_radius) {
+        filter_thickness += filter_thicknesses[i + n_layers];
+        ++n_layers;
+      }
+    }
+
+    filter_name_ss << name << "_filter_" << i + 1 << "_" << filter_materials[i] << "_" << filter_thickness / mm << "mm_x_" << (square ? 2. * filter_radius : filter_radius) / mm << "mm";
+    new G4PVPlacement(rotation, global_coordinates + (dist_from_center - filter_position_z - filter_thickness / 2.) * symmetry_axis, Get_Filter_Logical(filter_materials[i], filter_thickness, filter_radius, square, i % 2 == 0), filter_name_ss.str(), world_Logical, 0, 0, false);
+    filter_position_z = filter_position_z + filter_thickness;
+    filter_name_ss.str("");
+  }
+
+  return filter_position_z;
+}
@@ -20,7 +20,12 @@ along with utr.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "GeneralParticleSource.hh"
 #include "G4Event.hh"
+#include "EnergySweep.hh"
 #include "G4GeneralParticleSource.hh"
+#include "ResponseMatrix.hh"
+#include "Sharding.hh"
+
+#include "utrConfig.h"
 
 GeneralParticleSource::GeneralParticleSource()
     : G4VUserPrimaryGeneratorAction(), particleGun(0) {
@@ -30,5 +35,12 @@ GeneralParticleSource::GeneralParticleSource()
 GeneralParticleSource::~GeneralParticleSource() { delete particleGun; }
 
 void GeneralParticleSource::GeneratePrimaries(G4Event *anEvent) {
+  Sharding::Seed_Event(anEvent->GetEventID());
   particleGun->GeneratePrimaryVertex(anEvent);
+  if (EnergySweep::Is_Active()) {
+    EnergySweep::Set_Primary_Energy(anEvent);
+  }
+#ifdef RESPONSE_MATRIX
+  ResponseMatrix::Sample_Primary_Energy(anEvent);
+#endif
 }
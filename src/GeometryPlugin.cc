@@ -0,0 +1,118 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <exception>
+
+#include "globals.hh"
+
+#include "GeometryPlugin.hh"
+#include "utrConfig.h"
+
+#ifdef GEOMETRY_PLUGINS
+#include <dlfcn.h>
+#else
+// Defined in DetectorConstruction/GeometryPluginFactory.cc, which is compiled into utr together with the selected DetectorConstruction
+extern "C" G4VUserDetectorConstruction *utr_create_detector_construction();
+extern "C" const char *utr_geometry_name();
+extern "C" const char *utr_geometry_build_options();
+#if defined EVENT_EVENTWISE || defined RESPONSE_MATRIX
+extern "C" unsigned int utr_max_sensitive_detector_id(const G4VUserDetectorConstruction *detector_construction);
+#endif
+#endif
+
+void *GeometryPlugin::handle = nullptr;
+G4VUserDetectorConstruction *GeometryPlugin::detector_construction = nullptr;
+#ifdef GEOMETRY_PLUGINS
+GeometryPlugin::Create_Function GeometryPlugin::create_function = nullptr;
+GeometryPlugin::Geometry_Name_Function GeometryPlugin::geometry_name_function = nullptr;
+GeometryPlugin::Geometry_Name_Function GeometryPlugin::geometry_build_options_function = nullptr;
+GeometryPlugin::Max_Sensitive_Detector_ID_Function GeometryPlugin::max_sensitive_detector_id_function = nullptr;
+#else
+GeometryPlugin::Create_Function GeometryPlugin::create_function = utr_create_detector_construction;
+GeometryPlugin::Geometry_Name_Function GeometryPlugin::geometry_name_function = utr_geometry_name;
+GeometryPlugin::Geometry_Name_Function GeometryPlugin::geometry_build_options_function = utr_geometry_build_options;
+#if defined EVENT_EVENTWISE || defined RESPONSE_MATRIX
+GeometryPlugin::Max_Sensitive_Detector_ID_Function GeometryPlugin::max_sensitive_detector_id_function = utr_max_sensitive_detector_id;
+#else
+GeometryPlugin::Max_Sensitive_Detector_ID_Function GeometryPlugin::max_sensitive_detector_id_function = nullptr;
+#endif
+#endif
+
+bool GeometryPlugin::Load(const G4String &geometry) {
+#ifdef GEOMETRY_PLUGINS
+  G4String filename = geometry;
+  if (geometry.find(".so") == std::string::npos) {
+    filename = G4String(geometry_plugin_dir) + "/" + geometry + ".so";
+  }
+
+  G4cout << "Loading geometry plugin " << filename << G4endl;
+  handle = dlopen(filename.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (!handle) {
+    G4cerr << "Error: Could not load geometry plugin " << filename << ": " << dlerror() << G4endl;
+    return false;
+  }
+
+  create_function = (Create_Function)dlsym(handle, "utr_create_detector_construction");
+  max_sensitive_detector_id_function = (Max_Sensitive_Detector_ID_Function)dlsym(handle, "utr_max_sensitive_detector_id");
+  geometry_name_function = (Geometry_Name_Function)dlsym(handle, "utr_geometry_name");
+  geometry_build_options_function = (Geometry_Name_Function)dlsym(handle, "utr_geometry_build_options");
+  if (!create_function) {
+    G4cerr << "Error: Geometry plugin " << filename << " does not provide utr_create_detector_construction()" << G4endl;
+    dlclose(handle);
+    handle = nullptr;
+    return false;
+  }
+  return true;
+#else
+  G4cerr << "Error: utr was built without the GEOMETRY_PLUGINS option, so the geometry '" << geometry << "' cannot be loaded at runtime. The geometry is selected by the CAMPAIGN and DETECTOR_CONSTRUCTION build options instead." << G4endl;
+  return false;
+#endif
+}
+
+G4VUserDetectorConstruction *GeometryPlugin::Create_Detector_Construction() {
+  if (!create_function) {
+    G4cerr << "Error: No geometry plugin loaded. Select one with the --geometry option." << G4endl;
+    return nullptr;
+  }
+  detector_construction = create_function();
+  return detector_construction;
+}
+
+unsigned int GeometryPlugin::Get_Max_Sensitive_Detector_ID() {
+  if (!max_sensitive_detector_id_function) {
+    G4cerr << "Error: The DetectorConstruction does not provide Max_Sensitive_Detector_ID, which is required by EVENT_EVENTWISE and RESPONSE_MATRIX" << G4endl;
+    throw std::exception();
+  }
+  return max_sensitive_detector_id_function(detector_construction);
+}
+
+G4String GeometryPlugin::Get_Geometry_Name() {
+  if (!geometry_name_function) {
+    return "";
+  }
+  return geometry_name_function();
+}
+
+G4String GeometryPlugin::Get_Geometry_Build_Options() {
+  if (!geometry_build_options_function) {
+    return "";
+  }
+  return geometry_build_options_function();
+}
@@ -38,6 +38,120 @@ using std::stringstream;
 
 #include "HPGe_Clover.hh"
 
+vector<HPGe_Clover::Model> HPGe_Clover::models;
+
+bool HPGe_Clover::Is_Same_Model(const HPGe_Clover_Properties &a, const HPGe_Clover_Properties &b, bool with_dewar) {
+  // Compare only the properties which enter the construction of the shared volumes.
+  // The dewar properties are not necessarily set if a detector is used without a dewar.
+  bool same = a.crystal_radius == b.crystal_radius &&
+              a.crystal_length == b.crystal_length &&
+              a.crystal_gap == b.crystal_gap &&
+              a.end_cap_to_crystal_gap_front == b.end_cap_to_crystal_gap_front &&
+              a.vacuum_length == b.vacuum_length &&
+              a.end_cap_front_side_length == b.end_cap_front_side_length &&
+              a.end_cap_front_rounding_radius == b.end_cap_front_rounding_radius &&
+              a.end_cap_front_length == b.end_cap_front_length &&
+              a.end_cap_front_thickness == b.end_cap_front_thickness &&
+              a.end_cap_window_thickness == b.end_cap_window_thickness &&
+              a.end_cap_back_side_length == b.end_cap_back_side_length &&
+              a.end_cap_back_rounding_radius == b.end_cap_back_rounding_radius &&
+              a.end_cap_back_length == b.end_cap_back_length &&
+              a.end_cap_back_thickness == b.end_cap_back_thickness &&
+              a.end_cap_material == b.end_cap_material;
+  if (same && with_dewar) {
+    same = a.connection_length == b.connection_length &&
+           a.connection_radius == b.connection_radius &&
+           a.connection_material == b.connection_material &&
+           a.dewar_length == b.dewar_length &&
+           a.dewar_outer_radius == b.dewar_outer_radius &&
+           a.dewar_wall_thickness == b.dewar_wall_thickness &&
+           a.dewar_material == b.dewar_material;
+  }
+  return same;
+}
+
+const HPGe_Clover::Model &HPGe_Clover::Get_Model() const {
+  for (auto &model : models) {
+    if (model.with_dewar == use_dewar && Is_Same_Model(model.properties, properties, use_dewar)) {
+      return model;
+    }
+  }
+
+  G4NistManager *nist = G4NistManager::Instance();
+
+  Model model;
+  model.properties = properties;
+  model.with_dewar = use_dewar;
+
+  stringstream model_name_ss;
+  model_name_ss << "HPGe_Clover_model_" << models.size();
+  const G4String model_name = model_name_ss.str();
+
+  G4cout << "HPGe_Clover: Constructing " << model_name << " for " << detector_name << G4endl;
+
+  /******** Front end cap *********/
+
+  model.end_cap_front_solid = rounded_box(model_name + "_end_cap_front_solid", properties.end_cap_front_side_length, properties.end_cap_front_length, properties.end_cap_front_rounding_radius, 20);
+
+  /******** Vacuum around crystal ********/
+
+  model.vacuum_solid = rounded_box(model_name + "_vacuum_solid", properties.end_cap_front_side_length - 2. * properties.end_cap_front_thickness, properties.vacuum_length, properties.end_cap_front_rounding_radius, 20);
+
+  /******** Air at the back of the front end cap ********/
+
+  G4VSolid *air_front_solid = rounded_box(model_name + "_air_front_solid", properties.end_cap_front_side_length - 2. * properties.end_cap_front_thickness, properties.end_cap_front_length - properties.end_cap_window_thickness - properties.end_cap_front_thickness - properties.vacuum_length, properties.end_cap_front_rounding_radius, 20);
+
+  model.air_front_logical = new G4LogicalVolume(air_front_solid, nist->FindOrBuildMaterial("G4_AIR"), model_name + "_air_front_logical");
+  model.air_front_logical->SetVisAttributes(G4Color::Red());
+
+  /******** Crystals ********/
+
+  G4Tubs *crystal_original = new G4Tubs(model_name + "_crystal_original", 0., properties.crystal_radius, properties.crystal_length * 0.5, 0., twopi);
+  G4Box *subtraction_solid = new G4Box(model_name + "_subtraction_solid", properties.crystal_radius, properties.crystal_radius, properties.crystal_length);
+  G4SubtractionSolid *crystal_step1_solid = new G4SubtractionSolid(model_name + "_crystal_step1_solid", crystal_original, subtraction_solid, 0, G4ThreeVector(properties.crystal_radius + 23. * mm, 0., 0.));
+  G4SubtractionSolid *crystal_step2_solid = new G4SubtractionSolid(model_name + "_crystal_step2_solid", crystal_step1_solid, subtraction_solid, 0, G4ThreeVector(-properties.crystal_radius - 22. * mm, 0., 0.));
+  G4SubtractionSolid *crystal_step3_solid = new G4SubtractionSolid(model_name + "_crystal_step3_solid", crystal_step2_solid, subtraction_solid, 0, G4ThreeVector(0., -properties.crystal_radius - 22. * mm, 0.));
+  model.crystal_solid = new G4SubtractionSolid(model_name + "_crystal_step4_solid", crystal_step3_solid, subtraction_solid, 0, G4ThreeVector(0., properties.crystal_radius + 23. * mm, 0.));
+
+  /******** Back end cap *********/
+
+  G4VSolid *end_cap_back_solid = rounded_box(model_name + "_end_cap_back_solid", properties.end_cap_back_side_length, properties.end_cap_back_length, properties.end_cap_back_rounding_radius, 20);
+  model.end_cap_back_logical = new G4LogicalVolume(end_cap_back_solid, nist->FindOrBuildMaterial(properties.end_cap_material), model_name + "_end_cap_back_logical");
+
+  /******** Air inside the back end cap ********/
+
+  G4VSolid *air_back_solid = rounded_box(model_name + "_air_back_solid", properties.end_cap_back_side_length - 2. * properties.end_cap_back_thickness, properties.end_cap_back_length - 2. * properties.end_cap_back_thickness, properties.end_cap_back_rounding_radius, 20);
+
+  G4LogicalVolume *air_back_logical = new G4LogicalVolume(air_back_solid, nist->FindOrBuildMaterial("G4_AIR"), model_name + "_air_back_logical");
+  air_back_logical->SetVisAttributes(G4Color::Red());
+  new G4PVPlacement(0, G4ThreeVector(0., 0., -0.5 * properties.end_cap_back_length + properties.end_cap_back_thickness + 0.5 * (properties.end_cap_back_length - 2. * properties.end_cap_back_thickness)), air_back_logical, model_name + "_air_back", model.end_cap_back_logical, 0, 0, false);
+
+  model.connection_logical = nullptr;
+  model.dewar_logical = nullptr;
+  if (use_dewar) {
+    /************* Connection dewar-detector *************/
+    G4Tubs *connection_solid = new G4Tubs(model_name + "_dewar_connection_solid", 0., properties.connection_radius, properties.connection_length * 0.5, 0., twopi);
+    model.connection_logical = new G4LogicalVolume(connection_solid, nist->FindOrBuildMaterial(properties.connection_material), model_name + "_dewar_connection_logical");
+    model.connection_logical->SetVisAttributes(new G4VisAttributes(G4Color::White()));
+
+    /************* Dewar *************/
+
+    // Dewar face
+    G4Tubs *dewar_solid = new G4Tubs(model_name + "_dewar_solid", 0., properties.dewar_outer_radius, properties.dewar_length * 0.5, 0., twopi);
+    model.dewar_logical = new G4LogicalVolume(dewar_solid, nist->FindOrBuildMaterial(properties.dewar_material), model_name + "_dewar_logical");
+    model.dewar_logical->SetVisAttributes(G4Color::Brown());
+
+    // Dewar interior
+    G4Tubs *dewar_interior_solid = new G4Tubs(model_name + "_dewar_interior_solid", 0., properties.dewar_outer_radius - properties.dewar_wall_thickness, properties.dewar_length * 0.5 - properties.dewar_wall_thickness, 0., twopi);
+    G4LogicalVolume *dewar_interior_logical = new G4LogicalVolume(dewar_interior_solid, nist->FindOrBuildMaterial("G4_N"), model_name + "_dewar_interior_logical");
+    dewar_interior_logical->SetVisAttributes(G4Color::Red());
+    new G4PVPlacement(0, G4ThreeVector(0., 0., 0.), dewar_interior_logical, model_name + "_dewar_interior", model.dewar_logical, 0, 0, false);
+  }
+
+  models.push_back(model);
+  return models.back();
+}
+
 void HPGe_Clover::Construct(G4ThreeVector global_coordinates, G4double theta, G4double phi, G4double dist_from_center, G4double intrinsic_rotation_angle) const {
 
   G4NistManager *nist = G4NistManager::Instance();
@@ -50,117 +164,63 @@ void HPGe_Clover::Construct(G4ThreeVector global_coordinates, G4double theta, G4
     rotation->rotateZ(intrinsic_rotation_angle);
   }
 
+  // All passive parts which do not depend on the placement are shared with other detectors of the same model
+  const Model &model = Get_Model();
+
   /******** Front end cap *********/
 
-  G4VSolid *end_cap_front_solid = rounded_box("_end_cap_front_solid", properties.end_cap_front_side_length, properties.end_cap_front_length, properties.end_cap_front_rounding_radius, 20);
-  G4LogicalVolume *end_cap_front_logical = new G4LogicalVolume(end_cap_front_solid, nist->FindOrBuildMaterial(properties.end_cap_material), detector_name + "_end_cap_front_logical");
+  G4LogicalVolume *end_cap_front_logical = new G4LogicalVolume(model.end_cap_front_solid, nist->FindOrBuildMaterial(properties.end_cap_material), detector_name + "_end_cap_front_logical");
   new G4PVPlacement(rotation, global_coordinates + (dist_from_center + 0.5 * properties.end_cap_front_length) * symmetry_axis, end_cap_front_logical, detector_name + "_end_cap_front", world_Logical, 0, 0, false);
 
   /******** Vacuum around crystal ********/
 
-  G4VSolid *vacuum_solid = rounded_box("_vacuum_solid", properties.end_cap_front_side_length - 2. * properties.end_cap_front_thickness, properties.vacuum_length, properties.end_cap_front_rounding_radius, 20);
-
-  G4LogicalVolume *vacuum_logical = new G4LogicalVolume(vacuum_solid, nist->FindOrBuildMaterial("G4_Galactic"), detector_name + "_vacuum_logical");
+  G4LogicalVolume *vacuum_logical = new G4LogicalVolume(model.vacuum_solid, nist->FindOrBuildMaterial("G4_Galactic"), detector_name + "_vacuum_logical");
   vacuum_logical->SetVisAttributes(G4Color::Cyan());
   new G4PVPlacement(0, G4ThreeVector(0., 0., -0.5 * properties.end_cap_front_length + properties.end_cap_window_thickness + 0.5 * properties.vacuum_length), vacuum_logical, detector_name + "_vacuum", end_cap_front_logical, 0, 0, false);
 
   /******** Air at the back of the front end cap ********/
 
-  G4VSolid *air_front_solid = rounded_box("_air_front_solid", properties.end_cap_front_side_length - 2. * properties.end_cap_front_thickness, properties.end_cap_front_length - properties.end_cap_window_thickness - properties.end_cap_front_thickness - properties.vacuum_length, properties.end_cap_front_rounding_radius, 20);
-
-  G4LogicalVolume *air_front_logical = new G4LogicalVolume(air_front_solid, nist->FindOrBuildMaterial("G4_AIR"), detector_name + "_air_front_logical");
-  air_front_logical->SetVisAttributes(G4Color::Red());
-  new G4PVPlacement(0, G4ThreeVector(0., 0., -0.5 * properties.end_cap_front_length + properties.end_cap_window_thickness + 0.5 * properties.vacuum_length + 0.5 * (properties.end_cap_front_length - properties.end_cap_front_thickness - properties.end_cap_window_thickness)), air_front_logical, detector_name + "_air_front", end_cap_front_logical, 0, 0, false);
+  new G4PVPlacement(0, G4ThreeVector(0., 0., -0.5 * properties.end_cap_front_length + properties.end_cap_window_thickness + 0.5 * properties.vacuum_length + 0.5 * (properties.end_cap_front_length - properties.end_cap_front_thickness - properties.end_cap_window_thickness)), model.air_front_logical, detector_name + "_air_front", end_cap_front_logical, 0, 0, false);
 
   /******** Crystals ********/
 
-  G4Tubs *crystal_original = new G4Tubs(detector_name + "_crystal_original", 0., properties.crystal_radius, properties.crystal_length * 0.5, 0., twopi);
-  G4Box *subtraction_solid = new G4Box(detector_name + "_subtraction_solid", properties.crystal_radius, properties.crystal_radius, properties.crystal_length);
-  G4SubtractionSolid *crystal_step1_solid = new G4SubtractionSolid(detector_name + "_crystal_step1_solid", crystal_original, subtraction_solid, 0, G4ThreeVector(properties.crystal_radius + 23. * mm, 0., 0.));
-  G4SubtractionSolid *crystal_step2_solid = new G4SubtractionSolid(detector_name + "_crystal_step2_solid", crystal_step1_solid, subtraction_solid, 0, G4ThreeVector(-properties.crystal_radius - 22. * mm, 0., 0.));
-  G4SubtractionSolid *crystal_step3_solid = new G4SubtractionSolid(detector_name + "_crystal_step3_solid", crystal_step2_solid, subtraction_solid, 0, G4ThreeVector(0., -properties.crystal_radius - 22. * mm, 0.));
-  G4SubtractionSolid *crystal_step4_solid = new G4SubtractionSolid(detector_name + "_crystal_step4_solid", crystal_step3_solid, subtraction_solid, 0, G4ThreeVector(0., properties.crystal_radius + 23. * mm, 0.));
-
-  G4LogicalVolume *crystal1_logical = new G4LogicalVolume(crystal_step4_solid, nist->FindOrBuildMaterial("G4_Ge"), detector_name + "_1");
+  G4LogicalVolume *crystal1_logical = new G4LogicalVolume(model.crystal_solid, nist->FindOrBuildMaterial("G4_Ge"), detector_name + "_1");
   crystal1_logical->SetVisAttributes(new G4VisAttributes(G4Color::Blue()));
   new G4PVPlacement(0, G4ThreeVector(22. * mm + 0.5 * properties.crystal_gap, 22. * mm + 0.5 * properties.crystal_gap, -0.5 * properties.vacuum_length + 0.5 * properties.crystal_length + properties.end_cap_to_crystal_gap_front), crystal1_logical, detector_name + "_crystal_1", vacuum_logical, 0, 0, false);
 
   G4RotationMatrix *rotate2 = new G4RotationMatrix();
   rotate2->rotateZ(-90. * deg);
-  G4LogicalVolume *crystal2_logical = new G4LogicalVolume(crystal_step4_solid, nist->FindOrBuildMaterial("G4_Ge"), detector_name + "_2");
+  G4LogicalVolume *crystal2_logical = new G4LogicalVolume(model.crystal_solid, nist->FindOrBuildMaterial("G4_Ge"), detector_name + "_2");
   crystal2_logical->SetVisAttributes(new G4VisAttributes(G4Color::Red()));
   new G4PVPlacement(rotate2, G4ThreeVector(-22. * mm - 0.5 * properties.crystal_gap, 22. * mm + 0.5 * properties.crystal_gap, -0.5 * properties.vacuum_length + 0.5 * properties.crystal_length + properties.end_cap_to_crystal_gap_front), crystal2_logical, detector_name + "_crystal_2", vacuum_logical, 0, 0, false);
 
   G4RotationMatrix *rotate3 = new G4RotationMatrix();
   rotate3->rotateZ(-180. * deg);
-  G4LogicalVolume *crystal3_logical = new G4LogicalVolume(crystal_step4_solid, nist->FindOrBuildMaterial("G4_Ge"), detector_name + "_3");
+  G4LogicalVolume *crystal3_logical = new G4LogicalVolume(model.crystal_solid, nist->FindOrBuildMaterial("G4_Ge"), detector_name + "_3");
   crystal3_logical->SetVisAttributes(new G4VisAttributes(G4Color::Green()));
   new G4PVPlacement(rotate3, G4ThreeVector(-22. * mm - 0.5 * properties.crystal_gap, -22. * mm - 0.5 * properties.crystal_gap, -0.5 * properties.vacuum_length + 0.5 * properties.crystal_length + properties.end_cap_to_crystal_gap_front), crystal3_logical, detector_name + "_crystal_3", vacuum_logical, 0, 0, false);
 
   G4RotationMatrix *rotate4 = new G4RotationMatrix();
   rotate4->rotateZ(-270. * deg);
-  G4LogicalVolume *crystal4_logical = new G4LogicalVolume(crystal_step4_solid, nist->FindOrBuildMaterial("G4_Ge"), detector_name + "_4");
+  G4LogicalVolume *crystal4_logical = new G4LogicalVolume(model.crystal_solid, nist->FindOrBuildMaterial("G4_Ge"), detector_name + "_4");
   crystal4_logical->SetVisAttributes(new G4VisAttributes(G4Color::Brown()));
   new G4PVPlacement(rotate4, G4ThreeVector(22. * mm + 0.5 * properties.crystal_gap, -22. * mm - 0.5 * properties.crystal_gap, -0.5 * properties.vacuum_length + 0.5 * properties.crystal_length + properties.end_cap_to_crystal_gap_front), crystal4_logical, detector_name + "_crystal_4", vacuum_logical, 0, 0, false);
 
   /******** Back end cap *********/
 
-  G4VSolid *end_cap_back_solid = rounded_box("_end_cap_back_solid", properties.end_cap_back_side_length, properties.end_cap_back_length, properties.end_cap_back_rounding_radius, 20);
-  G4LogicalVolume *end_cap_back_logical = new G4LogicalVolume(end_cap_back_solid, nist->FindOrBuildMaterial(properties.end_cap_material), detector_name + "_end_cap_back_logical");
-  new G4PVPlacement(rotation, global_coordinates + (dist_from_center + properties.end_cap_front_length + 0.5 * properties.end_cap_back_length) * symmetry_axis, end_cap_back_logical, detector_name + "_end_cap_back", world_Logical, 0, 0, false);
-
-  /******** Air inside the back end cap ********/
-
-  G4VSolid *air_back_solid = rounded_box("_air_back_solid", properties.end_cap_back_side_length - 2. * properties.end_cap_back_thickness, properties.end_cap_back_length - 2. * properties.end_cap_back_thickness, properties.end_cap_back_rounding_radius, 20);
-
-  G4LogicalVolume *air_back_logical = new G4LogicalVolume(air_back_solid, nist->FindOrBuildMaterial("G4_AIR"), detector_name + "_air_back_logical");
-  air_back_logical->SetVisAttributes(G4Color::Red());
-  new G4PVPlacement(0, G4ThreeVector(0., 0., -0.5 * properties.end_cap_back_length + properties.end_cap_back_thickness + 0.5 * (properties.end_cap_back_length - 2. * properties.end_cap_back_thickness)), air_back_logical, detector_name + "_air_back", end_cap_back_logical, 0, 0, false);
+  new G4PVPlacement(rotation, global_coordinates + (dist_from_center + properties.end_cap_front_length + 0.5 * properties.end_cap_back_length) * symmetry_axis, model.end_cap_back_logical, detector_name + "_end_cap_back", world_Logical, 0, 0, false);
 
   if (use_dewar) {
     /************* Connection dewar-detector *************/
-    G4Tubs *connection_solid = new G4Tubs(detector_name + "_dewar_connection_solid", 0., properties.connection_radius, properties.connection_length * 0.5, 0., twopi);
-    G4LogicalVolume *connection_logical = new G4LogicalVolume(connection_solid, nist->FindOrBuildMaterial(properties.connection_material), detector_name + "_dewar_connection_logical");
-    connection_logical->SetVisAttributes(new G4VisAttributes(G4Color::White()));
-    new G4PVPlacement(rotation, global_coordinates + (dist_from_center + properties.end_cap_front_length + properties.end_cap_back_length + properties.connection_length * 0.5) * symmetry_axis, connection_logical, detector_name + "_dewar_connection", world_Logical, 0, 0, false);
+    new G4PVPlacement(rotation, global_coordinates + (dist_from_center + properties.end_cap_front_length + properties.end_cap_back_length + properties.connection_length * 0.5) * symmetry_axis, model.connection_logical, detector_name + "_dewar_connection", world_Logical, 0, 0, false);
 
     /************* Dewar *************/
-
-    // Dewar face
-    G4Tubs *dewar_solid = new G4Tubs(detector_name + "_dewar_solid", 0., properties.dewar_outer_radius, properties.dewar_length * 0.5, 0., twopi);
-    G4LogicalVolume *dewar_logical = new G4LogicalVolume(dewar_solid, nist->FindOrBuildMaterial(properties.dewar_material), detector_name + "_dewar_logical");
-    dewar_logical->SetVisAttributes(G4Color::Brown());
-    new G4PVPlacement(rotation, global_coordinates + (dist_from_center + properties.end_cap_front_length + properties.end_cap_back_length + properties.connection_length + properties.dewar_length * 0.5) * symmetry_axis, dewar_logical, detector_name + "_dewar", world_Logical, 0, 0, false);
-
-    // Dewar interior
-    G4Tubs *dewar_interior_solid = new G4Tubs(detector_name + "_dewar_interior_solid", 0., properties.dewar_outer_radius - properties.dewar_wall_thickness, properties.dewar_length * 0.5 - properties.dewar_wall_thickness, 0., twopi);
-    G4LogicalVolume *dewar_interior_logical = new G4LogicalVolume(dewar_interior_solid, nist->FindOrBuildMaterial("G4_N"), detector_name + "_dewar_interior_logical");
-    dewar_interior_logical->SetVisAttributes(G4Color::Red());
-    new G4PVPlacement(0, G4ThreeVector(0., 0., 0.), dewar_interior_logical, detector_name + "_dewar_interior", dewar_logical, 0, 0, false);
+    new G4PVPlacement(rotation, global_coordinates + (dist_from_center + properties.end_cap_front_length + properties.end_cap_back_length + properties.connection_length + properties.dewar_length * 0.5) * symmetry_axis, model.dewar_logical, detector_name + "_dewar", world_Logical, 0, 0, false);
   }
 
   /************* Filters *************/
-  G4double filter_position_z = 0.; // Will be gradually increased to be able to place filters on top of each other
-  if (filter_materials.size()) {
-    G4Box *filter_solid = nullptr;
-    G4LogicalVolume *filter_logical = nullptr;
-    G4double filter_half_length;
-    stringstream filter_base_name_ss;
-    for (unsigned int i = 0; i < filter_materials.size(); ++i) {
-      filter_half_length = (filter_radii[i] < 0.) ? properties.end_cap_front_side_length / 2. : filter_radii[i]; // A negative filter "radius" (half-length) value tells us to use the detector front size as the filter size
-      filter_base_name_ss << detector_name << "_filter_" << i + 1 << "_" << filter_materials[i] << "_" << filter_thicknesses[i] / mm << "mm_x_" << 2 * filter_half_length / mm << "mm";
-      filter_solid = new G4Box(filter_base_name_ss.str() + "_solid", filter_half_length, filter_half_length, filter_thicknesses[i] / 2.);
-      filter_logical = new G4LogicalVolume(filter_solid, nist->FindOrBuildMaterial(filter_materials[i]), filter_base_name_ss.str() + "_logical");
-      if (i % 2 == 0) {
-        filter_logical->SetVisAttributes(G4Color::Red());
-      } else {
-        filter_logical->SetVisAttributes(G4Color::Green());
-      }
-      new G4PVPlacement(rotation, global_coordinates + (dist_from_center - filter_position_z - filter_thicknesses[i] / 2.) * symmetry_axis, filter_logical, filter_base_name_ss.str(), world_Logical, 0, 0, false);
-      filter_position_z = filter_position_z + filter_thicknesses[i];
-      filter_base_name_ss.str("");
-    }
-  }
+  // The filters of the clover are square plates. A negative filter "radius" (half side length) tells us to use the detector front size.
+  Construct_Filters(rotation, global_coordinates, symmetry_axis, dist_from_center, properties.end_cap_front_side_length / 2., true);
 }
 
 void HPGe_Clover::Construct(G4ThreeVector global_coordinates, G4double theta, G4double phi, G4double dist_from_center) const {
@@ -18,84 +18,185 @@ You should have received a copy of the GNU General Public License
 along with utr.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <exception>
 #include <sstream>
 
 #include "G4Color.hh"
+#include "G4MultiUnion.hh"
 #include "G4NistManager.hh"
+#include "G4Orb.hh"
 #include "G4PVPlacement.hh"
 #include "G4PhysicalConstants.hh"
 #include "G4Polycone.hh"
+#include "G4SubtractionSolid.hh"
+#include "G4Torus.hh"
+#include "G4Transform3D.hh"
 #include "G4Tubs.hh"
 #include "G4VisAttributes.hh"
 
 #include "Filter_Case.hh"
 #include "HPGe_Coaxial.hh"
 #include "OptimizePolycone.hh"
+#include "utrConfig.h"
 
 using std::stringstream;
 
-void HPGe_Coaxial::Construct(G4ThreeVector global_coordinates, G4double theta, G4double phi, G4double dist_from_center, G4double intrinsic_rotation_angle) const {
+vector<HPGe_Coaxial::Model> HPGe_Coaxial::models;
+
+bool HPGe_Coaxial::Is_Same_Model(const HPGe_Coaxial_Properties &a, const HPGe_Coaxial_Properties &b, bool with_dewar) {
+  // Compare only the properties which enter the construction of the shared volumes.
+  // The dewar properties are not necessarily set if a detector is used without a dewar.
+  bool same = a.detector_radius == b.detector_radius &&
+              a.detector_length == b.detector_length &&
+              a.detector_face_radius == b.detector_face_radius &&
+              a.hole_radius == b.hole_radius &&
+              a.hole_depth == b.hole_depth &&
+              a.mount_cup_length == b.mount_cup_length &&
+              a.mount_cup_thickness == b.mount_cup_thickness &&
+              a.mount_cup_base_thickness == b.mount_cup_base_thickness &&
+              a.mount_cup_material == b.mount_cup_material &&
+              a.end_cap_to_crystal_gap_front == b.end_cap_to_crystal_gap_front &&
+              a.end_cap_to_crystal_gap_side == b.end_cap_to_crystal_gap_side &&
+              a.end_cap_thickness == b.end_cap_thickness &&
+              a.end_cap_window_thickness == b.end_cap_window_thickness &&
+              a.end_cap_material == b.end_cap_material &&
+              a.end_cap_window_material == b.end_cap_window_material &&
+              a.cold_finger_radius == b.cold_finger_radius &&
+              a.cold_finger_penetration_depth == b.cold_finger_penetration_depth &&
+              a.cold_finger_material == b.cold_finger_material;
+  if (same && with_dewar) {
+    same = a.connection_length == b.connection_length &&
+           a.connection_radius == b.connection_radius &&
+           a.connection_material == b.connection_material &&
+           a.dewar_length == b.dewar_length &&
+           a.dewar_outer_radius == b.dewar_outer_radius &&
+           a.dewar_wall_thickness == b.dewar_wall_thickness &&
+           a.dewar_material == b.dewar_material;
+  }
+  return same;
+}
 
-  G4NistManager *nist = G4NistManager::Instance();
-  G4ThreeVector symmetry_axis(sin(theta) * cos(phi), sin(theta) * sin(phi), cos(theta)); // Symmetry axis along which the single elements of the detector are constructed
-  G4ThreeVector symmetry_axis_orthogonal(cos(theta) * cos(phi), cos(theta) * sin(phi), -sin(theta)); // Vector which is orthogonal to the symmetry axes. Needed for the construction of off-axis elements. As an arbitrary choice, take the unit vector with respect to theta in spherical coordinates.
+G4VSolid *HPGe_Coaxial::Crystal_Solid(const HPGe_Coaxial_Properties &properties, const G4String &name, bool csg) {
+  if (csg) {
+    // Outer shape: a cylinder whose edge at the face is rounded by a torus. The inner part of the
+    // rounded slice is filled by a thin cylinder.
+    G4double face_radius = properties.detector_face_radius > 0. ? properties.detector_face_radius : 0.;
+    G4double body_length = properties.detector_length - face_radius;
+
+    // The torus intersects itself if its swept radius is smaller than the radius of its tube
+    if (properties.detector_radius < 2. * face_radius) {
+      G4cerr << "Error: HPGe_Coaxial: The CSG solid of " << name << " requires detector_radius (" << properties.detector_radius / mm << " mm) >= 2 * detector_face_radius (" << face_radius / mm << " mm). Use the polycone solid instead (USE_CSG_CRYSTALS=OFF)." << G4endl;
+      throw std::exception();
+    }
+    if (body_length <= 0.) {
+      G4cerr << "Error: HPGe_Coaxial: The CSG solid of " << name << " requires detector_length (" << properties.detector_length / mm << " mm) > detector_face_radius (" << face_radius / mm << " mm)." << G4endl;
+      throw std::exception();
+    }
 
-  G4RotationMatrix *rotation = new G4RotationMatrix();
-  rotation->rotateZ(-phi);
-  rotation->rotateY(-theta);
-  if (intrinsic_rotation_angle != 0.) {
-    rotation->rotateZ(intrinsic_rotation_angle);
+    G4MultiUnion *body_solid = new G4MultiUnion(name + "_body");
+    G4Tubs *body_side_solid = new G4Tubs(name + "_body_side", 0., properties.detector_radius, body_length * 0.5, 0., twopi);
+    G4Transform3D body_side_transform(G4RotationMatrix(), G4ThreeVector(0., 0., face_radius + body_length * 0.5));
+    body_solid->AddNode(*body_side_solid, body_side_transform);
+    if (face_radius > 0.) {
+      G4Tubs *body_face_solid = new G4Tubs(name + "_body_face", 0., properties.detector_radius - face_radius, face_radius * 0.5, 0., twopi);
+      G4Transform3D body_face_transform(G4RotationMatrix(), G4ThreeVector(0., 0., face_radius * 0.5));
+      body_solid->AddNode(*body_face_solid, body_face_transform);
+
+      G4Torus *body_edge_solid = new G4Torus(name + "_body_edge", 0., face_radius, properties.detector_radius - face_radius, 0., twopi);
+      G4Transform3D body_edge_transform(G4RotationMatrix(), G4ThreeVector(0., 0., face_radius));
+      body_solid->AddNode(*body_edge_solid, body_edge_transform);
+    }
+    body_solid->Voxelize();
+
+    if (properties.hole_radius <= 0. || properties.hole_depth <= 0.) {
+      return body_solid;
+    }
+
+    // Hole: a cylinder with a hemispherical tip. The cylinder sticks out of the base of the crystal
+    // to avoid coincident surfaces in the subtraction.
+    if (properties.hole_depth < properties.hole_radius || properties.hole_depth >= properties.detector_length || properties.hole_radius >= properties.detector_radius) {
+      G4cerr << "Error: HPGe_Coaxial: The CSG solid of " << name << " requires hole_radius (" << properties.hole_radius / mm << " mm) <= hole_depth (" << properties.hole_depth / mm << " mm) < detector_length (" << properties.detector_length / mm << " mm) and hole_radius < detector_radius (" << properties.detector_radius / mm << " mm)." << G4endl;
+      throw std::exception();
+    }
+    G4double hole_tip_z = properties.detector_length - properties.hole_depth + properties.hole_radius;
+    G4double hole_side_length = properties.detector_length - hole_tip_z + 1. * mm;
+
+    G4MultiUnion *hole_solid = new G4MultiUnion(name + "_hole");
+    G4Tubs *hole_side_solid = new G4Tubs(name + "_hole_side", 0., properties.hole_radius, hole_side_length * 0.5, 0., twopi);
+    G4Transform3D hole_side_transform(G4RotationMatrix(), G4ThreeVector(0., 0., hole_tip_z + hole_side_length * 0.5));
+    hole_solid->AddNode(*hole_side_solid, hole_side_transform);
+    G4Orb *hole_tip_solid = new G4Orb(name + "_hole_tip", properties.hole_radius);
+    G4Transform3D hole_tip_transform(G4RotationMatrix(), G4ThreeVector(0., 0., hole_tip_z));
+    hole_solid->AddNode(*hole_tip_solid, hole_tip_transform);
+    hole_solid->Voxelize();
+
+    return new G4SubtractionSolid(name, body_solid, hole_solid);
   }
 
-  /************* End cap *************/
-  // End cap side
-  G4double end_cap_inner_radius = properties.detector_radius + properties.mount_cup_thickness + properties.end_cap_to_crystal_gap_side;
-  G4double end_cap_outer_radius = properties.detector_radius + properties.mount_cup_thickness + properties.end_cap_to_crystal_gap_side + properties.end_cap_thickness;
-  G4double end_cap_side_length = properties.mount_cup_length + properties.end_cap_to_crystal_gap_front;
+  const G4int nsteps = 500;
 
-  G4Tubs *end_cap_side_solid = new G4Tubs(detector_name + "_end_cap_side_solid", end_cap_inner_radius, end_cap_outer_radius, end_cap_side_length * 0.5, 0., twopi);
-  G4LogicalVolume *end_cap_side_logical = new G4LogicalVolume(end_cap_side_solid, nist->FindOrBuildMaterial(properties.end_cap_material), detector_name + "_end_cap_side_logical");
-  end_cap_side_logical->SetVisAttributes(new G4VisAttributes(G4Color::White()));
-  new G4PVPlacement(rotation, global_coordinates + (dist_from_center + properties.end_cap_window_thickness + end_cap_side_length * 0.5) * symmetry_axis, end_cap_side_logical, detector_name + "_end_cap_side", world_Logical, 0, 0, false);
+  G4double zPlaneTemp[nsteps];
+  G4double rInnerTemp[nsteps];
+  G4double rOuterTemp[nsteps];
 
-  // End cap window
-  G4Tubs *end_cap_window_solid = new G4Tubs(detector_name + "_end_cap_window_solid", 0., end_cap_outer_radius, properties.end_cap_window_thickness * 0.5, 0., twopi);
-  G4LogicalVolume *end_cap_window_logical = new G4LogicalVolume(end_cap_window_solid, nist->FindOrBuildMaterial(properties.end_cap_window_material), detector_name + "_end_cap_window_logical");
-  end_cap_window_logical->SetVisAttributes(new G4VisAttributes(G4Color::White()));
-  new G4PVPlacement(rotation, global_coordinates + (dist_from_center + properties.end_cap_window_thickness * 0.5) * symmetry_axis, end_cap_window_logical, detector_name + "_end_cap_window", world_Logical, 0, 0, false);
+  G4double z;
 
-  // Vacuum inside end cap
-  G4Tubs *end_cap_vacuum_solid = new G4Tubs(detector_name + "_end_cap_vacuum_solid", 0., end_cap_inner_radius, end_cap_side_length * 0.5, 0., twopi);
-  G4LogicalVolume *end_cap_vacuum_logical = new G4LogicalVolume(end_cap_vacuum_solid, nist->FindOrBuildMaterial("G4_Galactic"), detector_name + "_end_cap_vacuum_logical");
-  end_cap_vacuum_logical->SetVisAttributes(G4VisAttributes::GetInvisible());
-  new G4PVPlacement(rotation, global_coordinates + (dist_from_center + properties.end_cap_window_thickness + end_cap_side_length * 0.5) * symmetry_axis, end_cap_vacuum_logical, detector_name + "_end_cap_vacuum", world_Logical, 0, 0, false);
+  for (int i = 0; i < nsteps; i++) {
+    z = (1. - (double)i / (nsteps - 1)) * properties.detector_length;
 
-  /************* Mount cup *************/
-  // Mount cup side
-  G4double mount_cup_inner_radius = properties.detector_radius;
-  G4double mount_cup_outer_radius = properties.detector_radius + properties.mount_cup_thickness;
-  G4double mount_cup_side_length = properties.mount_cup_length - properties.mount_cup_thickness - properties.mount_cup_base_thickness;
+    zPlaneTemp[i] = z;
+
+    // rInnerTemp[i] = 0. * mm;
+    if (z >= properties.detector_length - properties.hole_depth) {
+      if (z >= properties.detector_length - properties.hole_depth + properties.hole_radius) {
+        rInnerTemp[i] = properties.hole_radius;
+      } else {
+        rInnerTemp[i] = properties.hole_radius * sqrt(1. - pow((z - (properties.detector_length - properties.hole_depth + properties.hole_radius)) / properties.hole_radius, 2));
+      }
+    } else {
+      rInnerTemp[i] = 0.;
+    }
 
-  G4Tubs *mount_cup_side_solid = new G4Tubs(detector_name + "_mount_cup_side_solid", mount_cup_inner_radius, mount_cup_outer_radius, mount_cup_side_length * 0.5, 0., twopi);
-  G4LogicalVolume *mount_cup_side_logical = new G4LogicalVolume(mount_cup_side_solid, nist->FindOrBuildMaterial(properties.mount_cup_material), detector_name + "_mount_cup_side_logical");
-  mount_cup_side_logical->SetVisAttributes(new G4VisAttributes(G4Color::Cyan()));
-  new G4PVPlacement(0, G4ThreeVector(0., 0., -end_cap_side_length * 0.5 + properties.end_cap_to_crystal_gap_front + properties.mount_cup_thickness + mount_cup_side_length * 0.5), mount_cup_side_logical, detector_name + "_mount_cup_side", end_cap_vacuum_logical, 0, 0, false);
+    if (z >= properties.detector_face_radius) {
+      rOuterTemp[i] = properties.detector_radius;
+    } else if (z >= 0.) {
+      rOuterTemp[i] = properties.detector_face_radius * sqrt(1. - pow((z - properties.detector_face_radius) / properties.detector_face_radius, 2)) + (properties.detector_radius - properties.detector_face_radius);
+    } else {
+      rOuterTemp[i] = 0. * mm;
+    }
+  }
 
-  // Mount cup face
-  G4Tubs *mount_cup_face_solid = new G4Tubs(detector_name + "_mount_cup_face_solid", 0., mount_cup_outer_radius, properties.mount_cup_thickness * 0.5, 0., twopi);
-  G4LogicalVolume *mount_cup_face_logical = new G4LogicalVolume(mount_cup_face_solid, nist->FindOrBuildMaterial(properties.mount_cup_material), detector_name + "_mount_cup_face_logical");
-  mount_cup_face_logical->SetVisAttributes(new G4VisAttributes(G4Color::Cyan()));
-  new G4PVPlacement(0, G4ThreeVector(0., 0., -end_cap_side_length * 0.5 + properties.end_cap_to_crystal_gap_front + properties.mount_cup_thickness * 0.5), mount_cup_face_logical, detector_name + "_mount_cup_face", end_cap_vacuum_logical, 0, 0, false);
+  G4double zPlane[nsteps];
+  G4double rInner[nsteps];
+  G4double rOuter[nsteps];
 
-  // Mount cup base
-  G4Tubs *mount_cup_base_solid = new G4Tubs(detector_name + "_mount_cup_base_solid", properties.hole_radius, mount_cup_outer_radius, properties.mount_cup_base_thickness * 0.5, 0., twopi);
-  G4LogicalVolume *mount_cup_base_logical = new G4LogicalVolume(mount_cup_base_solid, nist->FindOrBuildMaterial(properties.mount_cup_material), detector_name + "_mount_cup_base_logical");
-  mount_cup_base_logical->SetVisAttributes(new G4VisAttributes(G4Color::Cyan()));
-  new G4PVPlacement(0, G4ThreeVector(0., 0., -end_cap_side_length * 0.5 + properties.end_cap_to_crystal_gap_front + properties.mount_cup_thickness + mount_cup_side_length + 0.5 * properties.mount_cup_base_thickness), mount_cup_base_logical, detector_name + "_mount_cup_base", end_cap_vacuum_logical, 0, 0, false);
+  OptimizePolycone *opt = new OptimizePolycone();
+  G4int nsteps_optimized = opt->Optimize(zPlaneTemp, rInnerTemp, rOuterTemp, zPlane, rInner, rOuter, nsteps, name);
+  delete opt;
 
-  /************* Cold finger *************/
+  return new G4Polycone(name, 0. * deg, 360. * deg, nsteps_optimized, zPlane, rInner, rOuter);
+}
 
-  G4double cold_finger_length = properties.cold_finger_penetration_depth + mount_cup_side_length + properties.mount_cup_base_thickness - properties.detector_length;
+G4VSolid *HPGe_Coaxial::Cold_Finger_Solid(const HPGe_Coaxial_Properties &properties, G4double cold_finger_length, const G4String &name, bool csg) {
+  if (csg) {
+    // A cylinder with a hemispherical tip
+    G4double side_length = cold_finger_length - properties.cold_finger_radius;
+    if (properties.cold_finger_radius <= 0. || side_length <= 0.) {
+      G4cerr << "Error: HPGe_Coaxial: The CSG solid of " << name << " requires 0 < cold_finger_radius (" << properties.cold_finger_radius / mm << " mm) < cold finger length (" << cold_finger_length / mm << " mm)." << G4endl;
+      throw std::exception();
+    }
+
+    G4MultiUnion *cold_finger_solid = new G4MultiUnion(name);
+    G4Tubs *side_solid = new G4Tubs(name + "_side", 0., properties.cold_finger_radius, side_length * 0.5, 0., twopi);
+    G4Transform3D side_transform(G4RotationMatrix(), G4ThreeVector(0., 0., properties.cold_finger_radius + side_length * 0.5));
+    cold_finger_solid->AddNode(*side_solid, side_transform);
+    G4Orb *tip_solid = new G4Orb(name + "_tip", properties.cold_finger_radius);
+    G4Transform3D tip_transform(G4RotationMatrix(), G4ThreeVector(0., 0., properties.cold_finger_radius));
+    cold_finger_solid->AddNode(*tip_solid, tip_transform);
+    cold_finger_solid->Voxelize();
+
+    return cold_finger_solid;
+  }
 
   const G4int nsteps = 500;
 
@@ -126,72 +227,177 @@ void HPGe_Coaxial::Construct(G4ThreeVector global_coordinates, G4double theta, G
   G4double rOuter[nsteps];
 
   OptimizePolycone *opt = new OptimizePolycone();
-  G4int nsteps_optimized = opt->Optimize(zPlaneTemp, rInnerTemp, rOuterTemp, zPlane, rInner, rOuter, nsteps, detector_name + "_cold_finger_solid");
+  G4int nsteps_optimized = opt->Optimize(zPlaneTemp, rInnerTemp, rOuterTemp, zPlane, rInner, rOuter, nsteps, name);
+  delete opt;
+
+  return new G4Polycone(name, 0. * deg, 360. * deg, nsteps_optimized, zPlane, rInner, rOuter);
+}
+
+const HPGe_Coaxial::Model &HPGe_Coaxial::Get_Model() const {
+  for (auto &model : models) {
+    if (model.with_dewar == use_dewar && Is_Same_Model(model.properties, properties, use_dewar)) {
+      return model;
+    }
+  }
+
+  G4NistManager *nist = G4NistManager::Instance();
+
+  Model model;
+  model.properties = properties;
+  model.with_dewar = use_dewar;
+
+  stringstream model_name_ss;
+  model_name_ss << "HPGe_Coaxial_model_" << models.size();
+  const G4String model_name = model_name_ss.str();
+
+  G4cout << "HPGe_Coaxial: Constructing " << model_name << " for " << detector_name << G4endl;
+
+#ifdef USE_CSG_CRYSTALS
+  const bool use_csg = true;
+#else
+  const bool use_csg = false;
+#endif
+
+  /************* End cap *************/
+  // End cap side
+  G4double end_cap_inner_radius = properties.detector_radius + properties.mount_cup_thickness + properties.end_cap_to_crystal_gap_side;
+  G4double end_cap_outer_radius = properties.detector_radius + properties.mount_cup_thickness + properties.end_cap_to_crystal_gap_side + properties.end_cap_thickness;
+  G4double end_cap_side_length = properties.mount_cup_length + properties.end_cap_to_crystal_gap_front;
+
+  G4Tubs *end_cap_side_solid = new G4Tubs(model_name + "_end_cap_side_solid", end_cap_inner_radius, end_cap_outer_radius, end_cap_side_length * 0.5, 0., twopi);
+  model.end_cap_side_logical = new G4LogicalVolume(end_cap_side_solid, nist->FindOrBuildMaterial(properties.end_cap_material), model_name + "_end_cap_side_logical");
+  model.end_cap_side_logical->SetVisAttributes(new G4VisAttributes(G4Color::White()));
+
+  // End cap window
+  G4Tubs *end_cap_window_solid = new G4Tubs(model_name + "_end_cap_window_solid", 0., end_cap_outer_radius, properties.end_cap_window_thickness * 0.5, 0., twopi);
+  model.end_cap_window_logical = new G4LogicalVolume(end_cap_window_solid, nist->FindOrBuildMaterial(properties.end_cap_window_material), model_name + "_end_cap_window_logical");
+  model.end_cap_window_logical->SetVisAttributes(new G4VisAttributes(G4Color::White()));
 
-  G4Polycone *cold_finger_solid = new G4Polycone(detector_name + "_cold_finger_solid", 0. * deg, 360. * deg, nsteps_optimized, zPlane, rInner, rOuter);
+  // Vacuum inside end cap
+  model.end_cap_vacuum_solid = new G4Tubs(model_name + "_end_cap_vacuum_solid", 0., end_cap_inner_radius, end_cap_side_length * 0.5, 0., twopi);
+
+  /************* Mount cup *************/
+  // Mount cup side
+  G4double mount_cup_inner_radius = properties.detector_radius;
+  G4double mount_cup_outer_radius = properties.detector_radius + properties.mount_cup_thickness;
+  G4double mount_cup_side_length = properties.mount_cup_length - properties.mount_cup_thickness - properties.mount_cup_base_thickness;
+
+  G4Tubs *mount_cup_side_solid = new G4Tubs(model_name + "_mount_cup_side_solid", mount_cup_inner_radius, mount_cup_outer_radius, mount_cup_side_length * 0.5, 0., twopi);
+  model.mount_cup_side_logical = new G4LogicalVolume(mount_cup_side_solid, nist->FindOrBuildMaterial(properties.mount_cup_material), model_name + "_mount_cup_side_logical");
+  model.mount_cup_side_logical->SetVisAttributes(new G4VisAttributes(G4Color::Cyan()));
 
-  G4LogicalVolume *cold_finger_logical = new G4LogicalVolume(cold_finger_solid, nist->FindOrBuildMaterial(properties.cold_finger_material), detector_name + "_cold_finger_logical", 0, 0, 0);
+  // Mount cup face
+  G4Tubs *mount_cup_face_solid = new G4Tubs(model_name + "_mount_cup_face_solid", 0., mount_cup_outer_radius, properties.mount_cup_thickness * 0.5, 0., twopi);
+  model.mount_cup_face_logical = new G4LogicalVolume(mount_cup_face_solid, nist->FindOrBuildMaterial(properties.mount_cup_material), model_name + "_mount_cup_face_logical");
+  model.mount_cup_face_logical->SetVisAttributes(new G4VisAttributes(G4Color::Cyan()));
 
-  cold_finger_logical->SetVisAttributes(new G4VisAttributes(G4Color(1.0, 0.5, 0.0)));
+  // Mount cup base
+  G4Tubs *mount_cup_base_solid = new G4Tubs(model_name + "_mount_cup_base_solid", properties.hole_radius, mount_cup_outer_radius, properties.mount_cup_base_thickness * 0.5, 0., twopi);
+  model.mount_cup_base_logical = new G4LogicalVolume(mount_cup_base_solid, nist->FindOrBuildMaterial(properties.mount_cup_material), model_name + "_mount_cup_base_logical");
+  model.mount_cup_base_logical->SetVisAttributes(new G4VisAttributes(G4Color::Cyan()));
 
-  new G4PVPlacement(0, G4ThreeVector(0., 0., end_cap_side_length * 0.5 - cold_finger_length), cold_finger_logical, detector_name + "_cold_finger", end_cap_vacuum_logical, 0, 0, false);
+  /************* Cold finger *************/
+
+  G4double cold_finger_length = properties.cold_finger_penetration_depth + mount_cup_side_length + properties.mount_cup_base_thickness - properties.detector_length;
+
+  G4VSolid *cold_finger_solid = Cold_Finger_Solid(properties, cold_finger_length, model_name + "_cold_finger_solid", use_csg);
+  model.cold_finger_logical = new G4LogicalVolume(cold_finger_solid, nist->FindOrBuildMaterial(properties.cold_finger_material), model_name + "_cold_finger_logical", 0, 0, 0);
+  model.cold_finger_logical->SetVisAttributes(new G4VisAttributes(G4Color(1.0, 0.5, 0.0)));
 
   /************* Detector crystal *************/
 
-  for (int i = 0; i < nsteps; i++) {
-    z = (1. - (double)i / (nsteps - 1)) * properties.detector_length;
+  model.crystal_solid = Crystal_Solid(properties, model_name + "_crystal_solid", use_csg);
 
-    zPlaneTemp[i] = z;
+  model.connection_logical = nullptr;
+  model.dewar_logical = nullptr;
+  if (use_dewar) {
+    /************* Connection dewar-detector *************/
+    G4Tubs *connection_solid = new G4Tubs(model_name + "_dewar_connection_solid", 0., properties.connection_radius, properties.connection_length * 0.5, 0., twopi);
+    model.connection_logical = new G4LogicalVolume(connection_solid, nist->FindOrBuildMaterial(properties.connection_material), model_name + "_dewar_connection_logical");
+    model.connection_logical->SetVisAttributes(new G4VisAttributes(G4Color::White()));
 
-    // rInnerTemp[i] = 0. * mm;
-    if (z >= properties.detector_length - properties.hole_depth) {
-      if (z >= properties.detector_length - properties.hole_depth + properties.hole_radius) {
-        rInnerTemp[i] = properties.hole_radius;
-      } else {
-        rInnerTemp[i] = properties.hole_radius * sqrt(1. - pow((z - (properties.detector_length - properties.hole_depth + properties.hole_radius)) / properties.hole_radius, 2));
-      }
-    } else {
-      rInnerTemp[i] = 0.;
-    }
+    /************* Dewar *************/
+    // Dewar face
+    G4Tubs *dewar_solid = new G4Tubs(model_name + "_dewar_solid", 0., properties.dewar_outer_radius, properties.dewar_length * 0.5, 0., twopi);
+    model.dewar_logical = new G4LogicalVolume(dewar_solid, nist->FindOrBuildMaterial(properties.dewar_material), model_name + "_dewar_logical");
+    model.dewar_logical->SetVisAttributes(G4Color::Brown());
 
-    if (z >= properties.detector_face_radius) {
-      rOuterTemp[i] = properties.detector_radius;
-    } else if (z >= 0.) {
-      rOuterTemp[i] = properties.detector_face_radius * sqrt(1. - pow((z - properties.detector_face_radius) / properties.detector_face_radius, 2)) + (properties.detector_radius - properties.detector_face_radius);
-    } else {
-      rOuterTemp[i] = 0. * mm;
-    }
+    // Dewar interior
+    G4Tubs *dewar_interior_solid = new G4Tubs(model_name + "_dewar_interior_solid", 0., properties.dewar_outer_radius - properties.dewar_wall_thickness, properties.dewar_length * 0.5 - properties.dewar_wall_thickness, 0., twopi);
+    G4LogicalVolume *dewar_interior_logical = new G4LogicalVolume(dewar_interior_solid, nist->FindOrBuildMaterial("G4_N"), model_name + "_dewar_interior_logical");
+    dewar_interior_logical->SetVisAttributes(G4Color::Red());
+    new G4PVPlacement(0, G4ThreeVector(0., 0., 0.), dewar_interior_logical, model_name + "_dewar_interior", model.dewar_logical, 0, 0, false);
+  }
+
+  models.push_back(model);
+  return models.back();
+}
+
+void HPGe_Coaxial::Construct(G4ThreeVector global_coordinates, G4double theta, G4double phi, G4double dist_from_center, G4double intrinsic_rotation_angle) const {
+
+  G4NistManager *nist = G4NistManager::Instance();
+  G4ThreeVector symmetry_axis(sin(theta) * cos(phi), sin(theta) * sin(phi), cos(theta)); // Symmetry axis along which the single elements of the detector are constructed
+  G4ThreeVector symmetry_axis_orthogonal(cos(theta) * cos(phi), cos(theta) * sin(phi), -sin(theta)); // Vector which is orthogonal to the symmetry axes. Needed for the construction of off-axis elements. As an arbitrary choice, take the unit vector with respect to theta in spherical coordinates.
+
+  G4RotationMatrix *rotation = new G4RotationMatrix();
+  rotation->rotateZ(-phi);
+  rotation->rotateY(-theta);
+  if (intrinsic_rotation_angle != 0.) {
+    rotation->rotateZ(intrinsic_rotation_angle);
   }
 
-  nsteps_optimized = opt->Optimize(zPlaneTemp, rInnerTemp, rOuterTemp, zPlane, rInner, rOuter, nsteps, detector_name + "_crystal_solid");
+  // All passive parts which do not depend on the placement are shared with other detectors of the same model
+  const Model &model = Get_Model();
+
+  /************* End cap *************/
+  G4double end_cap_outer_radius = properties.detector_radius + properties.mount_cup_thickness + properties.end_cap_to_crystal_gap_side + properties.end_cap_thickness;
+  G4double end_cap_side_length = properties.mount_cup_length + properties.end_cap_to_crystal_gap_front;
+
+  // End cap side
+  new G4PVPlacement(rotation, global_coordinates + (dist_from_center + properties.end_cap_window_thickness + end_cap_side_length * 0.5) * symmetry_axis, model.end_cap_side_logical, detector_name + "_end_cap_side", world_Logical, 0, 0, false);
+
+  // End cap window
+  new G4PVPlacement(rotation, global_coordinates + (dist_from_center + properties.end_cap_window_thickness * 0.5) * symmetry_axis, model.end_cap_window_logical, detector_name + "_end_cap_window", world_Logical, 0, 0, false);
+
+  // Vacuum inside end cap
+  G4LogicalVolume *end_cap_vacuum_logical = new G4LogicalVolume(model.end_cap_vacuum_solid, nist->FindOrBuildMaterial("G4_Galactic"), detector_name + "_end_cap_vacuum_logical");
+  end_cap_vacuum_logical->SetVisAttributes(G4VisAttributes::GetInvisible());
+  new G4PVPlacement(rotation, global_coordinates + (dist_from_center + properties.end_cap_window_thickness + end_cap_side_length * 0.5) * symmetry_axis, end_cap_vacuum_logical, detector_name + "_end_cap_vacuum", world_Logical, 0, 0, false);
+
+  /************* Mount cup *************/
+  G4double mount_cup_side_length = properties.mount_cup_length - properties.mount_cup_thickness - properties.mount_cup_base_thickness;
+
+  // Mount cup side
+  new G4PVPlacement(0, G4ThreeVector(0., 0., -end_cap_side_length * 0.5 + properties.end_cap_to_crystal_gap_front + properties.mount_cup_thickness + mount_cup_side_length * 0.5), model.mount_cup_side_logical, detector_name + "_mount_cup_side", end_cap_vacuum_logical, 0, 0, false);
+
+  // Mount cup face
+  new G4PVPlacement(0, G4ThreeVector(0., 0., -end_cap_side_length * 0.5 + properties.end_cap_to_crystal_gap_front + properties.mount_cup_thickness * 0.5), model.mount_cup_face_logical, detector_name + "_mount_cup_face", end_cap_vacuum_logical, 0, 0, false);
+
+  // Mount cup base
+  new G4PVPlacement(0, G4ThreeVector(0., 0., -end_cap_side_length * 0.5 + properties.end_cap_to_crystal_gap_front + properties.mount_cup_thickness + mount_cup_side_length + 0.5 * properties.mount_cup_base_thickness), model.mount_cup_base_logical, detector_name + "_mount_cup_base", end_cap_vacuum_logical, 0, 0, false);
+
+  /************* Cold finger *************/
+
+  G4double cold_finger_length = properties.cold_finger_penetration_depth + mount_cup_side_length + properties.mount_cup_base_thickness - properties.detector_length;
+
+  new G4PVPlacement(0, G4ThreeVector(0., 0., end_cap_side_length * 0.5 - cold_finger_length), model.cold_finger_logical, detector_name + "_cold_finger", end_cap_vacuum_logical, 0, 0, false);
 
-  G4Polycone *crystal_solid = new G4Polycone("crystal_solid", 0. * deg, 360. * deg, nsteps_optimized, zPlane, rInner, rOuter);
-  G4LogicalVolume *crystal_logical = new G4LogicalVolume(crystal_solid, nist->FindOrBuildMaterial("G4_Ge"), detector_name, 0, 0, 0);
+  /************* Detector crystal *************/
+
+  // The crystal logical volume is named like the detector, so that the sensitive detector can be attached to each detector individually
+  G4LogicalVolume *crystal_logical = new G4LogicalVolume(model.crystal_solid, nist->FindOrBuildMaterial("G4_Ge"), detector_name, 0, 0, 0);
   crystal_logical->SetVisAttributes(new G4VisAttributes(G4Color::Green()));
   new G4PVPlacement(0, G4ThreeVector(0., 0., -end_cap_side_length * 0.5 + properties.end_cap_to_crystal_gap_front + properties.mount_cup_thickness), crystal_logical, detector_name + "_crystal", end_cap_vacuum_logical, 0, 0, false);
 
   if (use_dewar) {
     /************* Connection dewar-detector *************/
-    G4Tubs *connection_solid = new G4Tubs(detector_name + "_dewar_connection_solid", 0., properties.connection_radius, properties.connection_length * 0.5, 0., twopi);
-    G4LogicalVolume *connection_logical = new G4LogicalVolume(connection_solid, nist->FindOrBuildMaterial(properties.connection_material), detector_name + "_dewar_connection_logical");
-    connection_logical->SetVisAttributes(new G4VisAttributes(G4Color::White()));
-    new G4PVPlacement(rotation, global_coordinates + (dist_from_center + properties.end_cap_window_thickness + end_cap_side_length + properties.connection_length * 0.5) * symmetry_axis, connection_logical, detector_name + "_dewar_connection", world_Logical, 0, 0, false);
+    new G4PVPlacement(rotation, global_coordinates + (dist_from_center + properties.end_cap_window_thickness + end_cap_side_length + properties.connection_length * 0.5) * symmetry_axis, model.connection_logical, detector_name + "_dewar_connection", world_Logical, 0, 0, false);
 
     if (intrinsic_rotation_angle != 0.)
       symmetry_axis_orthogonal.rotate(intrinsic_rotation_angle, symmetry_axis);
 
     /************* Dewar *************/
-    // Dewar face
-    G4Tubs *dewar_solid = new G4Tubs(detector_name + "_dewar_solid", 0., properties.dewar_outer_radius, properties.dewar_length * 0.5, 0., twopi);
-    G4LogicalVolume *dewar_logical = new G4LogicalVolume(dewar_solid, nist->FindOrBuildMaterial(properties.dewar_material), detector_name + "_dewar_logical");
-    dewar_logical->SetVisAttributes(G4Color::Brown());
-    new G4PVPlacement(rotation, global_coordinates + (dist_from_center + properties.end_cap_window_thickness + end_cap_side_length + properties.connection_length + properties.dewar_length * 0.5) * symmetry_axis, dewar_logical, detector_name + "_dewar", world_Logical, 0, 0, false);
-
-    // Dewar interior
-    G4Tubs *dewar_interior_solid = new G4Tubs(detector_name + "_dewar_interior_solid", 0., properties.dewar_outer_radius - properties.dewar_wall_thickness, properties.dewar_length * 0.5 - properties.dewar_wall_thickness, 0., twopi);
-    G4LogicalVolume *dewar_interior_logical = new G4LogicalVolume(dewar_interior_solid, nist->FindOrBuildMaterial("G4_N"), detector_name + "_dewar_interior_logical");
-    dewar_interior_logical->SetVisAttributes(G4Color::Red());
-    new G4PVPlacement(0, G4ThreeVector(0., 0., 0.), dewar_interior_logical, detector_name + "_dewar_interior", dewar_logical, 0, 0, false);
+    new G4PVPlacement(rotation, global_coordinates + (dist_from_center + properties.end_cap_window_thickness + end_cap_side_length + properties.connection_length + properties.dewar_length * 0.5) * symmetry_axis, model.dewar_logical, detector_name + "_dewar", world_Logical, 0, 0, false);
   }
 
   // Filters
@@ -204,26 +410,7 @@ void HPGe_Coaxial::Construct(G4ThreeVector global_coordinates, G4double theta, G
     filter_position_z = filter_position_z + filter_case.get_filter_case_ring_thickness();
   }
 
-  if (filter_materials.size()) {
-    G4Tubs *filter_solid = nullptr;
-    G4LogicalVolume *filter_logical = nullptr;
-    G4double filter_radius;
-    stringstream filter_base_name_ss;
-    for (unsigned int i = 0; i < filter_materials.size(); ++i) {
-      filter_radius = (filter_radii[i] < 0.) ? end_cap_outer_radius : filter_radii[i]; // A negative filter radius value tells us to use the detector front radius as the filter radius
-      filter_base_name_ss << detector_name << "_filter_" << i + 1 << "_" << filter_materials[i] << "_" << filter_thicknesses[i] / mm << "mm_x_" << filter_radius / mm << "mm";
-      filter_solid = new G4Tubs(filter_base_name_ss.str() + "_solid", 0., filter_radius, filter_thicknesses[i] / 2., 0., twopi);
-      filter_logical = new G4LogicalVolume(filter_solid, nist->FindOrBuildMaterial(filter_materials[i]), filter_base_name_ss.str() + "_logical");
-      if (i % 2 == 0) {
-        filter_logical->SetVisAttributes(G4Color::Red());
-      } else {
-        filter_logical->SetVisAttributes(G4Color::Green());
-      }
-      new G4PVPlacement(rotation, global_coordinates + (dist_from_center - filter_position_z - filter_thicknesses[i] / 2.) * symmetry_axis, filter_logical, filter_base_name_ss.str(), world_Logical, 0, 0, false);
-      filter_position_z = filter_position_z + filter_thicknesses[i];
-      filter_base_name_ss.str("");
-    }
-  }
+  filter_position_z = filter_position_z + Construct_Filters(rotation, global_coordinates, symmetry_axis, dist_from_center - filter_position_z, end_cap_outer_radius);
 
   if (use_filter_case) {
     filter_case.Construct_Case(global_coordinates, theta, phi, dist_from_center - filter_case.get_filter_case_bottom_thickness() / 2. - filter_position_z);
@@ -0,0 +1,90 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cctype>
+
+#include "G4GeometryCell.hh"
+#include "G4IStore.hh"
+#include "G4PhysicalVolumeStore.hh"
+
+#include "ImportanceSampling.hh"
+#include "utrConfig.h"
+
+G4GeometrySampler *ImportanceSampling::sampler = nullptr;
+vector<pair<G4String, G4double>> ImportanceSampling::importances = vector<pair<G4String, G4double>>();
+
+namespace {
+G4String to_lower(G4String str) {
+  std::transform(str.begin(), str.end(), str.begin(), [](unsigned char c) { return std::tolower(c); });
+  return str;
+}
+} // namespace
+
+G4GeometrySampler *ImportanceSampling::Get_Sampler() {
+  if (!sampler) {
+    // The world volume is not known yet when the physics list is constructed. Without a parallel world, the sampler uses the mass geometry.
+    sampler = new G4GeometrySampler(nullptr, importance_biasing_particle);
+    sampler->SetParallel(false);
+  }
+  return sampler;
+}
+
+void ImportanceSampling::Set_Importance(const G4String &pattern, G4double importance) {
+  if (importance < 0.) {
+    G4cerr << "Error: ImportanceSampling: Importance of '" << pattern << "' must not be negative." << G4endl;
+    throw std::exception();
+  }
+  importances.push_back(pair<G4String, G4double>(to_lower(pattern), importance));
+}
+
+G4double ImportanceSampling::Get_Importance(const G4String &physical_volume_name) {
+  const G4String name = to_lower(physical_volume_name);
+  for (auto it = importances.rbegin(); it != importances.rend(); ++it) {
+    if (name.find(it->first) != std::string::npos) {
+      return it->second;
+    }
+  }
+  return 1.;
+}
+
+void ImportanceSampling::Fill_Importance_Store() {
+  // The importance store is thread-local. It has to contain every cell of the geometry, otherwise the importance process aborts.
+  G4IStore *istore = G4IStore::GetInstance();
+  for (auto physical_volume : *G4PhysicalVolumeStore::GetInstance()) {
+    const G4GeometryCell cell(*physical_volume, physical_volume->GetCopyNo());
+    const G4double importance = Get_Importance(physical_volume->GetName());
+    if (istore->IsKnown(cell)) {
+      istore->ChangeImportance(importance, cell);
+    } else {
+      istore->AddImportanceGeometryCell(importance, cell);
+    }
+  }
+}
+
+void ImportanceSampling::Print() {
+  G4cout << "ImportanceSampling: Importances of the physical volumes for '" << importance_biasing_particle << "' (default: 1):" << G4endl;
+  for (auto physical_volume : *G4PhysicalVolumeStore::GetInstance()) {
+    const G4double importance = Get_Importance(physical_volume->GetName());
+    if (importance != 1.) {
+      G4cout << "\t" << physical_volume->GetName() << " : " << importance << G4endl;
+    }
+  }
+}
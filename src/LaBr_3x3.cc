@@ -38,6 +38,8 @@ along with utr.  If not, see <http://www.gnu.org/licenses/>.
 
 using std::stringstream;
 
+vector<LaBr_3x3::Model> LaBr_3x3::models;
+
 void LaBr_3x3::Construct(G4ThreeVector global_coordinates, G4double theta, G4double phi, G4double dist_from_center) const {
 
   auto *nist = G4NistManager::Instance();
@@ -85,59 +87,91 @@ void LaBr_3x3::Construct(G4ThreeVector global_coordinates, G4double theta, G4dou
   const auto circuit_housing_3_and_pmt_length = circuit_housing_3_length + pmt_housing_length;
   const auto circuit_housing_3_and_pmt_radius = circuit_housing_3_radius;
 
+  /************** Shared model *************/
+
+  const Model *model = nullptr;
+  for (auto &m : models) {
+    if (m.with_housing == use_housing) {
+      model = &m;
+      break;
+    }
+  }
+
+  if (model == nullptr) {
+    Model new_model;
+    new_model.with_housing = use_housing;
+    const G4String model_name = use_housing ? "LaBr_3x3_model_housing" : "LaBr_3x3_model";
+
+    // The material outlives the geometry, so it is only defined once, even if the geometry is rebuilt
+    new_model.crystal_material = G4Material::GetMaterial("LaBr3Ce", false);
+    if (new_model.crystal_material == nullptr) {
+      // Brillance 380 from Enrique Nacher (Santiago)
+      new_model.crystal_material = new G4Material("LaBr3Ce", 5.06 * g / cm3, 3);
+      new_model.crystal_material->AddElement(nist->FindOrBuildElement("La"), 34.855 * perCent);
+      new_model.crystal_material->AddElement(nist->FindOrBuildElement("Br"), 60.145 * perCent);
+      new_model.crystal_material->AddElement(nist->FindOrBuildElement("Ce"), 5.0 * perCent);
+    }
+
+    new_model.crystal_housing_solid = new G4Tubs(model_name + "_crystal_housing_solid", 0., crystal_housing_outer_radius, crystal_housing_length / 2., 0., twopi);
+    new_model.vacuum_solid = new G4Tubs(model_name + "_vacuum_solid", 0., crystal_housing_outer_radius - crystal_housing_thickness, vacuum_length / 2., 0., twopi);
+    new_model.crystal_solid = new G4Tubs(model_name + "_crystal_solid", 0., crystal_radius, crystal_length / 2., 0., twopi);
+
+    new_model.circuit_housing_1_logical = nullptr;
+    new_model.circuit_housing_2_logical = nullptr;
+    new_model.circuit_housing_3_and_pmt_logical = nullptr;
+    if (use_housing) {
+      auto *circuit_housing_1_solid = new G4Tubs(model_name + "_circuit_housing_1_solid", crystal_housing_outer_radius - crystal_housing_thickness, circuit_housing_1_radius, circuit_housing_1_length / 2., 0., twopi);
+      new_model.circuit_housing_1_logical = new G4LogicalVolume(circuit_housing_1_solid, nist->FindOrBuildMaterial("G4_Al"), model_name + "_circuit_housing_1_logical");
+      new_model.circuit_housing_1_logical->SetVisAttributes(G4Color::Grey());
+
+      G4Cons *circuit_housing_2_solid = new G4Cons(model_name + "_circuit_housing_2_solid", circuit_housing_2_rmax - circuit_housing_thickness, circuit_housing_2_rmax, circuit_housing_2_rmin - circuit_housing_thickness, circuit_housing_2_rmin, circuit_housing_2_length / 2., 0., twopi);
+      new_model.circuit_housing_2_logical = new G4LogicalVolume(circuit_housing_2_solid, nist->FindOrBuildMaterial("G4_Al"), model_name + "_circuit_housing_2_logical");
+      new_model.circuit_housing_2_logical->SetVisAttributes(G4Color::Grey());
+
+      auto *circuit_housing_3_and_pmt_solid = new G4Tubs(model_name + "_circuit_housing_3_and_pmt_solid", 0., circuit_housing_3_and_pmt_radius, circuit_housing_3_and_pmt_length / 2., 0., twopi);
+      new_model.circuit_housing_3_and_pmt_logical = new G4LogicalVolume(circuit_housing_3_and_pmt_solid, nist->FindOrBuildMaterial("G4_Al"), model_name + "_circuit_housing_3_and_pmt_logical");
+      new_model.circuit_housing_3_and_pmt_logical->SetVisAttributes(G4Color::Grey());
+
+      auto *circuit_housing_3_and_pmt_interior_solid = new G4Tubs(model_name + "_circuit_housing_3_and_pmt_interior_solid", 0., circuit_housing_3_and_pmt_radius - circuit_housing_thickness, (circuit_housing_3_and_pmt_length - circuit_housing_thickness) / 2., 0., twopi);
+      auto *circuit_housing_3_and_pmt_interior_logical = new G4LogicalVolume(circuit_housing_3_and_pmt_interior_solid, nist->FindOrBuildMaterial("G4_AIR"), model_name + "_circuit_housing_3_and_pmt_interior_logical");
+      circuit_housing_3_and_pmt_interior_logical->SetVisAttributes(G4Color::White());
+      new G4PVPlacement(nullptr, G4ThreeVector(0., 0., -circuit_housing_thickness / 2.), circuit_housing_3_and_pmt_interior_logical, model_name + "_circuit_housing_3_and_pmt_interior", new_model.circuit_housing_3_and_pmt_logical, 0, 0, false);
+    }
+
+    models.push_back(new_model);
+    model = &models.back();
+  }
+
   /************** Crystal housing *************/
 
-  auto *crystal_housing_solid = new G4Tubs(detector_name + "_crystal_housing_solid", 0., crystal_housing_outer_radius, crystal_housing_length / 2., 0., twopi);
-  auto *crystal_housing_logical = new G4LogicalVolume(crystal_housing_solid, nist->FindOrBuildMaterial("G4_Al"), detector_name + "_crystal_housing_logical");
+  auto *crystal_housing_logical = new G4LogicalVolume(model->crystal_housing_solid, nist->FindOrBuildMaterial("G4_Al"), detector_name + "_crystal_housing_logical");
   crystal_housing_logical->SetVisAttributes(G4Color::Grey());
   new G4PVPlacement(rotation, global_coordinates + (dist_from_center + crystal_housing_length / 2.) * symmetry_axis, crystal_housing_logical, detector_name + "_crystal_housing", world_Logical, 0, 0, false);
 
   /************** Vacuum around crystal *************/
 
-  auto *vacuum_solid = new G4Tubs(detector_name + "_vacuum_solid", 0., crystal_housing_outer_radius - crystal_housing_thickness, vacuum_length / 2., 0., twopi);
-  auto *vacuum_logical = new G4LogicalVolume(vacuum_solid, nist->FindOrBuildMaterial("G4_Galactic"), detector_name + "_vacuum_logical");
+  auto *vacuum_logical = new G4LogicalVolume(model->vacuum_solid, nist->FindOrBuildMaterial("G4_Galactic"), detector_name + "_vacuum_logical");
   vacuum_logical->SetVisAttributes(G4Color::Cyan());
   new G4PVPlacement(nullptr, G4ThreeVector(0., 0., crystal_housing_thickness / 2. - crystal_housing_thickness_back / 2.), vacuum_logical, detector_name + "_vacuum", crystal_housing_logical, 0, 0, false);
 
   /************** Detector crystal *************/
 
-  // Brillance 380 from Enrique Nacher (Santiago)
-  auto *LaBr3Ce = new G4Material("LaBr3Ce", 5.06 * g / cm3, 3);
-  LaBr3Ce->AddElement(nist->FindOrBuildElement("La"), 34.855 * perCent);
-  LaBr3Ce->AddElement(nist->FindOrBuildElement("Br"), 60.145 * perCent);
-  LaBr3Ce->AddElement(nist->FindOrBuildElement("Ce"), 5.0 * perCent);
-
-  auto *crystal_solid = new G4Tubs(detector_name + "_crystal_solid", 0., crystal_radius, crystal_length / 2., 0., twopi);
-  auto *crystal_logical = new G4LogicalVolume(crystal_solid, LaBr3Ce, detector_name);
+  auto *crystal_logical = new G4LogicalVolume(model->crystal_solid, model->crystal_material, detector_name);
   crystal_logical->SetVisAttributes(G4Color::Green());
   new G4PVPlacement(nullptr, G4ThreeVector(0., 0., vacuum_thickness_front / 2. - vacuum_thickness_back / 2.), crystal_logical, detector_name + "_crystal", vacuum_logical, 0, 0, false);
 
   if (use_housing) {
     /************** Circuit housing 1 *************/
 
-    auto *circuit_housing_1_solid = new G4Tubs(detector_name + "_circuit_housing_1_solid", crystal_housing_outer_radius - crystal_housing_thickness, circuit_housing_1_radius, circuit_housing_1_length / 2., 0., twopi);
-    auto *circuit_housing_1_logical = new G4LogicalVolume(circuit_housing_1_solid, nist->FindOrBuildMaterial("G4_Al"), detector_name + "_circuit_housing_1_logical");
-    circuit_housing_1_logical->SetVisAttributes(G4Color::Grey());
-    new G4PVPlacement(rotation, global_coordinates + (dist_from_center + crystal_housing_length + circuit_housing_1_length / 2.) * symmetry_axis, circuit_housing_1_logical, detector_name + "_circuit_housing_1", world_Logical, 0, 0, false);
+    new G4PVPlacement(rotation, global_coordinates + (dist_from_center + crystal_housing_length + circuit_housing_1_length / 2.) * symmetry_axis, model->circuit_housing_1_logical, detector_name + "_circuit_housing_1", world_Logical, 0, 0, false);
 
     /************** Circuit housing 2 *************/
 
-    G4Cons *circuit_housing_2_solid = new G4Cons("circuit_housing_2_solid", circuit_housing_2_rmax - circuit_housing_thickness, circuit_housing_2_rmax, circuit_housing_2_rmin - circuit_housing_thickness, circuit_housing_2_rmin, circuit_housing_2_length / 2., 0., twopi);
-    auto *circuit_housing_2_logical = new G4LogicalVolume(circuit_housing_2_solid, nist->FindOrBuildMaterial("G4_Al"), detector_name + "_circuit_housing_2_logical");
-    circuit_housing_2_logical->SetVisAttributes(G4Color::Grey());
-    new G4PVPlacement(rotation, global_coordinates + (dist_from_center + crystal_housing_length + circuit_housing_1_length + circuit_housing_2_length / 2.) * symmetry_axis, circuit_housing_2_logical, detector_name + "_circuit_housing_2", world_Logical, 0, 0, false);
+    new G4PVPlacement(rotation, global_coordinates + (dist_from_center + crystal_housing_length + circuit_housing_1_length + circuit_housing_2_length / 2.) * symmetry_axis, model->circuit_housing_2_logical, detector_name + "_circuit_housing_2", world_Logical, 0, 0, false);
 
     /************** Circuit housing 3 with PMT *************/
 
-    auto *circuit_housing_3_and_pmt_solid = new G4Tubs(detector_name + "_circuit_housing_3_and_pmt_solid", 0., circuit_housing_3_and_pmt_radius, circuit_housing_3_and_pmt_length / 2., 0., twopi);
-    auto *circuit_housing_3_and_pmt_logical = new G4LogicalVolume(circuit_housing_3_and_pmt_solid, nist->FindOrBuildMaterial("G4_Al"), detector_name + "_circuit_housing_3_and_pmt_logical");
-    circuit_housing_3_and_pmt_logical->SetVisAttributes(G4Color::Grey());
-    new G4PVPlacement(rotation, global_coordinates + (dist_from_center + crystal_housing_length + circuit_housing_1_length + circuit_housing_2_length + circuit_housing_3_and_pmt_length / 2.) * symmetry_axis, circuit_housing_3_and_pmt_logical, detector_name + "_circuit_housing_3_and_pmt", world_Logical, 0, 0, false);
-
-    auto *circuit_housing_3_and_pmt_interior_solid = new G4Tubs(detector_name + "_circuit_housing_3_and_pmt_interior_solid", 0., circuit_housing_3_and_pmt_radius - circuit_housing_thickness, (circuit_housing_3_and_pmt_length - circuit_housing_thickness) / 2., 0., twopi);
-    auto *circuit_housing_3_and_pmt_interior_logical = new G4LogicalVolume(circuit_housing_3_and_pmt_interior_solid, nist->FindOrBuildMaterial("G4_AIR"), detector_name + "_circuit_housing_3_and_pmt_interior_logical");
-    circuit_housing_3_and_pmt_interior_logical->SetVisAttributes(G4Color::White());
-    new G4PVPlacement(nullptr, G4ThreeVector(0., 0., -circuit_housing_thickness / 2.), circuit_housing_3_and_pmt_interior_logical, detector_name + "_circuit_housing_3_and_pmt_interior", circuit_housing_3_and_pmt_logical, 0, 0, false);
+    new G4PVPlacement(rotation, global_coordinates + (dist_from_center + crystal_housing_length + circuit_housing_1_length + circuit_housing_2_length + circuit_housing_3_and_pmt_length / 2.) * symmetry_axis, model->circuit_housing_3_and_pmt_logical, detector_name + "_circuit_housing_3_and_pmt", world_Logical, 0, 0, false);
   }
 
   // Filters
@@ -150,26 +184,7 @@ void LaBr_3x3::Construct(G4ThreeVector global_coordinates, G4double theta, G4dou
     filter_position_z = filter_position_z + filter_case.get_filter_case_ring_thickness();
   }
 
-  if (filter_materials.size()) {
-    G4Tubs *filter_solid = nullptr;
-    G4LogicalVolume *filter_logical = nullptr;
-    G4double filter_radius;
-    stringstream filter_base_name_ss;
-    for (unsigned int i = 0; i < filter_materials.size(); ++i) {
-      filter_radius = (filter_radii[i] < 0.) ? crystal_housing_outer_radius : filter_radii[i]; // A negative filter radius value tells us to use the detector front radius as the filter radius
-      filter_base_name_ss << detector_name << "_filter_" << i + 1 << "_" << filter_materials[i] << "_" << filter_thicknesses[i] / mm << "mm_x_" << filter_radius / mm << "mm";
-      filter_solid = new G4Tubs(filter_base_name_ss.str() + "_solid", 0., filter_radius, filter_thicknesses[i] / 2., 0., twopi);
-      filter_logical = new G4LogicalVolume(filter_solid, nist->FindOrBuildMaterial(filter_materials[i]), filter_base_name_ss.str() + "_logical");
-      if (i % 2 == 0) {
-        filter_logical->SetVisAttributes(G4Color::Red());
-      } else {
-        filter_logical->SetVisAttributes(G4Color::Green());
-      }
-      new G4PVPlacement(rotation, global_coordinates + (dist_from_center - filter_position_z - filter_thicknesses[i] / 2.) * symmetry_axis, filter_logical, filter_base_name_ss.str(), world_Logical, 0, 0, false);
-      filter_position_z = filter_position_z + filter_thicknesses[i];
-      filter_base_name_ss.str("");
-    }
-  }
+  filter_position_z = filter_position_z + Construct_Filters(rotation, global_coordinates, symmetry_axis, dist_from_center - filter_position_z, crystal_housing_outer_radius);
 
   if (use_filter_case) {
     filter_case.Construct_Case(global_coordinates, theta, phi, dist_from_center - filter_case.get_filter_case_bottom_thickness() / 2. - filter_position_z);
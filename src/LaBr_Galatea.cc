@@ -202,35 +202,7 @@ void LaBr_Galatea::Construct(G4ThreeVector global_coordinates, G4double theta, G
   }
 
   // Filters
-  G4double filter_position_z = 0.; // Will be gradually increased to be able to place
-                                   // filters on top of each other
-  if (filter_materials.size()) {
-    G4Tubs *filter_solid = nullptr;
-    G4LogicalVolume *filter_logical = nullptr;
-    stringstream filter_solid_name, filter_logical_name, filter_name;
-    for (unsigned int i = 0; i < filter_materials.size(); ++i) {
-      filter_solid_name << "filter_" << detector_name << "_" << i << "_solid";
-      filter_solid = new G4Tubs(filter_solid_name.str(), 0., filter_radii[i],
-                                filter_thicknesses[i] * 0.5, 0., twopi);
-      filter_solid_name.clear();
-
-      filter_logical_name << "filter_" << detector_name << "_" << i << "_logical";
-      filter_logical = new G4LogicalVolume(filter_solid,
-                                           nist->FindOrBuildMaterial(filter_materials[i]),
-                                           filter_logical_name.str());
-      filter_logical_name.clear();
-      if (i % 2 == 0) {
-        filter_logical->SetVisAttributes(new G4VisAttributes(G4Color::Red()));
-      } else {
-        filter_logical->SetVisAttributes(new G4VisAttributes(G4Color::Green()));
-      }
-
-      filter_name << "filter_" << detector_name << "_" << i;
-      new G4PVPlacement(rotation, global_coordinates + (dist_from_center - filter_position_z - filter_thicknesses[i] * 0.5) * symmetry_axis, filter_logical, filter_name.str(), world_Logical, 0, 0, false);
-      filter_name.clear();
-      filter_position_z = filter_position_z + filter_thicknesses[i];
-    }
-  }
+  Construct_Filters(rotation, global_coordinates, symmetry_axis, dist_from_center, crystal_housing_inner_radius + crystal_housing_thickness);
 
   // Wraps
   if (wrap_materials.size()) {
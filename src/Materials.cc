@@ -25,8 +25,6 @@ along with utr.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4PhysicalConstants.hh"
 #include "G4SystemOfUnits.hh"
 
-#include "DetectorConstruction.hh" //For definition of inch
-
 #define PI 3.141592
 
 Materials *Materials::instance = nullptr;
@@ -26,7 +26,10 @@ along with utr.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4SDManager.hh"
 #include "G4Step.hh"
 #include "G4ThreeVector.hh"
+#include "BiasedCopies.hh"
+#include "EnergySweep.hh"
 #include "RunAction.hh"
+#include "RunChain.hh"
 
 #include "utrConfig.h"
 
@@ -61,7 +64,7 @@ G4bool ParticleSD::ProcessHits(G4Step *aStep, G4TouchableHistory *) {
     unsigned int nentry = 0;
 
 #ifdef EVENT_ID
-    analysisManager->FillNtupleDColumn(nentry, eventID);
+    analysisManager->FillNtupleDColumn(nentry, RunChain::Global_Event_ID(eventID));
     ++nentry;
 #endif
 #ifdef EVENT_EDEP
@@ -102,7 +105,17 @@ G4bool ParticleSD::ProcessHits(G4Step *aStep, G4TouchableHistory *) {
 #endif
 #ifdef EVENT_MOMZ
     analysisManager->FillNtupleDColumn(nentry, aStep->GetPreStepPoint()->GetMomentum().z());
+    ++nentry;
+#endif
+#ifdef EVENT_WEIGHT
+    analysisManager->FillNtupleDColumn(nentry, aStep->GetPreStepPoint()->GetWeight());
+    ++nentry;
+    analysisManager->FillNtupleDColumn(nentry, BiasedCopies::Get_Copy_ID(track));
+    ++nentry;
 #endif
+    if (EnergySweep::Is_Active()) {
+      analysisManager->FillNtupleDColumn(nentry, EnergySweep::Get_Energy());
+    }
 
     analysisManager->AddNtupleRow();
   }
@@ -19,121 +19,256 @@ along with utr.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "Physics.hh"
+#include "RegionManager.hh"
 
-// Electromagnetic modular physics lists
-#ifdef EM_FAST
-#include "G4EmStandardPhysics_option1.hh"
-#endif
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
 
-#ifdef EM_LIVERMORE
+// Electromagnetic modular physics lists
+#include "G4EmExtraPhysics.hh"
 #include "G4EmLivermorePhysics.hh"
-#endif
-
-#ifdef EM_LIVERMORE_POLARIZED
 #include "G4EmLivermorePolarizedPhysics.hh"
-#endif
-
-#ifdef EM_PENELOPE
 #include "G4EmPenelopePhysics.hh"
-#endif
-
-#ifdef EM_STANDARD
+#include "G4EmStandardPhysics_option1.hh"
 #include "G4EmStandardPhysics_option4.hh"
-#endif
 
 // Hadronic elastic modular physics lists
-#ifdef HADRON_ELASTIC_STANDARD
 #include "G4HadronElasticPhysics.hh"
-#endif
-#ifdef HADRON_ELASTIC_HP
 #include "G4HadronElasticPhysicsHP.hh"
-#endif
-#ifdef HADRON_ELASTIC_LEND
 #include "G4HadronElasticPhysicsLEND.hh"
-#endif
 
-// Hadronic elastic modular physics lists
-#ifdef HADRON_INELASTIC_STANDARD
+// Hadronic inelastic modular physics lists
 #include "G4HadronPhysicsFTFP_BERT.hh"
-#endif
-#ifdef HADRON_INELASTIC_HP
 #include "G4HadronPhysicsFTFP_BERT_HP.hh"
-#endif
-#ifdef HADRON_INELASTIC_LEND
 #include "G4HadronPhysicsShieldingLEND.hh"
+
+#ifdef IMPORTANCE_BIASING
+#include "G4ImportanceBiasing.hh"
+#include "ImportanceSampling.hh"
 #endif
 
-#ifdef EM_EXTRA
-#include "G4EmExtraPhysics.hh"
+#ifdef FAST_DETECTOR_RESPONSE
+#include "G4FastSimulationPhysics.hh"
 #endif
 
-Physics::Physics() {
-  G4cout << "================================================================"
-            "================"
-         << G4endl;
-  G4cout << "Using the following physics lists:" << G4endl;
+#if defined(FORCED_COLLISION) || defined(DIRECTIONAL_SPLITTING)
+#include "G4GenericBiasingPhysics.hh"
+#include <set>
+#endif
 
-// Electromagnetic modular physics lists
+Physics::Selection Physics::Default_Selection() {
+  Selection selection;
 #ifdef EM_FAST
-  G4cout << "\tG4EmStandardPhysics_option1 ..." << G4endl;
-  RegisterPhysics(new G4EmStandardPhysics_option1());
+  selection.em += ",fast";
 #endif
 #ifdef EM_LIVERMORE
-  G4cout << "\tG4EmLivermorePhysics ..." << G4endl;
-  RegisterPhysics(new G4EmLivermorePhysics());
+  selection.em += ",livermore";
 #endif
 #ifdef EM_LIVERMORE_POLARIZED
-  G4cout << "\tG4EmLivermorePolarizedPhysics ..." << G4endl;
-  RegisterPhysics(new G4EmLivermorePolarizedPhysics());
+  selection.em += ",livermore_polarized";
 #endif
 #ifdef EM_PENELOPE
-  G4cout << "\tG4EmPenelopePhysics ..." << G4endl;
-  RegisterPhysics(new G4EmPenelopePhysics());
+  selection.em += ",penelope";
 #endif
 #ifdef EM_STANDARD
-  G4cout << "\tG4EmStandardPhysics_option4 ..." << G4endl;
-  RegisterPhysics(new G4EmStandardPhysics_option4());
+  selection.em += ",standard";
 #endif
-
-// EM extra physics. Contains photonuclear processes.
 #ifdef EM_EXTRA
-  G4cout << "\tG4EmExtraPhysics ..." << G4endl;
-  RegisterPhysics(new G4EmExtraPhysics());
+  selection.em += ",extra";
 #endif
-
-// Hadronic elastic modular physics lists
 #ifdef HADRON_ELASTIC_STANDARD
-  G4cout << "\tG4HadronElasticPhysics ..." << G4endl;
-  RegisterPhysics(new G4HadronElasticPhysics());
+  selection.elastic += ",standard";
 #endif
-
 #ifdef HADRON_ELASTIC_HP
-  G4cout << "\tG4HadronElasticPhysicsHP ..." << G4endl;
-  RegisterPhysics(new G4HadronElasticPhysicsHP());
+  selection.elastic += ",hp";
 #endif
-
 #ifdef HADRON_ELASTIC_LEND
-  G4cout << "\tG4HadronElasticPhysicsLEND ..." << G4endl;
-  RegisterPhysics(new G4HadronElasticPhysicsLEND());
+  selection.elastic += ",lend";
 #endif
-
-// Hadronic inelastic modular physics lists
 #ifdef HADRON_INELASTIC_STANDARD
-  G4cout << "\tG4HadronPhysicsFTFP_BERT ..." << G4endl;
-  RegisterPhysics(new G4HadronPhysicsFTFP_BERT());
+  selection.inelastic += ",standard";
 #endif
-
 #ifdef HADRON_INELASTIC_HP
-  G4cout << "\tG4HadronPhysicsFTFP_BERT_HP ..." << G4endl;
-  RegisterPhysics(new G4HadronPhysicsFTFP_BERT_HP());
+  selection.inelastic += ",hp";
 #endif
-
 #ifdef HADRON_INELASTIC_LEND
-  G4cout << "\tG4HadronPhysicsShieldingLEND ..." << G4endl;
-  RegisterPhysics(new G4HadronPhysicsShieldingLEND());
+  selection.inelastic += ",lend";
 #endif
+  // Remove the leading commas
+  for (auto list : {&selection.em, &selection.elastic, &selection.inelastic}) {
+    *list = list->empty() ? G4String("none") : G4String(list->substr(1));
+  }
+  return selection;
+}
+
+std::vector<G4String> Physics::Split(const G4String &list) {
+  std::vector<G4String> names;
+  std::istringstream stream(list);
+  for (std::string name; std::getline(stream, name, ',');) {
+    if (name != "" && name != "none") {
+      names.push_back(name);
+    }
+  }
+  return names;
+}
+
+bool Physics::Uses_Polarized_Beam(const G4String &macrofile, unsigned int depth) {
+  std::ifstream file(macrofile);
+  if (!file.is_open() || depth > 10) {
+    return false;
+  }
+  for (std::string line; std::getline(file, line);) {
+    std::istringstream stream(line);
+    std::string command;
+    stream >> command;
+    if (command == "/gps/polarization") {
+      // A polarization vector with an alias, e.g. {pol}, is assumed to be nonzero
+      for (std::string component; stream >> component;) {
+        if (component.find('{') != std::string::npos || std::atof(component.c_str()) != 0.) {
+          return true;
+        }
+      }
+    } else if (command == "/control/execute") {
+      std::string included_macrofile;
+      stream >> included_macrofile;
+      if (Uses_Polarized_Beam(included_macrofile, depth + 1)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
 
+void Physics::Register_EM(const G4String &name, const G4String &macrofile) {
+  if (name == "auto") {
+    // The polarized models are only slower than the unpolarized Livermore models, not more accurate, if the photons are unpolarized
+    if (macrofile == "") {
+      G4cout << "\tauto: No macro file, assuming a polarized beam" << G4endl;
+      Register_EM("livermore_polarized", macrofile);
+    } else if (Uses_Polarized_Beam(macrofile)) {
+      G4cout << "\tauto: " << macrofile << " sets a polarized beam" << G4endl;
+      Register_EM("livermore_polarized", macrofile);
+    } else {
+      G4cout << "\tauto: " << macrofile << " does not set a polarized beam" << G4endl;
+      Register_EM("livermore", macrofile);
+    }
+  } else if (name == "fast") {
+    G4cout << "\tG4EmStandardPhysics_option1 ..." << G4endl;
+    RegisterPhysics(new G4EmStandardPhysics_option1());
+  } else if (name == "livermore") {
+    G4cout << "\tG4EmLivermorePhysics ..." << G4endl;
+    RegisterPhysics(new G4EmLivermorePhysics());
+  } else if (name == "livermore_polarized") {
+    G4cout << "\tG4EmLivermorePolarizedPhysics ..." << G4endl;
+    RegisterPhysics(new G4EmLivermorePolarizedPhysics());
+  } else if (name == "penelope") {
+    G4cout << "\tG4EmPenelopePhysics ..." << G4endl;
+    RegisterPhysics(new G4EmPenelopePhysics());
+  } else if (name == "standard") {
+    G4cout << "\tG4EmStandardPhysics_option4 ..." << G4endl;
+    RegisterPhysics(new G4EmStandardPhysics_option4());
+  } else if (name == "extra") {
+    // EM extra physics. Contains photonuclear processes.
+    G4cout << "\tG4EmExtraPhysics ..." << G4endl;
+    RegisterPhysics(new G4EmExtraPhysics());
+  } else {
+    G4cerr << "Error: Unknown EM physics '" << name << "'. Choose from auto, fast, standard, livermore, livermore_polarized, penelope, extra or none." << G4endl;
+    throw std::exception();
+  }
+}
+
+void Physics::Register_Hadron_Elastic(const G4String &name) {
+  if (name == "standard") {
+    G4cout << "\tG4HadronElasticPhysics ..." << G4endl;
+    RegisterPhysics(new G4HadronElasticPhysics());
+  } else if (name == "hp") {
+    G4cout << "\tG4HadronElasticPhysicsHP ..." << G4endl;
+    RegisterPhysics(new G4HadronElasticPhysicsHP());
+  } else if (name == "lend") {
+    G4cout << "\tG4HadronElasticPhysicsLEND ..." << G4endl;
+    RegisterPhysics(new G4HadronElasticPhysicsLEND());
+  } else {
+    G4cerr << "Error: Unknown hadronic elastic physics '" << name << "'. Choose from standard, hp, lend or none." << G4endl;
+    throw std::exception();
+  }
+}
+
+void Physics::Register_Hadron_Inelastic(const G4String &name) {
+  if (name == "standard") {
+    G4cout << "\tG4HadronPhysicsFTFP_BERT ..." << G4endl;
+    RegisterPhysics(new G4HadronPhysicsFTFP_BERT());
+  } else if (name == "hp") {
+    G4cout << "\tG4HadronPhysicsFTFP_BERT_HP ..." << G4endl;
+    RegisterPhysics(new G4HadronPhysicsFTFP_BERT_HP());
+  } else if (name == "lend") {
+    G4cout << "\tG4HadronPhysicsShieldingLEND ..." << G4endl;
+    RegisterPhysics(new G4HadronPhysicsShieldingLEND());
+  } else {
+    G4cerr << "Error: Unknown hadronic inelastic physics '" << name << "'. Choose from standard, hp, lend or none." << G4endl;
+    throw std::exception();
+  }
+}
+
+Physics::Physics(const Selection &selection, const G4String &macrofile) {
   G4cout << "================================================================"
             "================"
          << G4endl;
+  G4cout << "Using the following physics lists:" << G4endl;
+
+  // Electromagnetic modular physics lists
+  for (auto name : Split(selection.em)) {
+    Register_EM(name, macrofile);
+  }
+
+  // Hadronic elastic modular physics lists
+  for (auto name : Split(selection.elastic)) {
+    Register_Hadron_Elastic(name);
+  }
+
+  // Hadronic inelastic modular physics lists
+  for (auto name : Split(selection.inelastic)) {
+    Register_Hadron_Inelastic(name);
+  }
+
+// Importance sampling in the mass geometry
+#ifdef IMPORTANCE_BIASING
+  G4cout << "\tG4ImportanceBiasing ..." << G4endl;
+  RegisterPhysics(new G4ImportanceBiasing(ImportanceSampling::Get_Sampler()));
+#endif
+
+// Wraps the processes of the biased particle, so that biasing operators can be attached to volumes
+#if defined(FORCED_COLLISION) || defined(DIRECTIONAL_SPLITTING)
+  G4cout << "\tG4GenericBiasingPhysics ..." << G4endl;
+  // Each particle may only be wrapped once
+  std::set<G4String> biased_particles;
+#ifdef FORCED_COLLISION
+  biased_particles.insert(forced_collision_particle);
+#endif
+#ifdef DIRECTIONAL_SPLITTING
+  biased_particles.insert("gamma");
+#endif
+  G4GenericBiasingPhysics *biasingPhysics = new G4GenericBiasingPhysics();
+  for (auto particle : biased_particles) {
+    biasingPhysics->Bias(particle);
+  }
+  RegisterPhysics(biasingPhysics);
+#endif
+
+// Fast simulation of the tabulated detector responses
+#ifdef FAST_DETECTOR_RESPONSE
+  G4cout << "\tG4FastSimulationPhysics ..." << G4endl;
+  G4FastSimulationPhysics *fastSimulationPhysics = new G4FastSimulationPhysics();
+  fastSimulationPhysics->ActivateFastSimulation("gamma");
+  RegisterPhysics(fastSimulationPhysics);
+#endif
+
+  G4cout << "================================================================"
+            "================"
+         << G4endl;
+}
+
+void Physics::SetCuts() {
+  SetCutsWithDefault();
+  RegionManager::Construct_Regions();
 }
@@ -0,0 +1,153 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "G4RunManager.hh"
+
+#include "ProgressMonitor.hh"
+#include "RunChain.hh"
+#include "utrConfig.h"
+
+using std::setw;
+
+vector<ProgressMonitor::Counter> ProgressMonitor::counters(1);
+std::atomic<G4long> ProgressMonitor::overflow_events{0};
+G4double ProgressMonitor::interval = progress_interval;
+G4long ProgressMonitor::total_events = 0;
+G4long ProgressMonitor::start_offset = 0;
+std::chrono::steady_clock::time_point ProgressMonitor::start_time;
+G4long ProgressMonitor::last_events = 0;
+std::chrono::steady_clock::time_point ProgressMonitor::last_time;
+std::thread ProgressMonitor::reporter;
+std::mutex ProgressMonitor::mutex;
+std::condition_variable ProgressMonitor::stop_condition;
+G4bool ProgressMonitor::stop_requested = false;
+
+G4long ProgressMonitor::Get_Counted_Events() {
+  G4long counted = overflow_events.load(std::memory_order_relaxed);
+  for (auto &counter : counters) {
+    counted += counter.events.load(std::memory_order_relaxed);
+  }
+  return counted;
+}
+
+void ProgressMonitor::Start(G4long n_events_run) {
+  // The worker threads do not process events yet, so the counters can be reallocated and reset without a race
+  const G4long counted = Get_Counted_Events();
+  const G4int n_threads = G4RunManager::GetRunManager()->GetNumberOfThreads();
+  if ((size_t)n_threads > counters.size()) {
+    // The events of the previous runs of a RunChain are kept in the first counter
+    counters = vector<Counter>(n_threads);
+    counters[0].events.store(counted, std::memory_order_relaxed);
+    overflow_events.store(0, std::memory_order_relaxed);
+  }
+  const auto now = std::chrono::steady_clock::now();
+  // The following runs of a RunChain continue the statistics of the first one
+  const G4long offset = RunChain::Get_Event_Offset();
+  if (offset == 0 || offset != start_offset + counted) {
+    for (auto &counter : counters) {
+      counter.events.store(0, std::memory_order_relaxed);
+    }
+    overflow_events.store(0, std::memory_order_relaxed);
+    start_offset = offset;
+    start_time = now;
+    last_events = offset;
+    last_time = now;
+  }
+  total_events = RunChain::Get_Total_Events() > 0 ? RunChain::Get_Total_Events() : n_events_run;
+
+  if (interval > 0.) {
+    stop_requested = false;
+    reporter = std::thread(Report_Loop);
+  }
+}
+
+void ProgressMonitor::Stop() {
+  if (reporter.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop_requested = true;
+    }
+    stop_condition.notify_one();
+    reporter.join();
+  }
+
+  if (interval > 0. && start_offset + Get_Counted_Events() >= total_events) {
+    Print(true);
+  }
+}
+
+void ProgressMonitor::Report_Loop() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (!stop_condition.wait_for(lock, std::chrono::duration<G4double>(interval), [] { return stop_requested; })) {
+    Print(false);
+  }
+}
+
+// Formats a time span like "  0d  1h  12mn   5s"
+static G4String Format_Duration(G4double seconds) {
+  const long s = (long)seconds;
+  std::ostringstream stream;
+  stream << setw(3) << s / (24 * 3600) << "d " << setw(2) << (s % (24 * 3600)) / 3600 << "h " << setw(3) << (s % 3600) / 60 << "mn " << setw(3) << s % 60 << "s";
+  return stream.str();
+}
+
+void ProgressMonitor::Print(bool final) {
+  G4long counted = overflow_events.load(std::memory_order_relaxed), min_thread = counters[0].events.load(std::memory_order_relaxed), max_thread = 0;
+  for (auto &counter : counters) {
+    const G4long events = counter.events.load(std::memory_order_relaxed);
+    counted += events;
+    min_thread = std::min(min_thread, events);
+    max_thread = std::max(max_thread, events);
+  }
+  const G4long events = start_offset + counted;
+  const auto now = std::chrono::steady_clock::now();
+  const G4double elapsed = std::chrono::duration<G4double>(now - start_time).count();
+  const G4double since_last = std::chrono::duration<G4double>(now - last_time).count();
+  const G4double average_rate = elapsed > 0. ? counted / elapsed : 0.;
+  const G4double current_rate = since_last > 0. ? (events - last_events) / since_last : 0.;
+  last_events = events;
+  last_time = now;
+
+  std::ostringstream line;
+  line << (final ? "Finished: [" : "Progress: [") << setw(16) << events << "/" << total_events << "]  "
+       << setw(6) << std::setprecision(2) << std::fixed << (total_events > 0 ? 100. * events / total_events : 0.) << " %"
+       << "  Rate: " << std::setprecision(0) << setw(8) << (final ? average_rate : current_rate) << " /s";
+  if (!final) {
+    line << " (average " << average_rate << " /s)";
+  }
+  line << "  Running time: " << Format_Duration(elapsed);
+  if (!final) {
+    line << "  ETA: " << (average_rate > 0. ? Format_Duration((total_events - events) / average_rate) : G4String("unknown"));
+  }
+  if (counters.size() > 1 && counted > 0) {
+    // Relative spread of the number of events per thread, large values indicate idle threads
+    line << "  Threads: " << min_thread << " to " << max_thread << " events (" << std::setprecision(1) << 100. * (max_thread - min_thread) * counters.size() / counted << " % imbalance)";
+  }
+  if (final) {
+    G4cout << line.str() << G4endl;
+  } else {
+    std::cout << line.str() << std::endl;
+  }
+}
@@ -0,0 +1,203 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cctype>
+
+#include "G4LogicalVolumeStore.hh"
+#include "G4Material.hh"
+#include "G4ProductionCuts.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
+#include "G4VSensitiveDetector.hh"
+
+#include "RegionManager.hh"
+
+bool RegionManager::enabled = false;
+const array<G4String, RegionManager::n_roles> RegionManager::role_names = {"sensitive", "target", "shielding", "structural"};
+// Defaults for the UTR: The range cut of 0.1 mm in the detectors and targets is finer than the Geant4 default
+// of 0.7 mm, so that secondaries which are created close to a surface and may escape are still produced.
+// In the lead and concrete shielding, secondaries with ranges of a few mm will hardly ever leave the volume.
+// The cut of the structural volumes, i.e. of Geant4's default region, is only changed if it was set explicitly,
+// so that the default cut and /run/setCut stay in effect.
+array<G4double, RegionManager::n_roles> RegionManager::cuts = {0.1 * mm, 0.1 * mm, 5. * mm, 0.7 * mm};
+bool RegionManager::structural_cut_set = false;
+array<unsigned int, RegionManager::n_roles> RegionManager::n_volumes = {0, 0, 0, 0};
+vector<pair<G4String, RegionManager::Role>> RegionManager::user_patterns;
+// Filters and lead wraps are counted as targets, because they are directly in front of or around the
+// detectors, and their X-rays can be seen in the spectra. Therefore, their patterns are checked before "lead".
+const vector<pair<G4String, RegionManager::Role>> RegionManager::default_patterns = {
+    {"target", target},
+    {"filter", target},
+    {"wrap", target},
+    {"brick", shielding},
+    {"lead", shielding},
+    {"collimator", shielding},
+    {"shield", shielding},
+    {"wall", shielding},
+    {"room", shielding},
+    {"concrete", shielding}};
+const vector<G4String> RegionManager::shielding_materials = {"G4_Pb", "G4_W", "G4_CONCRETE"};
+
+static G4String To_Lower(const G4String &str) {
+  std::string lower = str;
+  std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+  return lower;
+}
+
+static G4String Region_Name(RegionManager::Role role) {
+  if (role == RegionManager::structural) {
+    return "DefaultRegionForTheWorld";
+  }
+  return "utr_" + RegionManager::Get_Role_Name(role);
+}
+
+RegionManager::Role RegionManager::Classify(const G4LogicalVolume *logical_volume) {
+  if (logical_volume->GetSensitiveDetector()) {
+    return sensitive;
+  }
+
+  const G4String name = To_Lower(logical_volume->GetName());
+  for (auto pattern : user_patterns) {
+    if (name.find(To_Lower(pattern.first)) != std::string::npos) {
+      return pattern.second;
+    }
+  }
+  for (auto pattern : default_patterns) {
+    if (name.find(pattern.first) != std::string::npos) {
+      return pattern.second;
+    }
+  }
+
+  if (std::find(shielding_materials.begin(), shielding_materials.end(), logical_volume->GetMaterial()->GetName()) != shielding_materials.end()) {
+    return shielding;
+  }
+
+  return structural;
+}
+
+void RegionManager::Construct_Regions() {
+  if (!enabled) {
+    return;
+  }
+
+  array<G4Region *, n_roles> regions;
+  for (unsigned int i = 0; i < n_roles; ++i) {
+    regions[i] = Get_Region((Role)i);
+  }
+
+  n_volumes.fill(0);
+  for (G4LogicalVolume *logical_volume : *G4LogicalVolumeStore::GetInstance()) {
+    if (logical_volume->IsRootRegion()) {
+      // Skip the world volume and regions which have been defined by a DetectorConstruction.
+      // Volumes from a previous initialization are classified again.
+      const auto region = std::find(regions.begin(), regions.end(), logical_volume->GetRegion());
+      if (region == regions.end() || *region == regions[structural]) {
+        continue;
+      }
+      (*region)->RemoveRootLogicalVolume(logical_volume);
+    }
+
+    const Role role = Classify(logical_volume);
+    ++n_volumes[role];
+    if (role != structural) {
+      regions[role]->AddRootLogicalVolume(logical_volume);
+    }
+  }
+
+  for (unsigned int i = 0; i < n_roles; ++i) {
+    Apply_Cut((Role)i);
+  }
+  Print();
+}
+
+G4Region *RegionManager::Get_Region(Role role) {
+  G4Region *region = G4RegionStore::GetInstance()->GetRegion(Region_Name(role), false);
+  if (!region) {
+    region = new G4Region(Region_Name(role));
+    region->SetProductionCuts(new G4ProductionCuts());
+    region->GetProductionCuts()->SetProductionCut(cuts[role]);
+  }
+  return region;
+}
+
+void RegionManager::Apply_Cut(Role role) {
+  if (role == structural && !structural_cut_set) {
+    return;
+  }
+  G4Region *region = G4RegionStore::GetInstance()->GetRegion(Region_Name(role), false);
+  if (region && region->GetProductionCuts()) {
+    region->GetProductionCuts()->SetProductionCut(cuts[role]);
+  }
+}
+
+bool RegionManager::Find_Role(const G4String &role_name, Role &role) {
+  for (unsigned int i = 0; i < n_roles; ++i) {
+    if (role_names[i] == role_name) {
+      role = (Role)i;
+      return true;
+    }
+  }
+  G4cerr << "Error: Unknown volume role '" << role_name << "'. Possible roles are sensitive, target, shielding and structural." << G4endl;
+  return false;
+}
+
+bool RegionManager::Set_Cut(const G4String &role_name, G4double cut) {
+  Role role;
+  if (!Find_Role(role_name, role)) {
+    return false;
+  }
+  cuts[role] = cut;
+  if (role == structural) {
+    structural_cut_set = true;
+  }
+  // If the regions exist already, Geant4 rebuilds the tables of the production thresholds at the beginning of the next run
+  Apply_Cut(role);
+  return true;
+}
+
+bool RegionManager::Add_Volume(const G4String &role_name, const G4String &pattern) {
+  Role role;
+  if (!Find_Role(role_name, role)) {
+    return false;
+  }
+  user_patterns.push_back({pattern, role});
+  return true;
+}
+
+void RegionManager::Print() {
+  G4cout << "================================================================================" << G4endl;
+  G4cout << "RegionManager: Production cuts for the following volume roles:" << G4endl;
+  for (unsigned int i = 0; i < n_roles; ++i) {
+    G4cout << "\t" << role_names[i] << " (region " << Region_Name((Role)i) << "): ";
+    if (i == structural && !structural_cut_set) {
+      G4cout << "default cut";
+    } else {
+      G4cout << G4BestUnit(cuts[i], "Length");
+    }
+    G4cout << ", " << n_volumes[i] << " logical volumes" << G4endl;
+  }
+  for (auto pattern : user_patterns) {
+    G4cout << "\tUser-defined pattern '" << pattern.first << "' -> " << role_names[pattern.second] << G4endl;
+  }
+  G4cout << "================================================================================" << G4endl;
+}
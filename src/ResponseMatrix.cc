@@ -0,0 +1,131 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cmath>
+#include <string>
+
+#include "G4PrimaryParticle.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4RootAnalysisManager.hh"
+#include "G4RunManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Threading.hh"
+#include "G4UnitsTable.hh"
+#include "Randomize.hh"
+
+#include "GeometryPlugin.hh"
+#include "ResponseMatrix.hh"
+
+G4double ResponseMatrix::energy_min = 0.;
+G4double ResponseMatrix::energy_max = 0.;
+G4double ResponseMatrix::energy_step = 0.;
+G4double ResponseMatrix::bin_width = 10. * keV;
+G4ThreadLocal G4int ResponseMatrix::primaries_id = -1;
+G4ThreadLocal G4int ResponseMatrix::first_matrix_id = -1;
+G4ThreadLocal unsigned int ResponseMatrix::n_matrices = 0;
+
+void ResponseMatrix::Set_Energy_Range(G4double min, G4double max) {
+  if (min < 0. || max <= min) {
+    G4cerr << "Error: ResponseMatrix: Invalid energy range [" << G4BestUnit(min, "Energy") << ", " << G4BestUnit(max, "Energy") << "]." << G4endl;
+    throw std::exception();
+  }
+  energy_min = min;
+  energy_max = max;
+}
+
+void ResponseMatrix::Set_Energy_Step(G4double step) {
+  energy_step = step;
+}
+
+void ResponseMatrix::Set_Bin_Width(G4double width) {
+  bin_width = width;
+}
+
+void ResponseMatrix::Create_Histograms() {
+  if (energy_max <= energy_min) {
+    G4cerr << "Error: ResponseMatrix: No energy range was set for the primary particles. Use /utr/responseMatrix/energyRange before /run/beamOn." << G4endl;
+    throw std::exception();
+  }
+
+  // Grid energies are centered in their bins of the true energy
+  G4int n_true_bins;
+  G4double true_min, true_max;
+  if (energy_step > 0.) {
+    n_true_bins = (G4int)std::floor((energy_max - energy_min) / energy_step + 0.5) + 1;
+    true_min = energy_min - 0.5 * energy_step;
+    true_max = energy_min + (n_true_bins - 0.5) * energy_step;
+  } else {
+    n_true_bins = (G4int)std::ceil((energy_max - energy_min) / bin_width);
+    true_min = energy_min;
+    true_max = energy_min + n_true_bins * bin_width;
+  }
+  const G4int n_deposition_bins = (G4int)std::ceil(true_max / bin_width);
+  const G4double deposition_max = n_deposition_bins * bin_width;
+
+  G4RootAnalysisManager *analysisManager = G4RootAnalysisManager::Instance();
+  primaries_id = analysisManager->CreateH1("primaries", "Number of primary particles", n_true_bins, true_min, true_max);
+  analysisManager->SetH1XAxisTitle(primaries_id, "E_true / MeV");
+
+  n_matrices = GeometryPlugin::Get_Max_Sensitive_Detector_ID() + 1;
+  for (unsigned int i = 0; i < n_matrices; ++i) {
+    const G4int id = analysisManager->CreateH2("det" + std::to_string(i), "Response matrix of detector " + std::to_string(i), n_true_bins, true_min, true_max, n_deposition_bins, 0., deposition_max);
+    analysisManager->SetH2XAxisTitle(id, "E_true / MeV");
+    analysisManager->SetH2YAxisTitle(id, "E_dep / MeV");
+    if (i == 0) {
+      first_matrix_id = id;
+    }
+  }
+
+  if (G4Threading::G4GetThreadId() == -1) {
+    G4cout << "ResponseMatrix: " << n_matrices << " response matrices with " << n_true_bins << " x " << n_deposition_bins << " bins, primary energies " << (energy_step > 0. ? "on a grid" : "uniformly") << " from " << G4BestUnit(energy_min, "Energy") << " to " << G4BestUnit(energy_step > 0. ? energy_min + (n_true_bins - 1) * energy_step : true_max, "Energy") << G4endl;
+  }
+}
+
+void ResponseMatrix::Sample_Primary_Energy(G4Event *event) {
+  G4double energy;
+  if (energy_step > 0.) {
+    const G4int n_energies = (G4int)std::floor((energy_max - energy_min) / energy_step + 0.5) + 1;
+    energy = energy_min + energy_step * (G4int)(G4UniformRand() * n_energies);
+  } else {
+    energy = energy_min + (energy_max - energy_min) * G4UniformRand();
+  }
+
+  for (G4int i = 0; i < event->GetNumberOfPrimaryVertex(); ++i) {
+    for (G4PrimaryParticle *primary = event->GetPrimaryVertex(i)->GetPrimary(); primary; primary = primary->GetNext()) {
+      primary->SetKineticEnergy(energy);
+    }
+  }
+}
+
+G4double ResponseMatrix::Get_True_Energy(const G4Event *event) {
+  return event->GetPrimaryVertex(0)->GetPrimary()->GetKineticEnergy();
+}
+
+void ResponseMatrix::Fill_Primary(const G4Event *event) {
+  G4RootAnalysisManager::Instance()->FillH1(primaries_id, Get_True_Energy(event));
+}
+
+void ResponseMatrix::Fill(unsigned int detector_id, G4double energy_deposition, G4double weight) {
+  if (detector_id >= n_matrices) {
+    return;
+  }
+  const G4Event *event = G4RunManager::GetRunManager()->GetCurrentEvent();
+  G4RootAnalysisManager::Instance()->FillH2(first_matrix_id + detector_id, Get_True_Energy(event), energy_deposition, weight);
+}
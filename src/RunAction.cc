@@ -28,28 +28,69 @@ along with utr.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "G4FileUtilities.hh"
 
-#include "DetectorConstruction.hh"
+#include "GeometryPlugin.hh"
+#include "DetectorResponse.hh"
+#include "EnergySweep.hh"
 #include "G4RootAnalysisManager.hh"
+#include "ImportanceSampling.hh"
+#include "ProgressMonitor.hh"
+#include "ResponseMatrix.hh"
+#include "RunChain.hh"
+#include "Sharding.hh"
 #include "RunAction.hh"
+#include "TrackKiller.hh"
 #include "utrFilenameTools.hh"
 #include <limits.h>
 
 #include "utrConfig.h"
 
-RunAction::RunAction() : G4UserRunAction() {}
+RunAction::RunAction() : G4UserRunAction(), outputOpen(false) {}
 
 RunAction::~RunAction() { delete G4RootAnalysisManager::Instance(); }
 
-void RunAction::BeginOfRunAction(const G4Run *) {
+void RunAction::BeginOfRunAction(const G4Run *run) {
   // Get analysis manager
   G4RootAnalysisManager *analysisManager = G4RootAnalysisManager::Instance();
 
-#ifdef EVENT_EVENTWISE
+#ifdef IMPORTANCE_BIASING
+  ImportanceSampling::Fill_Importance_Store();
+  if (IsMaster()) {
+    ImportanceSampling::Print();
+  }
+#endif
+
+  if (IsMaster()) {
+    // The sub-runs of a RunChain are counted as a single run
+    if (RunChain::Get_Total_Events() == 0) {
+      Sharding::Next_Run();
+    }
+    ProgressMonitor::Start(run->GetNumberOfEventToBeProcessed());
+  }
+
+  // Later sub-runs of a RunChain continue to write to the output file of the first sub-run
+  if (outputOpen) {
+    return;
+  }
+  outputOpen = true;
+
+  if (IsMaster()) {
+    TrackKiller::Reset();
+  }
+
+#ifdef RESPONSE_MATRIX
+  ResponseMatrix::Create_Histograms();
+#elif defined EVENT_EVENTWISE
   analysisManager->CreateNtuple("edep", "Energy Deposition");
-  auto max_sensitive_detector_ID = ((DetectorConstruction *)G4RunManager::GetRunManager()->GetUserDetectorConstruction())->Max_Sensitive_Detector_ID;
+  auto max_sensitive_detector_ID = GeometryPlugin::Get_Max_Sensitive_Detector_ID();
   for (size_t i = 0; i < max_sensitive_detector_ID + 1; ++i) {
     analysisManager->CreateNtupleDColumn("det" + std::to_string(i));
   }
+#ifdef EVENT_WEIGHT
+  analysisManager->CreateNtupleDColumn("weight");
+#endif
+  if (EnergySweep::Is_Active()) {
+    analysisManager->CreateNtupleDColumn("ebeam");
+  }
 #else
   analysisManager->CreateNtuple("utr", "Particle information");
 #ifdef EVENT_ID
@@ -85,8 +126,18 @@ void RunAction::BeginOfRunAction(const G4Run *) {
 #ifdef EVENT_MOMZ
   analysisManager->CreateNtupleDColumn("vz");
 #endif
+#ifdef EVENT_WEIGHT
+  analysisManager->CreateNtupleDColumn("weight");
+  analysisManager->CreateNtupleDColumn("copy");
+#endif
+  if (EnergySweep::Is_Active()) {
+    analysisManager->CreateNtupleDColumn("ebeam");
+  }
 #endif
+#ifndef RESPONSE_MATRIX
   analysisManager->FinishNtuple();
+#endif
+  Sharding::Create_Metadata_Ntuple();
 
   // Open an output file
   // Geant4 in Multithreading mode creates files with naming convention
@@ -96,11 +147,14 @@ void RunAction::BeginOfRunAction(const G4Run *) {
   // where the filename is given by the user in analysisManager->OpenFile()
 
   if (IsMaster()) { // G4UserRunAction::IsMaster should be equivalent to G4Threading::G4GetThreadId() == -1
-    // Master thread (running this function before all other threads) increments the file ID to use, if used
+    // Master thread (running this function before all other threads) increments and reserves the file ID to use, if used
     if (utrFilenameTools::getUseFilenameID()) {
-      utrFilenameTools::incrementFilenameID();
+      utrFilenameTools::reserveNextFilenameID();
     }
-    analysisManager->OpenFile(utrFilenameTools::getMasterFilename());
+    if (!MasterWritesOutput()) {
+      return;
+    }
+    analysisManager->OpenFile(utrFilenameTools::createMasterFile());
   } else {
     // Worker threads check whether their designated output file already exists and if so abort
     G4FileUtilities fu;
@@ -119,15 +173,55 @@ void RunAction::BeginOfRunAction(const G4Run *) {
       analysisManager->OpenFile(filename.str());
     }
   }
+
+  Sharding::Fill_Metadata_Ntuple();
 }
 
 void RunAction::EndOfRunAction(const G4Run *) {
-  G4RootAnalysisManager *analysisManager = G4RootAnalysisManager::Instance();
+  if (IsMaster()) {
+    ProgressMonitor::Stop();
+  }
 
-  analysisManager->Write();
-  analysisManager->CloseFile();
+  // The worker threads finish their runs before the master
+  TrackKiller::Merge();
+#ifdef FAST_DETECTOR_RESPONSE
+  if (DetectorResponse::Calibrating()) {
+    DetectorResponse::Merge();
+  }
+#endif
+
+  if (RunChain::Keeps_Output_Open()) {
+    return;
+  }
+
+  if (!IsMaster() || MasterWritesOutput()) {
+    G4RootAnalysisManager *analysisManager = G4RootAnalysisManager::Instance();
+    analysisManager->Write();
+    analysisManager->CloseFile();
+  }
 
   delete G4RootAnalysisManager::Instance();
+  outputOpen = false;
+
+  if (IsMaster()) {
+    // The worker threads have closed their output files before, which now mark the file ID as used
+    utrFilenameTools::releaseFilenameID();
+    TrackKiller::Print();
+  }
+
+#ifdef FAST_DETECTOR_RESPONSE
+  if (DetectorResponse::Calibrating() && IsMaster()) {
+    DetectorResponse::Write();
+  }
+#endif
+}
+
+G4bool RunAction::MasterWritesOutput() {
+#ifdef RESPONSE_MATRIX
+  return true;
+#else
+  return !G4Threading::IsMultithreadedApplication();
+#endif
 }
 
 G4String RunAction::GetOutputFlagName(unsigned int n) {
@@ -154,6 +248,10 @@ G4String RunAction::GetOutputFlagName(unsigned int n) {
       return "MOMY";
     case MOMZ:
       return "MOMZ";
+    case WEIGHT:
+      return "WEIGHT";
+    case COPY:
+      return "COPY";
     default:
       G4cout << "RunAction: Error! Output flag index not found." << G4endl;
       return "";
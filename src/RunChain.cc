@@ -0,0 +1,143 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+#include "G4RunManager.hh"
+
+#include "RunChain.hh"
+#include "utrFilenameTools.hh"
+
+G4long RunChain::total_events = 0;
+G4long RunChain::event_offset = 0;
+G4long RunChain::n_events_left = 0;
+G4long RunChain::checkpoint_events = 0;
+G4String RunChain::manifest_filename = "";
+G4long RunChain::resume_total_events = 0;
+G4long RunChain::resume_checkpoint_events = 0;
+G4long RunChain::resume_completed_events = 0;
+
+void RunChain::BeamOn(G4long n_events) {
+  if (n_events <= 0) {
+    G4cerr << "Error: RunChain: The number of events must be positive." << G4endl;
+    return;
+  }
+  const G4long sub_run_events = checkpoint_events > 0 ? std::min(checkpoint_events, (G4long)max_events_per_run) : max_events_per_run;
+
+  total_events = n_events;
+  event_offset = 0;
+  if (resume_total_events > 0) {
+    if (n_events != resume_total_events || checkpoint_events != resume_checkpoint_events || resume_completed_events % sub_run_events != 0) {
+      G4cerr << "Error: RunChain: The checkpoint was written for /utr/beamOn64 " << resume_total_events << " with " << resume_checkpoint_events << " events per checkpoint." << G4endl;
+      throw std::exception();
+    }
+    event_offset = resume_completed_events;
+    resume_total_events = 0;
+    G4cout << "RunChain: Resuming after " << event_offset << " completed events" << G4endl;
+  }
+  n_events_left = n_events - event_offset;
+  const G4long n_sub_runs = (n_events - 1) / sub_run_events + 1;
+
+  Sharding::Next_Run();
+  G4RunManager *runManager = G4RunManager::GetRunManager();
+  for (G4long sub_run = event_offset / sub_run_events; n_events_left > 0; ++sub_run) {
+    const G4int n_events_sub_run = (G4int)std::min(n_events_left, sub_run_events);
+    n_events_left -= n_events_sub_run;
+    if (sub_run > 0) {
+      Sharding::Reseed(sub_run);
+    }
+    G4cout << "RunChain: Sub-run " << sub_run + 1 << "/" << n_sub_runs << " with " << n_events_sub_run << " events" << G4endl;
+    runManager->BeamOn(n_events_sub_run);
+    event_offset += n_events_sub_run;
+    if (checkpoint_events > 0) {
+      Write_Manifest();
+    }
+  }
+
+  total_events = 0;
+  event_offset = 0;
+}
+
+G4String RunChain::Get_Manifest() {
+  if (manifest_filename != "") {
+    return manifest_filename;
+  }
+  return utrFilenameTools::getOutputDir() + "/" + utrFilenameTools::getFilenamePrefix() + ".checkpoint";
+}
+
+void RunChain::Write_Manifest() {
+  // Replace the previous manifest atomically, so that a preemption never leaves a partial one
+  const G4String filename = Get_Manifest();
+  const G4String temporary_filename = filename + ".tmp";
+  std::ofstream file(temporary_filename);
+  if (!file.is_open()) {
+    G4cerr << "Error: RunChain: Could not open '" << temporary_filename << "' for writing." << G4endl;
+    return;
+  }
+  file << "# utr checkpoint, resume with: utr --resume " << filename << " (same macro file and options)" << std::endl;
+  file << "seed " << Sharding::Get_Master_Seed() << std::endl;
+  file << "shard " << Sharding::Get_Shard_Index() << " " << Sharding::Get_Number_Of_Shards() << std::endl;
+  file << "total_events " << total_events << std::endl;
+  file << "checkpoint_events " << checkpoint_events << std::endl;
+  file << "completed_events " << event_offset << std::endl;
+  file.close();
+  if (std::rename(temporary_filename.c_str(), filename.c_str()) != 0) {
+    G4cerr << "Error: RunChain: Could not write the checkpoint '" << filename << "'." << G4endl;
+    return;
+  }
+  G4cout << "RunChain: Checkpoint after " << event_offset << "/" << total_events << " events written to " << filename << G4endl;
+}
+
+bool RunChain::Resume(const G4String &filename) {
+  std::ifstream file(filename);
+  if (!file.is_open()) {
+    G4cerr << "Error: RunChain: Could not open the checkpoint '" << filename << "'." << G4endl;
+    return false;
+  }
+  G4long seed = 0, shard_index = 0, n_shards = 0;
+  for (std::string key; file >> key;) {
+    if (key[0] == '#') {
+      std::getline(file, key);
+    } else if (key == "seed") {
+      file >> seed;
+    } else if (key == "shard") {
+      file >> shard_index >> n_shards;
+    } else if (key == "total_events") {
+      file >> resume_total_events;
+    } else if (key == "checkpoint_events") {
+      file >> resume_checkpoint_events;
+    } else if (key == "completed_events") {
+      file >> resume_completed_events;
+    } else {
+      G4cerr << "Error: RunChain: Unknown key '" << key << "' in the checkpoint '" << filename << "'." << G4endl;
+      return false;
+    }
+  }
+  if (resume_total_events <= 0 || resume_checkpoint_events <= 0 || n_shards <= 0 || !Sharding::Set_Shard(std::to_string(shard_index) + "/" + std::to_string(n_shards)) || !Sharding::Set_Master_Seed(seed)) {
+    G4cerr << "Error: RunChain: Invalid checkpoint '" << filename << "'." << G4endl;
+    return false;
+  }
+  checkpoint_events = resume_checkpoint_events;
+  manifest_filename = filename;
+  G4cout << "RunChain: Resuming from '" << filename << "' after " << resume_completed_events << "/" << resume_total_events << " events" << G4endl;
+  return true;
+}
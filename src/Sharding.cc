@@ -0,0 +1,106 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cstdlib>
+#include <ctime>
+#include <unistd.h>
+
+#include "CLHEP/Random/MixMaxRng.h"
+#include "G4RootAnalysisManager.hh"
+#include "G4Threading.hh"
+#include "Randomize.hh"
+
+#include "RunChain.hh"
+#include "Sharding.hh"
+
+G4long Sharding::master_seed = 0;
+G4bool Sharding::master_seed_set = false;
+G4long Sharding::shard_index = 0;
+G4long Sharding::n_shards = 1;
+G4long Sharding::run_index = 0;
+G4ThreadLocal G4int Sharding::metadata_ntuple_id = -1;
+
+bool Sharding::Set_Shard(const G4String &shard) {
+  const size_t slash = shard.find('/');
+  if (slash == std::string::npos) {
+    return false;
+  }
+  char *end;
+  shard_index = std::strtol(shard.substr(0, slash).c_str(), &end, 10);
+  if (*end != '\0') {
+    return false;
+  }
+  n_shards = std::strtol(shard.substr(slash + 1).c_str(), &end, 10);
+  if (*end != '\0') {
+    return false;
+  }
+  // The shard index is part of the seed of each event with 16 bits, but the event IDs limit it to 13 bits
+  return n_shards > 0 && n_shards <= max_shards && shard_index >= 0 && shard_index < n_shards;
+}
+
+void Sharding::Seed_Engine() {
+  if (!master_seed_set) {
+    // Processes which are started in the same second still get different seeds
+    master_seed = ((G4long)std::time(nullptr) ^ ((G4long)getpid() << 16)) & max_master_seed;
+  }
+  G4Random::setTheEngine(new CLHEP::MixMaxRng);
+  long seeds[3] = {master_seed, shard_index, 0};
+  G4Random::setTheSeeds(seeds, 2);
+  G4cout << "Random number engine: MixMax, master seed " << master_seed << ", shard " << shard_index << "/" << n_shards << G4endl;
+}
+
+void Sharding::Reseed(G4long sub_run) {
+  long seeds[4] = {master_seed, shard_index, sub_run, 0};
+  G4Random::setTheSeeds(seeds, 3);
+}
+
+void Sharding::Seed_Event(G4int event_id) {
+  // A RunChain counts its events over all sub-runs, so the seeds do not depend on the size of the sub-runs
+  const G4long event_index = RunChain::Get_Event_Offset() + event_id;
+  long seeds[5] = {master_seed, (shard_index << 16) | (run_index & 0xffff), event_index >> 32, event_index & 0xffffffffL, 0};
+  G4Random::setTheSeeds(seeds, 4);
+}
+
+void Sharding::Create_Metadata_Ntuple() {
+  if (!Is_Used()) {
+    return;
+  }
+  G4RootAnalysisManager *analysisManager = G4RootAnalysisManager::Instance();
+  metadata_ntuple_id = analysisManager->CreateNtuple("metadata", "Seed and shard of the simulation");
+  analysisManager->CreateNtupleDColumn(metadata_ntuple_id, "seed");
+  analysisManager->CreateNtupleDColumn(metadata_ntuple_id, "shard");
+  analysisManager->CreateNtupleDColumn(metadata_ntuple_id, "nshards");
+  analysisManager->CreateNtupleDColumn(metadata_ntuple_id, "eventoffset");
+  analysisManager->CreateNtupleDColumn(metadata_ntuple_id, "thread");
+  analysisManager->FinishNtuple(metadata_ntuple_id);
+}
+
+void Sharding::Fill_Metadata_Ntuple() {
+  if (!Is_Used()) {
+    return;
+  }
+  G4RootAnalysisManager *analysisManager = G4RootAnalysisManager::Instance();
+  analysisManager->FillNtupleDColumn(metadata_ntuple_id, 0, master_seed);
+  analysisManager->FillNtupleDColumn(metadata_ntuple_id, 1, shard_index);
+  analysisManager->FillNtupleDColumn(metadata_ntuple_id, 2, n_shards);
+  analysisManager->FillNtupleDColumn(metadata_ntuple_id, 3, Get_Event_ID_Offset());
+  analysisManager->FillNtupleDColumn(metadata_ntuple_id, 4, G4Threading::G4GetThreadId());
+  analysisManager->AddNtupleRow(metadata_ntuple_id);
+}
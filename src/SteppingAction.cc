@@ -0,0 +1,50 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "G4Step.hh"
+#include "G4Track.hh"
+
+#include "BiasedCopies.hh"
+#include "DetectorResponse.hh"
+#include "SteppingAction.hh"
+#include "TrackKiller.hh"
+#include "utrConfig.h"
+
+SteppingAction::SteppingAction() : G4UserSteppingAction() {}
+
+SteppingAction::~SteppingAction() {}
+
+void SteppingAction::UserSteppingAction(const G4Step *step) {
+  if (TrackKiller::Leaves_ROI(step->GetPreStepPoint()->GetPosition(), step->GetPostStepPoint()->GetPosition())) {
+    G4Track *track = step->GetTrack();
+    TrackKiller::Count_ROI_Kill(track->GetKineticEnergy());
+    track->SetTrackStatus(fStopAndKill);
+  }
+
+#ifdef FAST_DETECTOR_RESPONSE
+  if (DetectorResponse::Calibrating()) {
+    DetectorResponse::Record_Step(step);
+  }
+#endif
+
+#if defined(IMPORTANCE_BIASING) || defined(FORCED_COLLISION) || defined(DIRECTIONAL_SPLITTING)
+  BiasedCopies::Update(step);
+#endif
+}
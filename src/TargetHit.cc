@@ -35,6 +35,8 @@ TargetHit::TargetHit(const TargetHit &right) : G4VHit() {
   detectorID = right.detectorID;
   pos = right.pos;
   mom = right.mom;
+  weight = right.weight;
+  copyID = right.copyID;
 }
 
 const TargetHit &TargetHit::operator=(const TargetHit &right) {
@@ -45,6 +47,8 @@ const TargetHit &TargetHit::operator=(const TargetHit &right) {
   detectorID = right.detectorID;
   pos = right.pos;
   mom = right.mom;
+  weight = right.weight;
+  copyID = right.copyID;
 
   return *this;
 }
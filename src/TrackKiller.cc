@@ -0,0 +1,148 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "G4AutoLock.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
+#include "G4VPhysicalVolume.hh"
+
+#include "TrackKiller.hh"
+
+namespace {
+G4Mutex statistics_mutex = G4MUTEX_INITIALIZER;
+}
+
+array<G4double, RegionManager::n_roles> TrackKiller::thresholds = {0., 0., 0., 0.};
+G4bool TrackKiller::any_threshold = false;
+TrackKiller::ROI_Shape TrackKiller::roi_shape = TrackKiller::none;
+G4ThreeVector TrackKiller::roi_center = G4ThreeVector();
+G4ThreeVector TrackKiller::roi_half_lengths = G4ThreeVector();
+G4double TrackKiller::roi_radius = 0.;
+G4ThreadLocal TrackKiller::Statistics *TrackKiller::thread_statistics = nullptr;
+TrackKiller::Statistics TrackKiller::total_statistics = TrackKiller::Statistics();
+G4ThreadLocal unordered_map<const G4LogicalVolume *, RegionManager::Role> *TrackKiller::roles = nullptr;
+
+void TrackKiller::Statistics::Add(const Statistics &other) {
+  for (unsigned int i = 0; i < RegionManager::n_roles; ++i) {
+    threshold_kills[i] += other.threshold_kills[i];
+    threshold_energy[i] += other.threshold_energy[i];
+  }
+  roi_kills += other.roi_kills;
+  roi_energy += other.roi_energy;
+}
+
+void TrackKiller::Set_Threshold(RegionManager::Role role, G4double threshold) {
+  if (role == RegionManager::sensitive && threshold > 0.) {
+    G4cout << "TrackKiller: Warning: Killing tracks in sensitive volumes changes the energy deposition in the detectors." << G4endl;
+  }
+  thresholds[role] = threshold;
+  any_threshold = false;
+  for (auto t : thresholds) {
+    any_threshold = any_threshold || t > 0.;
+  }
+}
+
+void TrackKiller::Set_ROI_Box(G4ThreeVector half_lengths) {
+  roi_shape = box;
+  roi_half_lengths = half_lengths;
+}
+
+void TrackKiller::Set_ROI_Sphere(G4double radius) {
+  roi_shape = sphere;
+  roi_radius = radius;
+}
+
+bool TrackKiller::Inside_ROI(const G4ThreeVector &position) {
+  const G4ThreeVector relative_position = position - roi_center;
+  if (roi_shape == box) {
+    return std::abs(relative_position.x()) <= roi_half_lengths.x() && std::abs(relative_position.y()) <= roi_half_lengths.y() && std::abs(relative_position.z()) <= roi_half_lengths.z();
+  }
+  return relative_position.mag2() <= roi_radius * roi_radius;
+}
+
+RegionManager::Role TrackKiller::Get_Role(const G4LogicalVolume *logical_volume) {
+  if (!roles) {
+    roles = new unordered_map<const G4LogicalVolume *, RegionManager::Role>();
+  }
+  auto role = roles->find(logical_volume);
+  if (role == roles->end()) {
+    role = roles->emplace(logical_volume, RegionManager::Classify(logical_volume)).first;
+  }
+  return role->second;
+}
+
+bool TrackKiller::Below_Threshold(const G4Track *track) {
+  if (!any_threshold || track->GetParentID() == 0 || track->GetDefinition()->GetPDGCharge() == 0. || !track->GetVolume()) {
+    return false;
+  }
+
+  const RegionManager::Role role = Get_Role(track->GetVolume()->GetLogicalVolume());
+  if (track->GetKineticEnergy() >= thresholds[role]) {
+    return false;
+  }
+
+  if (!thread_statistics) {
+    thread_statistics = new Statistics();
+  }
+  ++thread_statistics->threshold_kills[role];
+  thread_statistics->threshold_energy[role] += track->GetKineticEnergy();
+  return true;
+}
+
+void TrackKiller::Count_ROI_Kill(G4double kinetic_energy) {
+  if (!thread_statistics) {
+    thread_statistics = new Statistics();
+  }
+  ++thread_statistics->roi_kills;
+  thread_statistics->roi_energy += kinetic_energy;
+}
+
+void TrackKiller::Merge() {
+  if (!thread_statistics) {
+    return;
+  }
+  G4AutoLock lock(&statistics_mutex);
+  total_statistics.Add(*thread_statistics);
+  *thread_statistics = Statistics();
+}
+
+void TrackKiller::Reset() {
+  G4AutoLock lock(&statistics_mutex);
+  total_statistics = Statistics();
+}
+
+void TrackKiller::Print() {
+  if (!any_threshold && roi_shape == none) {
+    return;
+  }
+
+  G4AutoLock lock(&statistics_mutex);
+  G4cout << "================================================================================" << G4endl;
+  G4cout << "TrackKiller: Killed tracks in this run:" << G4endl;
+  for (unsigned int i = 0; i < RegionManager::n_roles; ++i) {
+    if (thresholds[i] > 0.) {
+      G4cout << "\tCharged secondaries below " << G4BestUnit(thresholds[i], "Energy") << " in " << RegionManager::Get_Role_Name((RegionManager::Role)i) << " volumes: " << total_statistics.threshold_kills[i] << " tracks, " << G4BestUnit(total_statistics.threshold_energy[i], "Energy") << G4endl;
+    }
+  }
+  if (roi_shape != none) {
+    G4cout << "\tTracks leaving the region of interest: " << total_statistics.roi_kills << " tracks, " << G4BestUnit(total_statistics.roi_energy, "Energy") << G4endl;
+  }
+  G4cout << "================================================================================" << G4endl;
+}
@@ -0,0 +1,139 @@
+/*
+utr - Geant4 simulation of the UTR at HIGS
+Copyright (C) 2017 the developing team (see README.md)
+
+This file is part of utr.
+
+utr is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+utr is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with utr.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include "G4Threading.hh"
+
+#include "WorkerInitialization.hh"
+
+WorkerInitialization::Pinning WorkerInitialization::pinning = WorkerInitialization::none;
+
+bool WorkerInitialization::Set_Pinning(const G4String &mode) {
+  if (mode == "none") {
+    pinning = none;
+  } else if (mode == "core") {
+    pinning = core;
+  } else if (mode == "node") {
+    pinning = node;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Parses a Linux CPU list like "0-3,8,10-11"
+static vector<int> Parse_CPU_List(const std::string &list) {
+  vector<int> cpus;
+  std::istringstream stream(list);
+  for (std::string range; std::getline(stream, range, ',');) {
+    const size_t dash = range.find('-');
+    const int first = std::stoi(range.substr(0, dash));
+    const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+    for (int cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+vector<vector<int>> WorkerInitialization::Get_CPU_Sets() {
+  vector<vector<int>> cpu_sets;
+#ifdef __linux__
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+    return cpu_sets;
+  }
+
+  if (pinning == node) {
+    for (int node_id = 0;; ++node_id) {
+      std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(node_id) + "/cpulist");
+      std::string list;
+      if (!(cpulist >> list)) {
+        break;
+      }
+      vector<int> cpus;
+      for (int cpu : Parse_CPU_List(list)) {
+        if (CPU_ISSET(cpu, &allowed)) {
+          cpus.push_back(cpu);
+        }
+      }
+      if (!cpus.empty()) {
+        cpu_sets.push_back(cpus);
+      }
+    }
+  }
+  // Without NUMA information in /sys, all allowed CPUs form a single node
+  if (pinning == core || cpu_sets.empty()) {
+    vector<int> cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &allowed)) {
+        cpus.push_back(cpu);
+      }
+    }
+    if (pinning == core) {
+      for (int cpu : cpus) {
+        cpu_sets.push_back({cpu});
+      }
+    } else {
+      cpu_sets.push_back(cpus);
+    }
+  }
+#endif
+  return cpu_sets;
+}
+
+void WorkerInitialization::WorkerInitialize() const {
+  if (pinning == none) {
+    return;
+  }
+#ifdef __linux__
+  // The CPU sets are determined once by the first worker, before any thread was pinned (the initialization of a static local variable is thread-safe)
+  static const vector<vector<int>> cpu_sets = Get_CPU_Sets();
+  if (cpu_sets.empty()) {
+    return;
+  }
+
+  const G4int thread_id = G4Threading::G4GetThreadId();
+  const vector<int> &cpus = cpu_sets[thread_id % cpu_sets.size()];
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int cpu : cpus) {
+    CPU_SET(cpu, &cpu_set);
+  }
+  if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+    G4cerr << "Warning: WorkerInitialization: Could not pin thread " << thread_id << G4endl;
+    return;
+  }
+  if (pinning == core) {
+    G4cout << "WorkerInitialization: Thread " << thread_id << " pinned to CPU " << cpus[0] << G4endl;
+  } else {
+    G4cout << "WorkerInitialization: Thread " << thread_id << " pinned to NUMA node " << thread_id % cpu_sets.size() << " (" << cpus.size() << " CPUs)" << G4endl;
+  }
+#else
+  G4cerr << "Warning: WorkerInitialization: Pinning of threads is only supported on Linux" << G4endl;
+#endif
+}
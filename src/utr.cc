@@ -18,23 +18,34 @@ You should have received a copy of the GNU General Public License
 along with utr.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <cstdlib>
+
 #include "G4FileUtilities.hh"
 #include "G4MTRunManager.hh"
 #include "G4RunManager.hh"
+#include "G4Threading.hh"
+#include "G4Version.hh"
+#if G4VERSION_NUMBER >= 1070
+#include "G4RunManagerFactory.hh"
+#include "G4TaskRunManager.hh"
+#endif
 #include "G4UImanager.hh"
 #include "G4VisExecutive.hh"
 #include "G4VisManager.hh"
 
 #include "ActionInitialization.hh"
-#include "DetectorConstruction.hh"
+#include "CachedDetectorConstruction.hh"
+#include "FastSimulationDetectorConstruction.hh"
+#include "BiasingDetectorConstruction.hh"
+#include "GeometryPlugin.hh"
 #include "Physics.hh"
+#include "RunChain.hh"
+#include "Sharding.hh"
+#include "SharedVolumes.hh"
+#include "WorkerInitialization.hh"
 #include "utrFilenameTools.hh"
 #include "utrMessenger.hh"
 
-#ifdef EVENT_EVENTWISE
-#include "EnergyDepositionSD.hh"
-#endif
-
 #include "G4UIExecutive.hh"
 #include "G4UImanager.hh"
 
@@ -52,23 +63,69 @@ static char doc[] = "GEANT4 simulation of the UTR at HIGS";
 static char args_doc[] = "";
 static struct argp_option options[] = {
     {"macrofile", 'm', "MACRO", 0, "Macro file", 0},
-    {"nthreads", 't', "THREAD", 0, "Number of threads", 0},
+    {"nthreads", 't', "THREAD", 0, "Number of threads, or 'auto' for the number of cores", 0},
+    {"runmanager", 'r', "TYPE", 0, "Run manager: mt (default), tasking (requires Geant4 10.7 or later) or serial", 0},
+    {"seed", 's', "SEED", 0, "Master seed of the random number engine, 0 <= SEED < 2^32 (default: from the time and the process ID)", 0},
+    {"shard", 'j', "I/N", 0, "Run shard I (0 <= I < N <= 8192) of a simulation which is split into N independent processes with the same seed. Selects an independent random number stream and shifts the event IDs by I * 2^40", 0},
+    {"resume", 'u', "CHECKPOINT", 0, "Resume an interrupted /utr/beamOn64 chain from the manifest written by /utr/checkpoint/events. The seed and shard are taken from the manifest, the macro file must be the same", 0},
+    {"pin", 'p', "MODE", 0, "Pin each worker thread to a CPU core ('core') or to the cores of a NUMA node ('node'), which also keeps its memory on that node (default: none, Linux only)", 0},
+    {"grainsize", 'k', "NTASKS", 0, "Number of tasks into which the events of a run are divided by the tasking run manager (default: number of threads). More tasks than threads balance the load between the threads if the events take very different times", 0},
     {"outputdir", 'o', "OUTPUTDIR", 0, "Output directory", 0},
     {"filename", 'f', "PREFIX", 0, "Output files' name prefix", 0},
+    {"geometry", 'g', "CAMPAIGN/SETUP", 0, "Geometry plugin to load (requires the GEOMETRY_PLUGINS build option)", 0},
+    {"geometrycache", 'c', "CACHEDIR", 0, "Read the geometry from a GDML file in CACHEDIR instead of constructing it, or write it there if it does not exist yet (requires the WITH_GDML build option)", 0},
+    {"em", 'e', "LIST", 0, "Comma-separated EM physics: auto, fast, standard, livermore, livermore_polarized, penelope, extra or none (default: given by the EM_* build options). 'auto' uses the polarized Livermore models only if the macro file sets a polarized beam", 0},
+    {"elastic", 'l', "LIST", 0, "Hadronic elastic physics: standard, hp, lend or none (default: given by the HADRON_ELASTIC_* build options)", 0},
+    {"inelastic", 'i', "LIST", 0, "Hadronic inelastic physics: standard, hp, lend or none (default: given by the HADRON_INELASTIC_* build options)", 0},
     {0, 0, 0, 0, 0, 0}};
 
 struct arguments {
-  int nthreads = 1;
+  int nthreads = 1; // 0: number of cores
+  string runmanager = "mt";
+  int grainsize = 0;
+  string resume = "";
   char *macrofile = 0;
   string outputdir = "output";
   string filenameprefix = "utr";
+  string geometry = "";
+  string geometrycache = "";
+  string em = "";
+  string elastic = "";
+  string inelastic = "";
 };
 
 static error_t parse_opt(int key, char *arg, struct argp_state *state) {
   struct arguments *arguments = (struct arguments *)state->input;
   switch (key) {
     case 't':
-      arguments->nthreads = atoi(arg);
+      arguments->nthreads = string(arg) == "auto" ? 0 : atoi(arg);
+      break;
+    case 'r':
+      arguments->runmanager = arg;
+      break;
+    case 'k':
+      arguments->grainsize = atoi(arg);
+      break;
+    case 'p':
+      if (!WorkerInitialization::Set_Pinning(arg)) {
+        argp_error(state, "Invalid pinning '%s', expected none, core or node", arg);
+      }
+      break;
+    case 's': {
+      char *end;
+      const G4long seed = std::strtol(arg, &end, 10);
+      if (*end != '\0' || !Sharding::Set_Master_Seed(seed)) {
+        argp_error(state, "Invalid seed '%s', expected an integer with 0 <= SEED < 2^32", arg);
+      }
+      break;
+    }
+    case 'j':
+      if (!Sharding::Set_Shard(arg)) {
+        argp_error(state, "Invalid shard '%s', expected I/N with 0 <= I < N <= 8192", arg);
+      }
+      break;
+    case 'u':
+      arguments->resume = arg;
       break;
     case 'm':
       arguments->macrofile = arg;
@@ -79,6 +136,21 @@ static error_t parse_opt(int key, char *arg, struct argp_state *state) {
     case 'f':
       arguments->filenameprefix = arg;
       break;
+    case 'g':
+      arguments->geometry = arg;
+      break;
+    case 'c':
+      arguments->geometrycache = arg;
+      break;
+    case 'e':
+      arguments->em = arg;
+      break;
+    case 'l':
+      arguments->elastic = arg;
+      break;
+    case 'i':
+      arguments->inelastic = arg;
+      break;
     default:
       return ARGP_ERR_UNKNOWN;
   }
@@ -92,41 +164,109 @@ int main(int argc, char *argv[]) {
   struct arguments arguments;
   argp_parse(&argp, argc, argv, 0, 0, &arguments);
 
-  G4Random::setTheEngine(new CLHEP::RanecuEngine);
-  // 'Real' random results
-  time_t timer;
-  G4Random::setTheSeed(time(&timer));
-  // Deterministic results
-  // G4Random::setTheSeed(1);
+  if (arguments.geometry != "" && !GeometryPlugin::Load(arguments.geometry)) {
+    return 1;
+  }
+
+  if (arguments.resume != "" && !RunChain::Resume(arguments.resume)) {
+    return 1;
+  }
+  Sharding::Seed_Engine();
 
   // Pass output directory and filenamePrefix to RunAction via utrFilenameTools, also find next free filename ID
   utrFilenameTools::setOutputDir(arguments.outputdir);
   utrFilenameTools::setFilenamePrefix(arguments.filenameprefix);
   utrFilenameTools::findNextFreeFilenameID();
 
+  if (arguments.nthreads == 0) {
+    arguments.nthreads = G4Threading::G4GetNumberOfCores();
+    G4cout << "Using " << arguments.nthreads << " threads" << G4endl;
+  }
+#ifndef G4MULTITHREADED
+  arguments.runmanager = "serial";
+#endif
+#if G4VERSION_NUMBER >= 1070
+  G4RunManagerType runManagerType;
+  if (arguments.runmanager == "mt") {
+    runManagerType = G4RunManagerType::MT;
+  } else if (arguments.runmanager == "tasking") {
+    runManagerType = G4RunManagerType::Tasking;
+  } else if (arguments.runmanager == "serial") {
+    runManagerType = G4RunManagerType::Serial;
+  } else {
+    G4cerr << "Error: Unknown run manager '" << arguments.runmanager << "'. Choose from mt, tasking or serial." << G4endl;
+    return 1;
+  }
+  G4RunManager *runManager = G4RunManagerFactory::CreateRunManager(runManagerType, arguments.nthreads);
+  if (arguments.grainsize > 0) {
+    G4TaskRunManager *taskRunManager = dynamic_cast<G4TaskRunManager *>(runManager);
+    if (taskRunManager) {
+      taskRunManager->SetGrainsize(arguments.grainsize);
+    } else {
+      G4cout << "Warning: The grain size is only used by the tasking run manager." << G4endl;
+    }
+  }
+#else
+  if (arguments.runmanager == "tasking") {
+    G4cerr << "Error: The tasking run manager requires Geant4 10.7 or later." << G4endl;
+    return 1;
+  }
 #ifdef G4MULTITHREADED
-  G4MTRunManager *runManager = new G4MTRunManager;
-  runManager->SetNumberOfThreads(arguments.nthreads);
+  G4RunManager *runManager;
+  if (arguments.runmanager == "serial") {
+    runManager = new G4RunManager;
+  } else {
+    G4MTRunManager *mtRunManager = new G4MTRunManager;
+    mtRunManager->SetNumberOfThreads(arguments.nthreads);
+    runManager = mtRunManager;
+  }
 #else
   G4RunManager *runManager = new G4RunManager;
 #endif
+#endif
+
+  if (WorkerInitialization::Get_Pinning() != WorkerInitialization::none) {
+    if (dynamic_cast<G4MTRunManager *>(runManager)) {
+      runManager->SetUserInitialization(new WorkerInitialization);
+    } else {
+      G4cout << "Warning: Only the worker threads of the mt and tasking run managers are pinned." << G4endl;
+    }
+  }
 
   G4cout << "Initializing DetectorConstruction..." << G4endl;
-  runManager->SetUserInitialization(new DetectorConstruction);
+  G4VUserDetectorConstruction *detectorConstruction = GeometryPlugin::Create_Detector_Construction();
+  if (!detectorConstruction) {
+    delete runManager;
+    return 1;
+  }
+  detectorConstruction = new SharedVolumesDetectorConstruction(detectorConstruction);
+  if (arguments.geometrycache != "") {
+    detectorConstruction = new CachedDetectorConstruction(detectorConstruction, arguments.geometrycache);
+  }
+#if defined(FORCED_COLLISION) || defined(DIRECTIONAL_SPLITTING)
+  detectorConstruction = new BiasingDetectorConstruction(detectorConstruction);
+#endif
+#ifdef FAST_DETECTOR_RESPONSE
+  detectorConstruction = new FastSimulationDetectorConstruction(detectorConstruction);
+#endif
+  runManager->SetUserInitialization(detectorConstruction);
 
   G4cout << "Initializing PhysicsList..." << G4endl;
-  Physics *physicsList = new Physics();
+  Physics::Selection physicsSelection = Physics::Default_Selection();
+  if (arguments.em != "") {
+    physicsSelection.em = arguments.em;
+  }
+  if (arguments.elastic != "") {
+    physicsSelection.elastic = arguments.elastic;
+  }
+  if (arguments.inelastic != "") {
+    physicsSelection.inelastic = arguments.inelastic;
+  }
+  Physics *physicsList = new Physics(physicsSelection, arguments.macrofile ? arguments.macrofile : "");
   runManager->SetUserInitialization(physicsList);
 
   G4cout << "ActionInitialization..." << G4endl;
-  ActionInitialization *actionInitialization = new ActionInitialization();
-  actionInitialization->setNThreads(arguments.nthreads);
-  runManager->SetUserInitialization(actionInitialization);
-
-#ifdef EVENT_EVENTWISE
-  G4cout << "Initializing EnergyDepositionSD::anyDetectorHitInEvent vector..." << G4endl;
-  EnergyDepositionSD::anyDetectorHitInEvent = std::vector<bool>(arguments.nthreads, false);
-#endif
+  runManager->SetUserInitialization(new ActionInitialization());
 
   if (!arguments.macrofile) {
     G4cout << "Initializing VisManager" << G4endl;
@@ -161,8 +301,6 @@ int main(int argc, char *argv[]) {
   if (G4VisManager::GetConcreteInstance())
     delete G4VisManager::GetConcreteInstance();
 
-  utrFilenameTools::deleteMasterFilename();
-
   delete runManager;
   return 0;
 }
@@ -23,9 +23,15 @@ along with utr.  If not, see <http://www.gnu.org/licenses/>.
 #include "G4FileUtilities.hh"
 #include "globals.hh"
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
 #include <dirent.h>
+#include <fcntl.h>
 #include <sstream>
 #include <sys/stat.h>
+#include <unistd.h>
 
 using std::string;
 using std::stringstream;
@@ -39,34 +45,95 @@ string utrFilenameTools::outputDir = ".";
 string utrFilenameTools::filenamePrefix = "utr";
 unsigned int utrFilenameTools::filenameID = 0;
 bool utrFilenameTools::useFilenameID = true;
-string utrFilenameTools::masterFilename = "";
+string utrFilenameTools::reservationFilename = "";
 
-unsigned int utrFilenameTools::findNextFreeFilenameID() {
-  // Determine the next free filename (with ID) by searching for files with the name
-  // '{utrFilenameTools::filenamePrefix}N.root' or '{utrFilenameTools::filenamePrefix}N_t0.root' in the requested directory
-  G4FileUtilities fileutil;
-  stringstream filename_single;
-  stringstream filename_multi;
-  unsigned int fid = 0;
-  for (fid = 0; fid < INT_MAX; ++fid) {
-    filename_single << outputDir << "/" << filenamePrefix << fid << ".root";
-    filename_multi << outputDir << "/" << filenamePrefix << fid << "_t0.root";
-
-    if (fileutil.FileExists(filename_single.str()) || fileutil.FileExists(filename_multi.str())) {
-      filename_single.str("");
-      filename_multi.str("");
+unsigned int utrFilenameTools::scanNextFreeFilenameID() {
+  // Read the directory once and parse all names '{filenamePrefix}N.root', '{filenamePrefix}N_tK.root' and '{filenamePrefix}N.reserved'
+  // The next free ID is the one after the highest existing ID, so that IDs which are incremented for later runs do not collide with existing files either
+  unsigned int next_fid = 0;
+  DIR *dir = opendir(outputDir.c_str());
+  if (!dir) {
+    return next_fid;
+  }
+  for (struct dirent *entry = readdir(dir); entry; entry = readdir(dir)) {
+    const char *name = entry->d_name;
+    if (std::strncmp(name, filenamePrefix.c_str(), filenamePrefix.size()) != 0) {
       continue;
     }
-    break;
+    const char *id_begin = name + filenamePrefix.size();
+    const char *id_end = id_begin;
+    while (*id_end >= '0' && *id_end <= '9') {
+      ++id_end;
+    }
+    if (id_end == id_begin) {
+      continue;
+    }
+    const char *thread_end = id_end;
+    if (std::strncmp(id_end, "_t", 2) == 0) {
+      thread_end = id_end + 2;
+      while (*thread_end >= '0' && *thread_end <= '9') {
+        ++thread_end;
+      }
+    }
+    if (std::strcmp(thread_end, ".root") == 0 || (thread_end == id_end && std::strcmp(id_end, ".reserved") == 0)) {
+      next_fid = std::max(next_fid, (unsigned int)std::strtoul(id_begin, nullptr, 10) + 1);
+    }
   }
+  closedir(dir);
+  return next_fid;
+}
+
+unsigned int utrFilenameTools::findNextFreeFilenameID() {
+  const unsigned int fid = scanNextFreeFilenameID();
   G4cout << "Using file name prefix '" << filenamePrefix << fid << "' ..." << G4endl;
   filenameID = fid - 1;
   return fid;
 }
 
+void utrFilenameTools::reserveNextFilenameID() {
+  // Several utr processes may write to the same output directory. Each process reserves the ID of a run by creating the
+  // file '{filenamePrefix}N.reserved' with O_EXCL, which fails if another process already created it.
+  // The reservation is kept until the output files of the run were closed, then the output files themselves mark the ID as used.
+  G4FileUtilities fileutil;
+  unsigned int fid = filenameID + 1;
+  while (true) {
+    stringstream filename;
+    filename << outputDir << "/" << filenamePrefix << fid;
+    const string reservation = filename.str() + ".reserved";
+    const int fd = open(reservation.c_str(), O_CREAT | O_EXCL | O_WRONLY, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (fd >= 0) {
+      close(fd);
+      // The ID may have been used by a run of another process which already finished
+      if (!fileutil.FileExists(filename.str() + ".root") && !fileutil.FileExists(filename.str() + "_t0.root")) {
+        reservationFilename = reservation;
+        break;
+      }
+      std::remove(reservation.c_str());
+    } else if (errno != EEXIST) {
+      G4cerr << "ERROR: Could not create the reservation file '" << reservation << "': " << std::strerror(errno) << ". Aborting..." << G4endl;
+      throw std::exception();
+    }
+    fid = std::max(fid + 1, scanNextFreeFilenameID());
+  }
+  if (fid != filenameID + 1) {
+    G4cout << "File name ID " << filenameID + 1 << " is used by another process, using file name prefix '" << filenamePrefix << fid << "' ..." << G4endl;
+  }
+  filenameID = fid;
+}
+
+void utrFilenameTools::releaseFilenameID() {
+  if (reservationFilename != "") {
+    std::remove(reservationFilename.c_str());
+    reservationFilename = "";
+  }
+}
+
 bool utrFilenameTools::setOutputDir(string odir) {
   // If output directory does not exists try to create it
-  if (!opendir(odir.c_str())) {
+  DIR *dir = opendir(odir.c_str());
+  if (dir) {
+    closedir(dir);
+  } else {
     const int dir_err = mkdir(odir.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
     if (dir_err == -1) {
       G4cout << "Error creating output directory '" << odir << "'" << G4endl;
@@ -81,27 +148,20 @@ bool utrFilenameTools::setOutputDir(string odir) {
   return false;
 }
 
-string utrFilenameTools::getMasterFilename() {
-  if (masterFilename == "") {
-    char tmpfilename[L_tmpnam]; // Char array of L_tmpnam size as requested by tmpnam
-    if (NULL == std::tmpnam(tmpfilename)) { // Let tmpnam create a not yet used filename and store it in the tmpfilename char array
-      G4cerr << "ERROR: Could not obtain a free temporary filename for the master thread's output! tmpnam failed! Aborting..." << G4endl;
-      throw std::exception();
-    }
-    stringstream rootFilename;
-    rootFilename << tmpfilename << ".root"; // Geant4 forces a .root extension to the filename
-    G4FileUtilities fileutil;
-    if (fileutil.FileExists(rootFilename.str())) { // Hence manually check if the tmpnam filename with a .root extension is also non-existing, if not abort
-      G4cerr << "ERROR: Could not obtain a free temporary filename for the master thread's output! Tried: '" << rootFilename.str() << "' but it is already exists! Aborting..." << G4endl;
-      throw std::exception();
-    }
-    masterFilename = rootFilename.str(); // Remember this free filename
+string utrFilenameTools::createMasterFile() {
+  // Create the file with O_EXCL, so that it can not be taken by another process between the check and the creation
+  // ROOT afterwards recreates the empty file
+  stringstream filename;
+  filename << outputDir << "/" << filenamePrefix;
+  if (useFilenameID) {
+    filename << filenameID;
   }
-  return masterFilename;
-}
-
-void utrFilenameTools::deleteMasterFilename() {
-  if (masterFilename != "") {
-    std::remove(masterFilename.c_str());
+  filename << ".root";
+  const int fd = open(filename.str().c_str(), O_CREAT | O_EXCL | O_WRONLY, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+  if (fd < 0) {
+    G4cerr << "ERROR: Could not create the designated outputfile '" << filename.str() << "' of the master thread: " << std::strerror(errno) << ". Aborting..." << G4endl;
+    throw std::exception();
   }
+  close(fd);
+  return filename.str();
 }
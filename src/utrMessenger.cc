@@ -18,11 +18,27 @@ You should have received a copy of the GNU General Public License
 along with utr.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <cmath>
+
 #include "utrMessenger.hh"
+#include "CachedDetectorConstruction.hh"
+#include "ProgressMonitor.hh"
+#include "RegionManager.hh"
+#include "ResponseMatrix.hh"
+#include "RunChain.hh"
+#include "BiasingDetectorConstruction.hh"
+#include "DetectorResponse.hh"
+#include "EnergySweep.hh"
+#include "ImportanceSampling.hh"
+#include "TrackKiller.hh"
+#include "G4SystemOfUnits.hh"
 #include "G4UIcmdWithAnInteger.hh"
 #include "G4UImanager.hh"
+#include "G4UIparameter.hh"
 #include "utrFilenameTools.hh"
 
+#include "utrConfig.h"
+
 utrMessenger::utrMessenger() {
   utrDirectory = new G4UIdirectory("/utr/");
   utrDirectory->SetGuidance("Controls for general utr settings.");
@@ -40,11 +56,262 @@ utrMessenger::utrMessenger() {
   appendZerosToVarCmd = new G4UIcmdWithAString("/utr/appendZerosToVar", this);
   appendZerosToVarCmd->SetGuidance("Set an UI/macro alias (a variable) to the given numerical value appending a decimal dot and the requested number of zeros if necessary");
   appendZerosToVarCmd->SetParameterName("variableName> <variableValue> <numberOfDecimalDigits", false);
+
+  beamOn64Cmd = new G4UIcmdWithAString("/utr/beamOn64", this);
+  beamOn64Cmd->SetGuidance("Simulate N events, also more than the 2^31 - 1 events of /run/beamOn, in a chain of runs which write to the same output files (unless /utr/checkpoint/events is set). N may be given in scientific notation, e.g. 1e11.");
+  beamOn64Cmd->SetParameterName("N", false);
+  beamOn64Cmd->AvailableForStates(G4State_Idle);
+
+  checkpointDirectory = new G4UIdirectory("/utr/checkpoint/");
+  checkpointDirectory->SetGuidance("Checkpoints of /utr/beamOn64 chains, which can be resumed with the --resume option of utr.");
+
+  setCheckpointEventsCmd = new G4UIcmdWithAnInteger("/utr/checkpoint/events", this);
+  setCheckpointEventsCmd->SetGuidance("Close the output files and write the manifest every N events of /utr/beamOn64. Each checkpoint gets its own output files. N = 0 switches the checkpoints off (default).");
+  setCheckpointEventsCmd->SetParameterName("N", false);
+  setCheckpointEventsCmd->SetRange("N >= 0");
+  setCheckpointEventsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  setCheckpointManifestCmd = new G4UIcmdWithAString("/utr/checkpoint/manifest", this);
+  setCheckpointManifestCmd->SetGuidance("File name of the checkpoint manifest (default: OUTPUTDIR/PREFIX.checkpoint)");
+  setCheckpointManifestCmd->SetParameterName("filename", false);
+  setCheckpointManifestCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  sweepDirectory = new G4UIdirectory("/utr/sweep/");
+  sweepDirectory->SetGuidance("Simulate the same number of events for each of a list of primary energies in a single run.");
+
+  setSweepEnergiesCmd = new G4UIcmdWithAString("/utr/sweep/energies", this);
+  setSweepEnergiesCmd->SetGuidance("Energies of the sweep, followed by their unit, e.g. '1.5 2 2.5 MeV'");
+  setSweepEnergiesCmd->SetParameterName("energies", false);
+  setSweepEnergiesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  setSweepRangeCmd = new G4UIcommand("/utr/sweep/energyRange", this);
+  setSweepRangeCmd->SetGuidance("Energies min, min + step, ..., max of the sweep");
+  setSweepRangeCmd->SetParameter(new G4UIparameter("min", 'd', false));
+  setSweepRangeCmd->SetParameter(new G4UIparameter("max", 'd', false));
+  setSweepRangeCmd->SetParameter(new G4UIparameter("step", 'd', false));
+  G4UIparameter *sweepUnitParameter = new G4UIparameter("unit", 's', true);
+  sweepUnitParameter->SetDefaultValue("MeV");
+  setSweepRangeCmd->SetParameter(sweepUnitParameter);
+  setSweepRangeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  sweepBeamOnCmd = new G4UIcmdWithAString("/utr/sweep/beamOn", this);
+  sweepBeamOnCmd->SetGuidance("Simulate N events for each energy of the sweep in a single run (or in a chain of runs like /utr/beamOn64, if there are more than 2^31 - 1 events in total). The primary energy of each event is written to the ntuple column 'ebeam'. N may be given in scientific notation, e.g. 1e7.");
+  sweepBeamOnCmd->SetParameterName("N", false);
+  sweepBeamOnCmd->AvailableForStates(G4State_Idle);
+
+  progressDirectory = new G4UIdirectory("/utr/progress/");
+  progressDirectory->SetGuidance("Reports of the progress of the simulation.");
+
+  setProgressIntervalCmd = new G4UIcmdWithADoubleAndUnit("/utr/progress/interval", this);
+  setProgressIntervalCmd->SetGuidance("Print the number of events, the event rate, the estimated remaining time and the imbalance between the threads at this wall-clock interval (default: PROGRESS_INTERVAL build option). An interval of 0 switches the reports off.");
+  setProgressIntervalCmd->SetParameterName("interval", false);
+  setProgressIntervalCmd->SetUnitCategory("Time");
+  setProgressIntervalCmd->SetDefaultUnit("s");
+  setProgressIntervalCmd->SetRange("interval >= 0.");
+  setProgressIntervalCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  geometryDirectory = new G4UIdirectory("/utr/geometry/");
+  geometryDirectory->SetGuidance("Controls for the geometry.");
+
+  exportGeometryCmd = new G4UIcmdWithAString("/utr/geometry/export", this);
+  exportGeometryCmd->SetGuidance("Write the constructed geometry to a GDML file (requires the WITH_GDML build option)");
+  exportGeometryCmd->SetParameterName("filename", false);
+  exportGeometryCmd->AvailableForStates(G4State_Idle);
+
+  regionsDirectory = new G4UIdirectory("/utr/regions/");
+  regionsDirectory->SetGuidance("Production cuts for the logical volumes, depending on their role (sensitive, target, shielding, structural).");
+
+  enableRegionsCmd = new G4UIcmdWithABool("/utr/regions/enable", this);
+  enableRegionsCmd->SetGuidance("Use region-specific production cuts (default: false). If false, the default cuts are used everywhere.");
+  enableRegionsCmd->SetParameterName("enable", true);
+  enableRegionsCmd->SetDefaultValue(true);
+  enableRegionsCmd->AvailableForStates(G4State_PreInit);
+
+  setRegionCutCmd = new G4UIcommand("/utr/regions/setCut", this);
+  setRegionCutCmd->SetGuidance("Set the production cut for all volumes with the given role. The role 'structural' refers to Geant4's default region, whose cut is not changed otherwise.");
+  G4UIparameter *roleParameter = new G4UIparameter("role", 's', false);
+  roleParameter->SetParameterCandidates("sensitive target shielding structural");
+  setRegionCutCmd->SetParameter(roleParameter);
+  G4UIparameter *cutParameter = new G4UIparameter("cut", 'd', false);
+  cutParameter->SetParameterRange("cut > 0.");
+  setRegionCutCmd->SetParameter(cutParameter);
+  G4UIparameter *unitParameter = new G4UIparameter("unit", 's', true);
+  unitParameter->SetDefaultValue("mm");
+  setRegionCutCmd->SetParameter(unitParameter);
+  setRegionCutCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  addRegionVolumeCmd = new G4UIcommand("/utr/regions/addVolume", this);
+  addRegionVolumeCmd->SetGuidance("Assign all logical volumes whose names contain the given pattern (case-insensitive) to a role. Must be used before /run/initialize.");
+  G4UIparameter *volumeRoleParameter = new G4UIparameter("role", 's', false);
+  volumeRoleParameter->SetParameterCandidates("sensitive target shielding structural");
+  addRegionVolumeCmd->SetParameter(volumeRoleParameter);
+  addRegionVolumeCmd->SetParameter(new G4UIparameter("pattern", 's', false));
+  addRegionVolumeCmd->AvailableForStates(G4State_PreInit);
+
+  printRegionsCmd = new G4UIcmdWithoutParameter("/utr/regions/print", this);
+  printRegionsCmd->SetGuidance("Print the production cuts and the number of logical volumes for each role.");
+
+  killDirectory = new G4UIdirectory("/utr/kill/");
+  killDirectory->SetGuidance("Policies to kill tracks which are unlikely to contribute to the detector signals.");
+
+  setKillThresholdCmd = new G4UIcommand("/utr/kill/setThreshold", this);
+  setKillThresholdCmd->SetGuidance("Kill charged secondaries which are created in volumes with the given role (see /utr/regions/) with a kinetic energy below the threshold. A threshold of 0 switches this off (default).");
+  G4UIparameter *killRoleParameter = new G4UIparameter("role", 's', false);
+  killRoleParameter->SetParameterCandidates("sensitive target shielding structural");
+  setKillThresholdCmd->SetParameter(killRoleParameter);
+  G4UIparameter *thresholdParameter = new G4UIparameter("threshold", 'd', false);
+  thresholdParameter->SetParameterRange("threshold >= 0.");
+  setKillThresholdCmd->SetParameter(thresholdParameter);
+  G4UIparameter *energyUnitParameter = new G4UIparameter("unit", 's', true);
+  energyUnitParameter->SetDefaultValue("keV");
+  setKillThresholdCmd->SetParameter(energyUnitParameter);
+  setKillThresholdCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  setROIBoxCmd = new G4UIcmdWith3VectorAndUnit("/utr/kill/roiBox", this);
+  setROIBoxCmd->SetGuidance("Kill all particles which leave a box with the given half lengths around the center of the region of interest.");
+  setROIBoxCmd->SetParameterName("half_x", "half_y", "half_z", false);
+  setROIBoxCmd->SetDefaultUnit("mm");
+  setROIBoxCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  setROISphereCmd = new G4UIcmdWithADoubleAndUnit("/utr/kill/roiSphere", this);
+  setROISphereCmd->SetGuidance("Kill all particles which leave a sphere with the given radius around the center of the region of interest.");
+  setROISphereCmd->SetParameterName("radius", false);
+  setROISphereCmd->SetDefaultUnit("mm");
+  setROISphereCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  setROICenterCmd = new G4UIcmdWith3VectorAndUnit("/utr/kill/roiCenter", this);
+  setROICenterCmd->SetGuidance("Set the center of the region of interest (default: 0 0 0 mm).");
+  setROICenterCmd->SetParameterName("x", "y", "z", false);
+  setROICenterCmd->SetDefaultUnit("mm");
+  setROICenterCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  removeROICmd = new G4UIcmdWithoutParameter("/utr/kill/removeROI", this);
+  removeROICmd->SetGuidance("Do not kill particles outside of a region of interest (default).");
+  removeROICmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  biasingDirectory = new G4UIdirectory("/utr/biasing/");
+  biasingDirectory->SetGuidance("Geometric importance sampling (requires IMPORTANCE_BIASING).");
+
+  setImportanceCmd = new G4UIcommand("/utr/biasing/setImportance", this);
+  setImportanceCmd->SetGuidance("Set the importance of all physical volumes whose names contain the given pattern (case-insensitive). The default importance is 1, an importance of 0 kills all particles which enter the volume.");
+  setImportanceCmd->SetParameter(new G4UIparameter("pattern", 's', false));
+  G4UIparameter *importanceParameter = new G4UIparameter("importance", 'd', false);
+  importanceParameter->SetParameterRange("importance >= 0.");
+  setImportanceCmd->SetParameter(importanceParameter);
+  setImportanceCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  forceCollisionCmd = new G4UIcmdWithAString("/utr/biasing/forceCollision", this);
+  forceCollisionCmd->SetGuidance("Force collisions in the physical volume with the given name, typically a thin target (requires FORCED_COLLISION). Applies to all placements of its logical volume. Can be used several times, must be used before /run/initialize.");
+  forceCollisionCmd->SetParameterName("physicalVolumeName", false);
+  forceCollisionCmd->AvailableForStates(G4State_PreInit);
+
+  splitInVolumeCmd = new G4UIcmdWithAString("/utr/biasing/splitInVolume", this);
+  splitInVolumeCmd->SetGuidance("Split photons which are scattered in the physical volume with the given name, typically a target, towards the sensitive detectors (requires DIRECTIONAL_SPLITTING). Applies to all placements of its logical volume. Can be used several times, must be used before /run/initialize.");
+  splitInVolumeCmd->SetParameterName("physicalVolumeName", false);
+  splitInVolumeCmd->AvailableForStates(G4State_PreInit);
+
+  setSplittingFactorCmd = new G4UIcmdWithAnInteger("/utr/biasing/splittingFactor", this);
+  setSplittingFactorCmd->SetGuidance("Number of samples of each photon scattering in the splitting volumes (default: 10). Must be used before /run/initialize.");
+  setSplittingFactorCmd->SetParameterName("splittingFactor", false);
+  setSplittingFactorCmd->SetRange("splittingFactor >= 1");
+  setSplittingFactorCmd->AvailableForStates(G4State_PreInit);
+
+  fastsimDirectory = new G4UIdirectory("/utr/fastsim/");
+  fastsimDirectory->SetGuidance("Tabulated response of the sensitive volumes to photons (requires FAST_DETECTOR_RESPONSE).");
+
+  calibrateResponseCmd = new G4UIcmdWithAString("/utr/fastsim/calibrate", this);
+  calibrateResponseCmd->SetGuidance("Calibration mode: Record the energy depositions of primary photons which enter the sensitive volumes, and write the response tables to the given file at the end of each run. The photons should be emitted towards the detectors, one per event.");
+  calibrateResponseCmd->SetParameterName("filename", false);
+  calibrateResponseCmd->AvailableForStates(G4State_PreInit);
+
+  setResponseBinWidthCmd = new G4UIcmdWithADoubleAndUnit("/utr/fastsim/energyBinWidth", this);
+  setResponseBinWidthCmd->SetGuidance("Width of the bins of the incident energy in the calibration mode (default: 10 keV).");
+  setResponseBinWidthCmd->SetParameterName("width", false);
+  setResponseBinWidthCmd->SetUnitCategory("Energy");
+  setResponseBinWidthCmd->SetRange("width > 0.");
+  setResponseBinWidthCmd->AvailableForStates(G4State_PreInit);
+
+  readResponseCmd = new G4UIcmdWithAString("/utr/fastsim/readResponse", this);
+  readResponseCmd->SetGuidance("Read response tables from a file which was written in the calibration mode. Photons which enter a sensitive volume with a response are not tracked any more, but deposit an energy which is sampled from the table.");
+  readResponseCmd->SetParameterName("filename", false);
+  readResponseCmd->AvailableForStates(G4State_PreInit);
+
+  useResponseCmd = new G4UIcommand("/utr/fastsim/useResponse", this);
+  useResponseCmd->SetGuidance("Use the response of the logical volume calibratedVolume for the logical volume volume, e.g. for several detectors of the same model.");
+  useResponseCmd->SetParameter(new G4UIparameter("volume", 's', false));
+  useResponseCmd->SetParameter(new G4UIparameter("calibratedVolume", 's', false));
+  useResponseCmd->AvailableForStates(G4State_PreInit);
+
+  responseMatrixDirectory = new G4UIdirectory("/utr/responseMatrix/");
+  responseMatrixDirectory->SetGuidance("Response-matrix run mode (requires RESPONSE_MATRIX).");
+
+  setResponseMatrixRangeCmd = new G4UIcommand("/utr/responseMatrix/energyRange", this);
+  setResponseMatrixRangeCmd->SetGuidance("Sample the energy of the primary particles of each event uniformly between min and max, replacing the energy distribution of the primary generator. Must be set before /run/beamOn.");
+  G4UIparameter *minEnergyParameter = new G4UIparameter("min", 'd', false);
+  minEnergyParameter->SetParameterRange("min >= 0.");
+  setResponseMatrixRangeCmd->SetParameter(minEnergyParameter);
+  setResponseMatrixRangeCmd->SetParameter(new G4UIparameter("max", 'd', false));
+  G4UIparameter *rangeUnitParameter = new G4UIparameter("unit", 's', true);
+  rangeUnitParameter->SetDefaultValue("MeV");
+  setResponseMatrixRangeCmd->SetParameter(rangeUnitParameter);
+  setResponseMatrixRangeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  setResponseMatrixStepCmd = new G4UIcmdWithADoubleAndUnit("/utr/responseMatrix/energyStep", this);
+  setResponseMatrixStepCmd->SetGuidance("Sample the energies from a grid min, min + step, ..., max instead of continuously. A step of 0 switches back to continuous sampling (default).");
+  setResponseMatrixStepCmd->SetParameterName("step", false);
+  setResponseMatrixStepCmd->SetUnitCategory("Energy");
+  setResponseMatrixStepCmd->SetRange("step >= 0.");
+  setResponseMatrixStepCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  setResponseMatrixBinWidthCmd = new G4UIcmdWithADoubleAndUnit("/utr/responseMatrix/binWidth", this);
+  setResponseMatrixBinWidthCmd->SetGuidance("Width of the bins of the energy deposition, and of the true energy if it is sampled continuously (default: 10 keV).");
+  setResponseMatrixBinWidthCmd->SetParameterName("width", false);
+  setResponseMatrixBinWidthCmd->SetUnitCategory("Energy");
+  setResponseMatrixBinWidthCmd->SetRange("width > 0.");
+  setResponseMatrixBinWidthCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
 }
 
 utrMessenger::~utrMessenger() {
   delete setFilenameCmd;
   delete setUseFilenameIDCmd;
+  delete appendZerosToVarCmd;
+  delete beamOn64Cmd;
+  delete setCheckpointEventsCmd;
+  delete setCheckpointManifestCmd;
+  delete checkpointDirectory;
+  delete setSweepEnergiesCmd;
+  delete setSweepRangeCmd;
+  delete sweepBeamOnCmd;
+  delete sweepDirectory;
+  delete setProgressIntervalCmd;
+  delete progressDirectory;
+  delete exportGeometryCmd;
+  delete geometryDirectory;
+  delete enableRegionsCmd;
+  delete setRegionCutCmd;
+  delete addRegionVolumeCmd;
+  delete printRegionsCmd;
+  delete regionsDirectory;
+  delete setKillThresholdCmd;
+  delete setROIBoxCmd;
+  delete setROISphereCmd;
+  delete setROICenterCmd;
+  delete removeROICmd;
+  delete killDirectory;
+  delete setImportanceCmd;
+  delete forceCollisionCmd;
+  delete splitInVolumeCmd;
+  delete setSplittingFactorCmd;
+  delete calibrateResponseCmd;
+  delete setResponseBinWidthCmd;
+  delete readResponseCmd;
+  delete useResponseCmd;
+  delete fastsimDirectory;
+  delete setResponseMatrixRangeCmd;
+  delete setResponseMatrixStepCmd;
+  delete setResponseMatrixBinWidthCmd;
+  delete responseMatrixDirectory;
+  delete biasingDirectory;
   delete utrDirectory;
 }
 
@@ -122,6 +389,117 @@ void utrMessenger::SetNewValue(G4UIcommand *command, G4String newValues) {
       G4UImanager *UImanager = G4UImanager::GetUIpointer();
       UImanager->ApplyCommand(aliasCommand.str());
     }
+  } else if (command == beamOn64Cmd || command == sweepBeamOnCmd) {
+    std::istringstream stream(newValues);
+    G4double n_events;
+    if (!(stream >> n_events) || n_events != std::floor(n_events)) {
+      G4cerr << "Error: Invalid number of events '" << newValues << "'" << G4endl;
+    } else if (command == beamOn64Cmd) {
+      RunChain::BeamOn((G4long)n_events);
+    } else {
+      EnergySweep::BeamOn((G4long)n_events);
+    }
+  } else if (command == setSweepEnergiesCmd) {
+    // The last word is the unit
+    std::istringstream stream(newValues);
+    std::vector<G4String> words;
+    for (G4String word; stream >> word;) {
+      words.push_back(word);
+    }
+    if (words.size() < 2) {
+      G4cerr << "Error: Expected a list of energies followed by their unit, got '" << newValues << "'" << G4endl;
+    } else {
+      const G4double unit = G4UIcommand::ValueOf(words.back());
+      std::vector<G4double> energies;
+      for (size_t i = 0; i < words.size() - 1; ++i) {
+        energies.push_back(G4UIcommand::ConvertToDouble(words[i]) * unit);
+      }
+      EnergySweep::Set_Energies(energies);
+    }
+  } else if (command == setSweepRangeCmd) {
+    G4double min, max, step;
+    G4String unit;
+    std::istringstream(newValues) >> min >> max >> step >> unit;
+    EnergySweep::Set_Energy_Range(min * G4UIcommand::ValueOf(unit), max * G4UIcommand::ValueOf(unit), step * G4UIcommand::ValueOf(unit));
+  } else if (command == setCheckpointEventsCmd) {
+    RunChain::Set_Checkpoint_Events(setCheckpointEventsCmd->GetNewIntValue(newValues));
+  } else if (command == setCheckpointManifestCmd) {
+    RunChain::Set_Manifest(newValues);
+  } else if (command == setProgressIntervalCmd) {
+    ProgressMonitor::Set_Interval(setProgressIntervalCmd->GetNewDoubleValue(newValues) / s);
+  } else if (command == exportGeometryCmd) {
+    CachedDetectorConstruction::Export(newValues);
+  } else if (command == enableRegionsCmd) {
+    RegionManager::Set_Enabled(enableRegionsCmd->GetNewBoolValue(newValues));
+  } else if (command == setRegionCutCmd) {
+    G4String role, unit;
+    G4double cut;
+    std::istringstream(newValues) >> role >> cut >> unit;
+    RegionManager::Set_Cut(role, cut * G4UIcommand::ValueOf(unit));
+  } else if (command == addRegionVolumeCmd) {
+    G4String role, pattern;
+    std::istringstream(newValues) >> role >> pattern;
+    RegionManager::Add_Volume(role, pattern);
+  } else if (command == printRegionsCmd) {
+    RegionManager::Print();
+  } else if (command == setKillThresholdCmd) {
+    G4String role_name, unit;
+    G4double threshold;
+    std::istringstream(newValues) >> role_name >> threshold >> unit;
+    RegionManager::Role role;
+    if (RegionManager::Find_Role(role_name, role)) {
+      TrackKiller::Set_Threshold(role, threshold * G4UIcommand::ValueOf(unit));
+    }
+  } else if (command == setROIBoxCmd) {
+    TrackKiller::Set_ROI_Box(setROIBoxCmd->GetNew3VectorValue(newValues));
+  } else if (command == setROISphereCmd) {
+    TrackKiller::Set_ROI_Sphere(setROISphereCmd->GetNewDoubleValue(newValues));
+  } else if (command == setROICenterCmd) {
+    TrackKiller::Set_ROI_Center(setROICenterCmd->GetNew3VectorValue(newValues));
+  } else if (command == removeROICmd) {
+    TrackKiller::Remove_ROI();
+  } else if (command == setImportanceCmd) {
+    G4String pattern;
+    G4double importance;
+    std::istringstream(newValues) >> pattern >> importance;
+    ImportanceSampling::Set_Importance(pattern, importance);
+  } else if (command == forceCollisionCmd) {
+    BiasingDetectorConstruction::Add_Forced_Collision_Volume(newValues);
+  } else if (command == splitInVolumeCmd) {
+    BiasingDetectorConstruction::Add_Splitting_Volume(newValues);
+  } else if (command == setSplittingFactorCmd) {
+    BiasingDetectorConstruction::Set_Splitting_Factor(setSplittingFactorCmd->GetNewIntValue(newValues));
+  } else if (command == calibrateResponseCmd || command == setResponseBinWidthCmd || command == readResponseCmd || command == useResponseCmd) {
+#ifdef FAST_DETECTOR_RESPONSE
+    if (command == calibrateResponseCmd) {
+      DetectorResponse::Set_Calibration_File(newValues);
+    } else if (command == setResponseBinWidthCmd) {
+      DetectorResponse::Set_Energy_Bin_Width(setResponseBinWidthCmd->GetNewDoubleValue(newValues));
+    } else if (command == readResponseCmd) {
+      DetectorResponse::Read(newValues);
+    } else {
+      G4String volume, calibrated_volume;
+      std::istringstream(newValues) >> volume >> calibrated_volume;
+      DetectorResponse::Use_Response(volume, calibrated_volume);
+    }
+#else
+    G4cerr << "Error: utr was built without the FAST_DETECTOR_RESPONSE option." << G4endl;
+#endif
+  } else if (command == setResponseMatrixRangeCmd || command == setResponseMatrixStepCmd || command == setResponseMatrixBinWidthCmd) {
+#ifdef RESPONSE_MATRIX
+    if (command == setResponseMatrixRangeCmd) {
+      G4double min, max;
+      G4String unit;
+      std::istringstream(newValues) >> min >> max >> unit;
+      ResponseMatrix::Set_Energy_Range(min * G4UIcommand::ValueOf(unit), max * G4UIcommand::ValueOf(unit));
+    } else if (command == setResponseMatrixStepCmd) {
+      ResponseMatrix::Set_Energy_Step(setResponseMatrixStepCmd->GetNewDoubleValue(newValues));
+    } else {
+      ResponseMatrix::Set_Bin_Width(setResponseMatrixBinWidthCmd->GetNewDoubleValue(newValues));
+    }
+#else
+    G4cerr << "Error: utr was built without the RESPONSE_MATRIX option." << G4endl;
+#endif
   } else {
     G4cerr << "Error! Unknown command!" << G4endl;
   }
@@ -132,6 +510,8 @@ G4String utrMessenger::GetCurrentValue(G4UIcommand *command) {
     return utrFilenameTools::getFilenamePrefix();
   } else if (command == setUseFilenameIDCmd) {
     return setUseFilenameIDCmd->ConvertToString(utrFilenameTools::getUseFilenameID());
+  } else if (command == enableRegionsCmd) {
+    return enableRegionsCmd->ConvertToString(RegionManager::Get_Enabled());
   }
   return "Error! unknown command!";
 }
@@ -0,0 +1,229 @@
+#include <argp.h>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "G4Box.hh"
+#include "G4GeometryManager.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4Navigator.hh"
+#include "G4NistManager.hh"
+#include "G4PVPlacement.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ThreeVector.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VSolid.hh"
+#include "geomdefs.hh"
+
+#include "BrickWall.hh"
+#include "First_UTR_Wall.hh"
+#include "G3_Wall.hh"
+
+using std::cout;
+using std::endl;
+using std::map;
+using std::string;
+using std::vector;
+
+static char doc[] = "Brick_Wall_Benchmark";
+static char args_doc[] = "Compare the navigation speed of brick walls with one placement per brick and with merged bricks, and check that both contain the same materials";
+
+struct arguments {
+  long nrays;
+  unsigned long seed;
+
+  arguments() : nrays(100000), seed(1){};
+};
+
+static struct argp_option options[] = {
+    {0, 'n', "NRAYS", 0, "Number of random rays (and points) per wall"},
+    {0, 's', "SEED", 0, "Seed of the random number generator"},
+    {0, 0, 0, 0, 0}};
+
+static error_t parse_opt(int key, char *arg, struct argp_state *state) {
+
+  struct arguments *args = (struct arguments *)state->input;
+
+  switch (key) {
+    case ARGP_KEY_ARG:
+      break;
+    case 'n':
+      args->nrays = atol(arg);
+      break;
+    case 's':
+      args->seed = strtoul(arg, nullptr, 10);
+      break;
+    case ARGP_KEY_END:
+      break;
+    default:
+      return ARGP_ERR_UNKNOWN;
+  }
+  return 0;
+}
+
+static struct argp argp = {options, parse_opt, args_doc, doc, 0, 0, 0};
+
+struct Ray {
+  G4ThreeVector position;
+  G4ThreeVector direction;
+};
+
+struct Result {
+  size_t daughters;
+  double steps_per_ray;
+  double rays_per_second;
+  map<string, double> path_lengths;
+  vector<const G4Material *> materials;
+};
+
+const G4double world_half_length = 2. * m;
+
+G4VPhysicalVolume *Construct_World(const string &wall, bool merge) {
+  G4Material *air = G4NistManager::Instance()->FindOrBuildMaterial("G4_AIR");
+  G4Box *world_solid = new G4Box("World_Solid", world_half_length, world_half_length, world_half_length);
+  G4LogicalVolume *world_logical = new G4LogicalVolume(world_solid, air, "World_Logical");
+  G4VPhysicalVolume *world_physical = new G4PVPlacement(0, G4ThreeVector(), world_logical, "World", 0, false, 0);
+
+  BrickWall::Set_Merge(merge);
+  if (wall == "First_UTR_Wall") {
+    First_UTR_Wall(world_logical).Construct(G4ThreeVector());
+  } else {
+    G3_Wall(world_logical).Construct(G4ThreeVector());
+  }
+  return world_physical;
+}
+
+// Axis-aligned bounding box of all daughters of the world, which contains the wall
+void Bounding_Box(const G4LogicalVolume *world_logical, G4ThreeVector &box_min, G4ThreeVector &box_max) {
+  box_min = G4ThreeVector(world_half_length, world_half_length, world_half_length);
+  box_max = -box_min;
+  for (size_t i = 0; i < world_logical->GetNoDaughters(); ++i) {
+    const G4VPhysicalVolume *daughter = world_logical->GetDaughter(i);
+    G4ThreeVector solid_min, solid_max;
+    daughter->GetLogicalVolume()->GetSolid()->BoundingLimits(solid_min, solid_max);
+    for (int corner = 0; corner < 8; ++corner) {
+      G4ThreeVector point(corner & 1 ? solid_max.x() : solid_min.x(), corner & 2 ? solid_max.y() : solid_min.y(), corner & 4 ? solid_max.z() : solid_min.z());
+      point = daughter->GetObjectRotationValue() * point + daughter->GetObjectTranslation();
+      box_min = G4ThreeVector(std::min(box_min.x(), point.x()), std::min(box_min.y(), point.y()), std::min(box_min.z(), point.z()));
+      box_max = G4ThreeVector(std::max(box_max.x(), point.x()), std::max(box_max.y(), point.y()), std::max(box_max.z(), point.z()));
+    }
+  }
+}
+
+// Track a straight ray through the world like the transportation does, and add the path length in each material
+long Track(G4Navigator &navigator, const Ray &ray, map<string, double> &path_lengths) {
+  G4ThreeVector position = ray.position;
+  G4VPhysicalVolume *volume = navigator.LocateGlobalPointAndSetup(position, &ray.direction, false, false);
+  G4double safety;
+  long steps = 0;
+
+  // Limit the number of steps in case a ray gets stuck on a surface
+  while (volume && steps < 10000) {
+    G4double step = navigator.ComputeStep(position, ray.direction, kInfinity, safety);
+    ++steps;
+    if (step == kInfinity) {
+      break;
+    }
+    path_lengths[volume->GetLogicalVolume()->GetMaterial()->GetName()] += step;
+    position += step * ray.direction;
+    navigator.SetGeometricallyLimitedStep();
+    volume = navigator.LocateGlobalPointAndSetup(position, &ray.direction, true);
+  }
+  return steps;
+}
+
+Result Benchmark(G4VPhysicalVolume *world, const vector<Ray> &rays, const vector<G4ThreeVector> &points) {
+  G4GeometryManager::GetInstance()->CloseGeometry(true, false, world);
+
+  G4Navigator navigator;
+  navigator.SetWorldVolume(world);
+
+  Result result;
+  result.daughters = world->GetLogicalVolume()->GetNoDaughters();
+  long steps = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (auto &ray : rays) {
+    steps += Track(navigator, ray, result.path_lengths);
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  result.steps_per_ray = (double)steps / rays.size();
+  result.rays_per_second = rays.size() / elapsed.count();
+  for (auto &path_length : result.path_lengths) {
+    path_length.second /= rays.size();
+  }
+
+  result.materials.reserve(points.size());
+  for (auto &point : points) {
+    result.materials.push_back(navigator.LocateGlobalPointAndSetup(point, nullptr, false, false)->GetLogicalVolume()->GetMaterial());
+  }
+
+  // Only one geometry can be closed at a time
+  G4GeometryManager::GetInstance()->OpenGeometry(world);
+
+  return result;
+}
+
+int main(int argc, char *argv[]) {
+  struct arguments args;
+  argp_parse(&argp, argc, argv, 0, 0, &args);
+
+  std::mt19937_64 engine(args.seed);
+  std::uniform_real_distribution<double> uniform(0., 1.);
+
+  bool all_agree = true;
+
+  for (const string wall : {"First_UTR_Wall", "G3_Wall"}) {
+    G4VPhysicalVolume *placements_world = Construct_World(wall, false);
+    G4VPhysicalVolume *merged_world = Construct_World(wall, true);
+
+    // Rays start at random points in the bounding box of the wall and have random directions. Points for the
+    // comparison of the materials are sampled in the same box.
+    G4ThreeVector box_min, box_max;
+    Bounding_Box(placements_world->GetLogicalVolume(), box_min, box_max);
+    vector<Ray> rays(args.nrays);
+    vector<G4ThreeVector> points(args.nrays);
+    for (long j = 0; j < args.nrays; ++j) {
+      rays[j].position = G4ThreeVector(box_min.x() + uniform(engine) * (box_max.x() - box_min.x()), box_min.y() + uniform(engine) * (box_max.y() - box_min.y()), box_min.z() + uniform(engine) * (box_max.z() - box_min.z()));
+      G4double cos_theta = 2. * uniform(engine) - 1.;
+      G4double phi = 2. * M_PI * uniform(engine);
+      G4double sin_theta = sqrt(1. - cos_theta * cos_theta);
+      rays[j].direction = G4ThreeVector(sin_theta * cos(phi), sin_theta * sin(phi), cos_theta);
+
+      points[j] = G4ThreeVector(box_min.x() + uniform(engine) * (box_max.x() - box_min.x()), box_min.y() + uniform(engine) * (box_max.y() - box_min.y()), box_min.z() + uniform(engine) * (box_max.z() - box_min.z()));
+    }
+
+    Result placements = Benchmark(placements_world, rays, points);
+    Result merged = Benchmark(merged_world, rays, points);
+
+    long disagree = 0;
+    for (long j = 0; j < args.nrays; ++j) {
+      if (placements.materials[j] != merged.materials[j]) {
+        ++disagree;
+      }
+    }
+    if (disagree > 0) {
+      all_agree = false;
+    }
+
+    cout << wall << ": " << placements.daughters << " daughter volumes with placements, " << merged.daughters << " merged" << endl;
+    cout << std::setw(24) << std::left << "" << std::setw(16) << std::right << "Placements" << std::setw(16) << "Merged" << endl;
+    cout << std::setw(24) << std::left << "Rays/s" << std::setw(16) << std::right << std::scientific << std::setprecision(3) << placements.rays_per_second << std::setw(16) << merged.rays_per_second << endl;
+    cout << std::setw(24) << std::left << "Steps/ray" << std::setw(16) << std::right << std::fixed << std::setprecision(2) << placements.steps_per_ray << std::setw(16) << merged.steps_per_ray << endl;
+    for (auto &path_length : placements.path_lengths) {
+      cout << std::setw(24) << std::left << ("Path in " + path_length.first) << std::setw(16) << std::right << std::setprecision(4) << path_length.second << std::setw(16) << merged.path_lengths[path_length.first] << endl;
+    }
+    cout << std::setw(24) << std::left << "Disagree" << std::setw(16) << std::right << std::scientific << std::setprecision(2) << (double)disagree / args.nrays << endl
+         << endl;
+  }
+
+  cout << "Path: mean path length per ray in mm. Disagree: fraction of points at which the two geometries contain different materials." << endl;
+
+  return all_agree ? 0 : 1;
+}
@@ -0,0 +1,213 @@
+#include <argp.h>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdlib.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "G4ThreeVector.hh"
+#include "G4VSolid.hh"
+#include "geomdefs.hh"
+
+#include "HPGe_Coaxial.hh"
+#include "HPGe_Collection.hh"
+
+using std::cout;
+using std::endl;
+using std::pair;
+using std::string;
+using std::vector;
+
+static char doc[] = "HPGe_Crystal_Navigation_Benchmark";
+static char args_doc[] = "Compare the navigation speed of polycone and CSG solids of coaxial HPGe crystals";
+
+struct arguments {
+  long nrays;
+  unsigned long seed;
+
+  arguments() : nrays(100000), seed(1){};
+};
+
+static struct argp_option options[] = {
+    {0, 'n', "NRAYS", 0, "Number of random rays (and points) per solid"},
+    {0, 's', "SEED", 0, "Seed of the random number generator"},
+    {0, 0, 0, 0, 0}};
+
+static error_t parse_opt(int key, char *arg, struct argp_state *state) {
+
+  struct arguments *args = (struct arguments *)state->input;
+
+  switch (key) {
+    case ARGP_KEY_ARG:
+      break;
+    case 'n':
+      args->nrays = atol(arg);
+      break;
+    case 's':
+      args->seed = strtoul(arg, nullptr, 10);
+      break;
+    case ARGP_KEY_END:
+      break;
+    default:
+      return ARGP_ERR_UNKNOWN;
+  }
+  return 0;
+}
+
+static struct argp argp = {options, parse_opt, args_doc, doc, 0, 0, 0};
+
+struct Ray {
+  G4ThreeVector position;
+  G4ThreeVector direction;
+};
+
+struct Result {
+  double steps_per_second;
+  double inside_per_second;
+  double mean_chord_length;
+  vector<EInside> inside;
+};
+
+// Track a straight ray through the solid like the navigator does: alternate DistanceToIn() and
+// DistanceToOut() until the ray misses the solid. Returns the number of calls and adds the path
+// length inside the solid to chord_length.
+long Track(const G4VSolid *solid, const Ray &ray, double &chord_length) {
+  G4ThreeVector position = ray.position;
+  long steps = 0;
+  G4double distance;
+
+  // Limit the number of crossings in case a ray gets stuck on a surface
+  while (steps < 100) {
+    distance = solid->DistanceToIn(position, ray.direction);
+    ++steps;
+    if (distance == kInfinity) {
+      break;
+    }
+    position += distance * ray.direction;
+
+    distance = solid->DistanceToOut(position, ray.direction);
+    ++steps;
+    position += distance * ray.direction;
+    chord_length += distance;
+  }
+  return steps;
+}
+
+Result Benchmark(const G4VSolid *solid, const vector<Ray> &rays, const vector<G4ThreeVector> &points) {
+  Result result;
+  long steps = 0;
+  double chord_length = 0.;
+
+  auto start = std::chrono::steady_clock::now();
+  for (auto &ray : rays) {
+    steps += Track(solid, ray, chord_length);
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  result.steps_per_second = steps / elapsed.count();
+  result.mean_chord_length = chord_length / rays.size();
+
+  result.inside.reserve(points.size());
+  start = std::chrono::steady_clock::now();
+  for (auto &point : points) {
+    result.inside.push_back(solid->Inside(point));
+  }
+  elapsed = std::chrono::steady_clock::now() - start;
+  result.inside_per_second = points.size() / elapsed.count();
+
+  return result;
+}
+
+int main(int argc, char *argv[]) {
+  struct arguments args;
+  argp_parse(&argp, argc, argv, 0, 0, &args);
+
+  HPGe_Collection hpge_collection;
+  vector<pair<string, HPGe_Coaxial_Properties>> detectors = {
+      {"HPGe_55_TUNL_21638", hpge_collection.HPGe_55_TUNL_21638},
+      {"HPGe_55_TUNL_31524", hpge_collection.HPGe_55_TUNL_31524},
+      {"HPGe_60_TUNL_21033", hpge_collection.HPGe_60_TUNL_21033},
+      {"HPGe_60_TUNL_30986", hpge_collection.HPGe_60_TUNL_30986},
+      {"HPGe_60_TUNL_31061", hpge_collection.HPGe_60_TUNL_31061},
+      {"HPGe_60_TUNL_40663", hpge_collection.HPGe_60_TUNL_40663},
+      {"HPGe_120_TUNL_40383", hpge_collection.HPGe_120_TUNL_40383},
+      {"HPGe_80_TUD_90006", hpge_collection.HPGe_80_TUD_90006},
+      {"HPGe_100_TUD_72902", hpge_collection.HPGe_100_TUD_72902},
+      {"HPGe_100_TUD_72930", hpge_collection.HPGe_100_TUD_72930},
+      {"HPGe_100_TUD_73760", hpge_collection.HPGe_100_TUD_73760},
+      {"HPGe_100_Cologne_73954", hpge_collection.HPGe_100_Cologne_73954},
+      {"HPGe_86_Stuttgart_31120", hpge_collection.HPGe_86_Stuttgart_31120},
+      {"HPGe_ANL_31670", hpge_collection.HPGe_ANL_31670},
+      {"HPGe_ANL_41203", hpge_collection.HPGe_ANL_41203}};
+
+  std::mt19937_64 engine(args.seed);
+  std::uniform_real_distribution<double> uniform(0., 1.);
+
+  cout << std::setw(24) << std::left << "Detector"
+       << std::setw(14) << std::right << "Steps/s poly" << std::setw(14) << "Steps/s CSG" << std::setw(9) << "Speedup"
+       << std::setw(15) << "Inside/s poly" << std::setw(15) << "Inside/s CSG"
+       << std::setw(14) << "Chord poly" << std::setw(14) << "Chord CSG" << std::setw(12) << "Disagree" << endl;
+
+  for (auto &detector : detectors) {
+    const HPGe_Coaxial_Properties &properties = detector.second;
+
+    // Same as in HPGe_Coaxial::Get_Model()
+    G4double mount_cup_side_length = properties.mount_cup_length - properties.mount_cup_thickness - properties.mount_cup_base_thickness;
+    G4double cold_finger_length = properties.cold_finger_penetration_depth + mount_cup_side_length + properties.mount_cup_base_thickness - properties.detector_length;
+
+    vector<pair<G4VSolid *, G4VSolid *>> solids = {
+        {HPGe_Coaxial::Crystal_Solid(properties, detector.first + "_crystal_polycone", false), HPGe_Coaxial::Crystal_Solid(properties, detector.first + "_crystal_csg", true)},
+        {HPGe_Coaxial::Cold_Finger_Solid(properties, cold_finger_length, detector.first + "_cold_finger_polycone", false), HPGe_Coaxial::Cold_Finger_Solid(properties, cold_finger_length, detector.first + "_cold_finger_csg", true)}};
+    vector<pair<G4double, G4double>> dimensions = {
+        {properties.detector_radius, properties.detector_length},
+        {properties.cold_finger_radius, cold_finger_length}};
+
+    for (unsigned int i = 0; i < solids.size(); ++i) {
+      G4double radius = dimensions[i].first;
+      G4double length = dimensions[i].second;
+
+      // Rays start on a sphere around the solid and point to a random point in its bounding cylinder.
+      // Points for Inside() are sampled in a box slightly larger than the bounding cylinder.
+      G4ThreeVector center(0., 0., 0.5 * length);
+      G4double start_radius = 2. * sqrt(radius * radius + 0.25 * length * length);
+      vector<Ray> rays(args.nrays);
+      vector<G4ThreeVector> points(args.nrays);
+      for (long j = 0; j < args.nrays; ++j) {
+        G4double cos_theta = 2. * uniform(engine) - 1.;
+        G4double phi = 2. * M_PI * uniform(engine);
+        G4double sin_theta = sqrt(1. - cos_theta * cos_theta);
+        rays[j].position = center + start_radius * G4ThreeVector(sin_theta * cos(phi), sin_theta * sin(phi), cos_theta);
+
+        G4double r = radius * sqrt(uniform(engine));
+        phi = 2. * M_PI * uniform(engine);
+        G4ThreeVector target(r * cos(phi), r * sin(phi), length * uniform(engine));
+        rays[j].direction = (target - rays[j].position).unit();
+
+        points[j] = G4ThreeVector((2. * uniform(engine) - 1.) * 1.1 * radius, (2. * uniform(engine) - 1.) * 1.1 * radius, (1.2 * uniform(engine) - 0.1) * length);
+      }
+
+      Result polycone = Benchmark(solids[i].first, rays, points);
+      Result csg = Benchmark(solids[i].second, rays, points);
+
+      long disagree = 0;
+      for (long j = 0; j < args.nrays; ++j) {
+        if ((polycone.inside[j] == kOutside) != (csg.inside[j] == kOutside)) {
+          ++disagree;
+        }
+      }
+
+      cout << std::setw(24) << std::left << (detector.first + (i == 0 ? "" : " (cf)"))
+           << std::setw(14) << std::right << std::scientific << std::setprecision(3) << polycone.steps_per_second << std::setw(14) << csg.steps_per_second
+           << std::setw(9) << std::fixed << std::setprecision(2) << csg.steps_per_second / polycone.steps_per_second
+           << std::setw(15) << std::scientific << std::setprecision(3) << polycone.inside_per_second << std::setw(15) << csg.inside_per_second
+           << std::setw(14) << std::fixed << std::setprecision(4) << polycone.mean_chord_length << std::setw(14) << csg.mean_chord_length
+           << std::setw(12) << std::scientific << std::setprecision(2) << (double)disagree / args.nrays << endl;
+    }
+  }
+
+  cout << "Chord: mean path length inside the solid per ray in mm. Disagree: fraction of points for which only one of the solids returns kOutside. (cf): cold finger." << endl;
+
+  return 0;
+}
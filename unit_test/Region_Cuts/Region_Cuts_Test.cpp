@@ -0,0 +1,208 @@
+#include <argp.h>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdlib.h>
+#include <vector>
+
+#include <TChain.h>
+#include <TFile.h>
+#include <TH1.h>
+#include <TString.h>
+#include <TSystemDirectory.h>
+
+static char doc[] = "Region_Cuts_Test";
+static char args_doc[] = "Compare the energy-deposition spectra of a reference simulation with default production cuts and a simulation with region-specific production cuts";
+
+struct arguments {
+  const char *tree;
+  const char *reference_pattern;
+  const char *test_pattern;
+  const char *suffix;
+  const char *outputfilename;
+  double binning;
+  double emax;
+  unsigned int maxid;
+  double alpha;
+
+  arguments() : tree("utr"), reference_pattern("reference"), test_pattern("regions"), suffix(".root"), outputfilename("region_cuts_test.root"), binning(0.01), emax(3.), maxid(12), alpha(0.01){};
+};
+
+static struct argp_option options[] = {
+    {0, 't', "TREENAME", 0, "Name of tree (default: utr)"},
+    {0, 'r', "REFERENCE", 0, "File name pattern of the reference simulation (default: reference)"},
+    {0, 's', "TEST", 0, "File name pattern of the simulation with region-specific cuts (default: regions)"},
+    {0, 'q', "SUFFIX", 0, "File name pattern 2, which all files must contain (default: .root)"},
+    {0, 'o', "OUTPUTFILENAME", 0, "Output file name for the histograms (default: region_cuts_test.root)"},
+    {0, 'b', "BINNING", 0, "Size of bins in the histograms in keV (default: 10 keV)"},
+    {0, 'e', "EMAX", 0, "Maximum energy of the histograms in MeV (default: 3 MeV)"},
+    {0, 'n', "MAXID", 0, "Highest detection volume ID (default: 12)"},
+    {0, 'a', "ALPHA", 0, "Significance level of the statistical tests (default: 0.01)"},
+    {0, 0, 0, 0, 0}};
+
+static error_t parse_opt(int key, char *arg, struct argp_state *state) {
+
+  struct arguments *args = (struct arguments *)state->input;
+
+  switch (key) {
+    case ARGP_KEY_ARG:
+      break;
+    case 't':
+      args->tree = arg;
+      break;
+    case 'r':
+      args->reference_pattern = arg;
+      break;
+    case 's':
+      args->test_pattern = arg;
+      break;
+    case 'q':
+      args->suffix = arg;
+      break;
+    case 'o':
+      args->outputfilename = arg;
+      break;
+    case 'b':
+      args->binning = atof(arg) / 1000.;
+      break;
+    case 'e':
+      args->emax = atof(arg);
+      break;
+    case 'n':
+      args->maxid = (unsigned int)atoi(arg);
+      break;
+    case 'a':
+      args->alpha = atof(arg);
+      break;
+    case ARGP_KEY_END:
+      break;
+    default:
+      return ARGP_ERR_UNKNOWN;
+  }
+
+  return 0;
+}
+
+static struct argp argp = {options, parse_opt, args_doc, doc, 0, 0, 0};
+
+using namespace std;
+
+// Add all files in the current directory which contain both patterns to a TChain
+void join_files(TChain &chain, const char *pattern, const char *suffix) {
+  TSystemDirectory dir(".", ".");
+  TList *files = dir.GetListOfFiles();
+
+  cout << "> Joining all files that contain '" << pattern << "' and '" << suffix << "':" << endl;
+
+  if (files) {
+    TSystemFile *file;
+    TString fname;
+
+    TIter next(files);
+    file = (TSystemFile *)next();
+    while (file) {
+      fname = file->GetName();
+      if (!file->IsDirectory() && fname.Contains(pattern) && fname.Contains(suffix)) {
+        cout << fname << endl;
+        chain.Add(fname);
+      }
+      file = (TSystemFile *)next();
+    }
+  }
+}
+
+// Fill one energy-deposition histogram per detector
+vector<TH1D *> fill_histograms(TChain &chain, const string &name, const arguments &args) {
+  const int nbins = (int)ceil(args.emax / args.binning);
+
+  vector<TH1D *> hist(args.maxid + 1);
+  stringstream histname;
+  for (unsigned int i = 0; i <= args.maxid; ++i) {
+    histname.str("");
+    histname << name << "_det" << i;
+    hist[i] = new TH1D(histname.str().c_str(), histname.str().c_str(), nbins, 0., nbins * args.binning);
+  }
+
+  double edep, volume;
+  chain.SetBranchAddress("edep", &edep);
+  chain.SetBranchAddress("volume", &volume);
+
+  for (Long64_t i = 0; i < chain.GetEntries(); ++i) {
+    chain.GetEntry(i);
+    if (edep > 0. && volume >= 0. && (unsigned int)volume <= args.maxid) {
+      hist[(unsigned int)volume]->Fill(edep);
+    }
+  }
+
+  return hist;
+}
+
+int main(int argc, char *argv[]) {
+
+  struct arguments args;
+  argp_parse(&argp, argc, argv, 0, 0, &args);
+
+  cout << "#############################################" << endl;
+  cout << "> Region_Cuts_Test" << endl;
+  cout << "> TREENAME     : " << args.tree << endl;
+  cout << "> REFERENCE    : "
+       << "*" << args.reference_pattern << "*" << args.suffix << "*" << endl;
+  cout << "> TEST         : "
+       << "*" << args.test_pattern << "*" << args.suffix << "*" << endl;
+  cout << "> OUTPUTFILE   : " << args.outputfilename << endl;
+  cout << "> BINNING      : " << args.binning * 1000. << " keV" << endl;
+  cout << "> EMAX         : " << args.emax << " MeV" << endl;
+  cout << "> MAXID        : " << args.maxid << endl;
+  cout << "> ALPHA        : " << args.alpha << endl;
+  cout << "#############################################" << endl;
+
+  TChain reference(args.tree);
+  join_files(reference, args.reference_pattern, args.suffix);
+  TChain test(args.tree);
+  join_files(test, args.test_pattern, args.suffix);
+
+  vector<TH1D *> reference_hist = fill_histograms(reference, "reference", args);
+  vector<TH1D *> test_hist = fill_histograms(test, "regions", args);
+
+  // The two simulations are compared for each detector:
+  //   - The difference of the total number of counts in units of its statistical uncertainty
+  //   - A chi^2 test of the two spectra, which is sensitive to differences in single bins, i.e. peaks
+  //   - A Kolmogorov-Smirnov test, which is sensitive to differences of the shape, e.g. the low-energy part of the spectra
+  // Both simulations must have been run with the same number of primary particles.
+  cout << setw(6) << "ID" << setw(14) << "N(reference)" << setw(14) << "N(regions)" << setw(14) << "diff/sigma" << setw(14) << "p(chi2)" << setw(14) << "p(KS)" << setw(10) << "result" << endl;
+
+  bool all_compatible = true;
+  for (unsigned int i = 0; i <= args.maxid; ++i) {
+    const double n_reference = reference_hist[i]->GetEntries();
+    const double n_test = test_hist[i]->GetEntries();
+    if (n_reference == 0. && n_test == 0.) {
+      continue;
+    }
+
+    const double significance = (n_test - n_reference) / sqrt(n_test + n_reference);
+    double p_chi2 = 0., p_ks = 0.;
+    if (n_reference > 0. && n_test > 0.) {
+      p_chi2 = reference_hist[i]->Chi2Test(test_hist[i], "UU");
+      p_ks = reference_hist[i]->KolmogorovTest(test_hist[i]);
+    }
+    const bool compatible = p_chi2 >= args.alpha && p_ks >= args.alpha;
+    all_compatible = all_compatible && compatible;
+
+    cout << setw(6) << i << setw(14) << n_reference << setw(14) << n_test << setw(14) << setprecision(3) << significance << setw(14) << p_chi2 << setw(14) << p_ks << setw(10) << (compatible ? "OK" : "DIFFERENT") << endl;
+  }
+
+  TFile outputfile(args.outputfilename, "RECREATE");
+  for (unsigned int i = 0; i <= args.maxid; ++i) {
+    reference_hist[i]->Write();
+    test_hist[i]->Write();
+  }
+  outputfile.Close();
+
+  if (all_compatible) {
+    cout << "> The spectra of all detectors are compatible at the significance level " << args.alpha << "." << endl;
+    return 0;
+  }
+  cout << "> The spectra of some detectors differ at the significance level " << args.alpha << "." << endl;
+  return 1;
+}